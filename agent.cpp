@@ -1,16 +1,158 @@
 #include "common/tcp_connection.h"
 #include "common/rpc_protocol.h"
+#include "common/binary_codec.h"
+#include "common/coroutine_loop.h"
 #include <iostream>
 #include "logic/logic.h"
 #include <string>
 #include "common/game_state.h"
-#include <fstream>
+#include "common/turn_arena.h"
+#include "common/thread_pool.h"
+#include "common/metrics_exporter.h"
+#include <algorithm>
+#include <optional>
 using namespace std ;
+
+// One coordinator connection. Every handler is a coroutine on the loop
+// thread; only processTurn runs on the decider, so receive_intel and
+// notify_death are acked while a turn is still being decided.
+struct AgentSession {
+    net::CoroutineLoop& loop;
+    net::AsyncConnection& link;
+    string agent_id;
+    string encoding;
+    agent::SimpleAgent my_agent;
+    game::GameState game_state;  // With binary_delta each turn is applied on top of the previous one
+    bool has_game_state = false;
+    game::TurnArena turn_arena;              // JSON turns are full snapshots: each one lives here until the next
+    optional<game::GameState> json_state;
+    bool deciding = false;       // The decider is reading the state above
+    bool registered = false;
+    bool game_over_received = false;
+    concurrency::ThreadPool decider{1}; // Last: joined before the state it reads goes away
+
+    AgentSession(net::CoroutineLoop& loop, net::AsyncConnection& link, string agent_id, string encoding)
+        : loop(loop), link(link), agent_id(move(agent_id)), encoding(move(encoding)) {}
+
+    net::Task<> serve();
+    net::Task<> handle(string_view frame);
+    net::Task<> playTurn(string_view frame);
+};
+
+net::Task<> AgentSession::serve() {
+    co_await link.sendFrame([&](string& out) { rpc::appendRegisterMessage(out, "1", agent_id, encoding); });
+    while (optional<string_view> frame = co_await link.receiveFrame()) {
+        loop.spawn(handle(*frame)); // Reads the frame before the next one is received
+    }
+    if (!game_over_received) {
+        cout << (registered ? "Connection lost. Exiting..." : "Registration failed: connection closed") << endl;
+    }
+    loop.stop();
+}
+
+net::Task<> AgentSession::handle(string_view frame) {
+    if (rpc::isBinaryFrame(frame)) { // Only play_turn has a binary form
+        co_await playTurn(frame);
+        co_return;
+    }
+    string type = rpc :: extractStringValue (frame, "type");
+    if (type.empty()) { // A response: only register_agent's ack is ever expected
+        registered = true;
+        co_return;
+    }
+    if (type == "play_turn") {
+        co_await playTurn(frame);
+        co_return;
+    }
+
+    // receive_intel, notify_death and notify_game_over only need the ack
+    string id = rpc :: extractStringValue (frame, "id");
+    if (type == "notify_game_over") {
+        cout << "Game Over received. Exiting..." << endl;
+        game_over_received = true;
+    }
+    co_await link.sendFrame([&](string& out) { rpc::appendVoidResponse(out, id); });
+    if (type == "notify_game_over") loop.stop();
+}
+
+net::Task<> AgentSession::playTurn(string_view frame) {
+    bool binary = rpc::isBinaryFrame(frame);
+    bool delta = rpc::isDeltaFrame(frame);
+    string id = binary ? "" : rpc :: extractStringValue (frame, "id");
+
+    if (deciding) {
+        // The coordinator stopped waiting for the previous turn. Skip this one
+        // rather than overwrite the state the decider is still reading.
+        string turn_agent_id;
+        if (binary) rpc::decodePlayTurnHeader(frame, id, turn_agent_id);
+        if (delta) has_game_state = false; // This delta is lost: ask for a snapshot
+        co_await link.sendFrame([&](string& out) { rpc::appendTurnResponse(out, id, "", delta); });
+        co_return;
+    }
+
+    bool decoded = false;
+    try {
+        if (delta) {
+            string turn_agent_id;
+            rpc::decodePlayTurnHeader(frame, id, turn_agent_id); // The resync answer needs the id too
+            has_game_state = has_game_state && rpc::decodePlayTurnDelta(frame, id, turn_agent_id, game_state);
+        } else if (binary) {
+            string turn_agent_id;
+            has_game_state = rpc::decodePlayTurn(frame, id, turn_agent_id, game_state);
+            if (!has_game_state) {
+                throw runtime_error("malformed binary play_turn");
+            }
+        } else {
+            json_state.reset(); // Its memory is handed out again below
+            turn_arena.reset();
+            rpc::deserializeGameState(frame, json_state.emplace(turn_arena.resource()));
+        }
+        decoded = !delta || has_game_state;
+    } catch (const exception& e) {
+        cout << "Error deserializing game state: " << e.what() << endl;
+    }
+    if (delta && !has_game_state) {
+        // Missed a turn or diverged: no action this turn, ask for a snapshot
+        co_await link.sendFrame([&](string& out) { rpc::appendTurnResponse(out, id, "", true); });
+        co_return;
+    }
+
+    agent :: SimpleAction redditben10;
+    if (decoded) {
+        const game::GameState& turn_state = json_state ? *json_state : game_state;
+        if (turn_state.current_turn == 1) {
+            string team_name = "default_team";
+            for (auto& agents : turn_state.agents) {
+                if (agents.id == string_view(agent_id)) {
+                    team_name = agents.team;
+                    break;
+                }
+            }
+            my_agent.initialize(agent_id, team_name);
+        }
+        deciding = true;
+        try {
+            redditben10 = co_await loop.offload(decider, [&] { return my_agent.processTurn(turn_state); });
+        } catch (const exception& e) {
+            cout << "Error processing turn: " << e.what() << endl;
+        }
+        deciding = false;
+    }
+
+    if (redditben10.type == agent::SimpleActionType::send_message) {
+        string action = "send_message:" + redditben10.message;
+        co_await link.sendFrame([&](string& out) { rpc::appendTurnResponse(out, id, action); });
+    }
+    else {
+        string_view action = agent::actionName(redditben10); // Constant per type x direction
+        co_await link.sendFrame([&](string& out) { rpc::appendTurnResponse(out, id, action); });
+    }
+}
+
 int main(int argc, char* argv[]) {
     string host = "127.0.0.1";
     int port = 8080;
     string agent_id = "backup_agent_id";
-    string call_id ="1";
     if (argc > 1) {
         host = argv[1];
     }
@@ -19,76 +161,44 @@ int main(int argc, char* argv[]) {
     }
     if (argc > 3) {
         agent_id = argv[3];
-    }  
-    
+    }
+    string encoding = rpc::ENCODING_JSON; // "binary" or "binary_delta" ask for the compact play_turn frames
+    if (argc > 4) {
+        encoding = argv[4];
+    }
+    int search_ms = 0; // Per-turn lookahead budget; 0 keeps the plain heuristic
+    if (argc > 5) {
+        search_ms = stoi(argv[5]);
+    }
+    int rollouts = 0; // Random playouts per action when an enemy is close; 0 keeps the heuristic
+    if (argc > 6) {
+        rollouts = stoi(argv[6]);
+    }
+
+
+
+    metrics::Exporter exporter; // TP4_METRICS_PORT / TP4_METRICS_FILE
+    exporter.configureFromEnvironment();
 
-    
     // Create and connect the TCP client
     net::TcpConnection connection;
     connection.connect(host, port);
+    connection.setNoDelay(true); // Turn replies are small and latency bound
     cout << "Client running..." << (connection.isConnected())<< endl;
 
-    // Register the agent
-    string registermessage =  "{"
-        "\"id\":\"" + call_id + "\","
-        "\"type\":\"register_agent\","
-        "\"agent_id\":\"" + agent_id + "\""
-        "}";
-    connection.sendMessage(registermessage);
-    agent::SimpleAgent my_agent;
-
-    // Main loop to handle server messages
-    while (true)
-    {
-        string response = connection.receiveMessage();
-        string id = rpc :: extractStringValue (response, "id");
-        string type = rpc :: extractStringValue (response, "type");
-
-        if (rpc::extractStringValue(response, "type") == "recieve_intel") {
-            connection.sendMessage(rpc::void_response(id));    
-        }
-        else if (rpc::extractStringValue(response, "type") == "play_turn"){ 
-            game::GameState game_state;
-            agent :: SimpleAction redditben10; 
-            try {
-                game_state = rpc ::deserializeGameState(response); 
-                int turn = game_state.current_turn;
-                if (turn == 1) {
-                    string team_name = "default_team";
-                    for (auto& agents : game_state.agents) {
-                        if (agents.id == agent_id) {
-                            team_name = agents.team;
-                            break;
-                        }
-                    }
-                    my_agent.initialize(agent_id, team_name);
-                }
-                redditben10 = my_agent.processTurn(game_state);
-
-            } catch (const exception& e) {
-                cout << "Error deserializing game state: " << e.what() << endl;
-            }
-            if (redditben10.type == agent::SimpleActionType::move) {
-                string direction_str = game::getStringFromDirection(redditben10.direction);
-                ofstream meteorologicLog("/meteorologic.txt"); 
-
-                connection.sendMessage(rpc::turn_response(id, "move_" + direction_str));
-            }
-            else if (redditben10.type == agent::SimpleActionType::attack) {
-                string direction_str = game::getStringFromDirection(redditben10.direction);
-                connection.sendMessage(rpc::turn_response(id, "attack_" + direction_str));
-            }
-            else if (redditben10.type == agent::SimpleActionType::defend) {
-                string direction_str = game::getStringFromDirection(redditben10.direction);
-                connection.sendMessage(rpc::turn_response(id, "defend_" + direction_str));
-            }
-            else if (redditben10.type == agent::SimpleActionType::send_message) {
-                connection.sendMessage(rpc::turn_response(id, "send_message:" + redditben10.message));
-            }    
-        }
-        else if (rpc::extractStringValue(response, "type") == "notify_game_over") {
-            cout << "Game Over received. Exiting..." << endl;
-            break;
-        }
+    net::CoroutineLoop loop;
+    if (!loop.init()) {
+        return 1;
     }
-}
\ No newline at end of file
+    net::AsyncConnection link(loop, connection);
+    // The decider thread works in the rollouts too, so one worker less than the cores
+    concurrency::ThreadPool rollout_pool(rollouts > 0 ? max(1u, thread::hardware_concurrency()) - 1 : 0);
+    AgentSession session(loop, link, agent_id, encoding);
+    session.my_agent.setSearchBudget(chrono::milliseconds(search_ms));
+    session.my_agent.setRolloutBudget(rollouts, rollout_pool);
+
+    // Everything happens on this thread until the game ends or the connection drops
+    loop.spawn(session.serve());
+    loop.run();
+    return session.registered ? 0 : 1;
+}
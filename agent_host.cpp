@@ -0,0 +1,329 @@
+// agent_host.cpp
+// Runs many SimpleAgents in one process. Their play_turn requests arrive over a few
+// shared connections; each turn's state is decoded once through a GameStateCache,
+// indexed once, and every agent decides on a work-stealing thread pool.
+#include "common/binary_codec.h"
+#include "common/game_state_cache.h"
+#include "common/metrics_exporter.h"
+#include "common/rpc_protocol.h"
+#include "common/spatial_grid.h"
+#include "common/tcp_connection.h"
+#include "common/thread_pool.h"
+#include "logic/logic.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// How long a batch waits for the rest of a turn's requests once one arrived
+constexpr auto BATCH_WINDOW = std::chrono::microseconds(500);
+
+struct Link {
+    net::TcpConnection connection;
+    std::unique_ptr<rpc::Client> client;
+    bool game_over = false;
+};
+
+struct HostedAgent {
+    std::string id;
+    agent::SimpleAgent brain;
+    bool initialized = false;
+    bool queued = false; // Already has a job in the batch being built
+};
+
+// A play_turn already decoded, waiting for its agent to decide
+struct TurnRequest {
+    rpc::Client* client;
+    std::string id;
+    std::string agent_id;
+    game::GameStateCache::StatePtr state;
+};
+
+// Decodes a play_turn frame through the shared cache; nullptr when a delta
+// does not apply (no base turn cached, or it diverged)
+game::GameStateCache::StatePtr decodeTurn(game::GameStateCache& cache, std::string_view frame, std::string& id,
+                                          std::string& agent_id) {
+    if (!rpc::isBinaryFrame(frame)) {
+        id = rpc::extractStringValue(frame, "id");
+        agent_id = rpc::extractStringValue(frame, "agent_id");
+        return cache.get(rpc::extractIntValue(frame, "current_turn"), [frame] {
+            return std::make_shared<const game::GameState>(rpc::deserializeGameState(frame));
+        });
+    }
+
+    int turn = 0;
+    int base_turn = -1;
+    if (!rpc::peekPlayTurn(frame, id, agent_id, turn, &base_turn)) throw std::runtime_error("bad binary header");
+    return cache.get(turn, [&cache, frame, base_turn]() -> game::GameStateCache::StatePtr {
+        auto state = std::make_shared<game::GameState>();
+        std::string ignored_id;
+        std::string ignored_agent;
+        if (base_turn < 0) {
+            if (!rpc::decodePlayTurn(frame, ignored_id, ignored_agent, *state)) return nullptr;
+            return state;
+        }
+        game::GameStateCache::StatePtr base = cache.find(base_turn);
+        if (!base) return nullptr;
+        *state = *base; // Cached states are immutable: the delta goes on a copy
+        if (!rpc::decodePlayTurnDelta(frame, ignored_id, ignored_agent, *state)) return nullptr;
+        return state;
+    });
+}
+
+// play_turn requests from every reader thread, handed to the main thread in batches
+class Inbox {
+private:
+    std::mutex mutex;
+    std::condition_variable arrived;
+    std::vector<TurnRequest> requests;
+
+public:
+    void push(TurnRequest request) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requests.push_back(std::move(request));
+        }
+        arrived.notify_one();
+    }
+
+    // Waits up to timeout for a first request, then keeps collecting while
+    // more keep arriving (the coordinator sends a whole turn in one burst) or
+    // until expected requests are in
+    std::vector<TurnRequest> takeBatch(std::chrono::milliseconds timeout, size_t expected) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!arrived.wait_for(lock, timeout, [this] { return !requests.empty(); })) return {};
+        while (requests.size() < expected) {
+            size_t seen = requests.size();
+            if (!arrived.wait_for(lock, BATCH_WINDOW, [&] { return requests.size() != seen; })) break;
+        }
+        std::vector<TurnRequest> batch;
+        batch.swap(requests);
+        return batch;
+    }
+};
+
+// Runs the decisions of a batch, one shared state, grid and path cache per turn
+class TurnRunner {
+private:
+    concurrency::ThreadPool& pool;
+    std::unordered_map<std::string, HostedAgent*> agents;
+    std::shared_ptr<agent::PathCache> path_cache;
+    std::shared_ptr<agent::InfluenceMap> influence;
+    game::SpatialGrid grid;
+
+    struct Job {
+        rpc::Client* client;
+        std::string id;
+        HostedAgent* agent;
+    };
+    game::GameStateCache::StatePtr state; // State of the jobs below
+    std::vector<Job> jobs;
+
+public:
+    size_t decisions = 0;
+    size_t batches = 0;
+
+    TurnRunner(concurrency::ThreadPool& pool, std::vector<HostedAgent>& hosted)
+        : pool(pool), path_cache(std::make_shared<agent::PathCache>()),
+          influence(std::make_shared<agent::InfluenceMap>()) {
+        for (HostedAgent& hosted_agent : hosted) {
+            agents[hosted_agent.id] = &hosted_agent;
+            hosted_agent.brain.setPathCache(path_cache); // One cache for the whole host
+            hosted_agent.brain.setInfluenceMap(influence);
+        }
+    }
+
+    void run(std::vector<TurnRequest>& batch) {
+        batches++;
+        for (TurnRequest& request : batch) {
+            auto found = agents.find(request.agent_id);
+            if (found == agents.end()) {
+                std::cerr << "play_turn for unknown agent " << request.agent_id << std::endl;
+                continue;
+            }
+            HostedAgent* hosted_agent = found->second;
+            // A new turn (or the same agent twice) closes the jobs of the current state
+            if (request.state != state || hosted_agent->queued) {
+                flush();
+                state = request.state;
+            }
+            hosted_agent->queued = true;
+            jobs.push_back({request.client, request.id, hosted_agent});
+        }
+        flush();
+    }
+
+private:
+    void flush() {
+        if (jobs.empty()) return;
+        // Shared, per-turn structures are built before the fan-out; the
+        // decisions only read them
+        path_cache->prepareTurn(*state);
+        influence->update(*state);
+        grid.build(*state);
+        for (Job& job : jobs) {
+            if (job.agent->initialized) continue;
+            std::string team = "default_team";
+            for (const game::Agent& agent : state->agents) {
+                if (agent.id == std::string_view(job.agent->id)) {
+                    team = agent.team;
+                    break;
+                }
+            }
+            job.agent->brain.initialize(job.agent->id, team);
+            job.agent->initialized = true;
+        }
+
+        pool.parallelFor(jobs.size(), [this](size_t i) {
+            Job& job = jobs[i];
+            agent::SimpleAction action = job.agent->brain.processTurn(*state, grid);
+            if (action.type == agent::SimpleActionType::send_message) {
+                job.client->send(rpc::turn_response(job.id, agent::actionToString(action)));
+            } else {
+                std::string_view name = agent::actionName(action);
+                job.client->sendFrame([&](std::string& out) { rpc::appendTurnResponse(out, job.id, name); });
+            }
+        });
+        decisions += jobs.size();
+        for (Job& job : jobs) job.agent->queued = false;
+        jobs.clear();
+        state.reset();
+    }
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Usage: ./agent_host [host] [port] [id_prefix] [agents] [connections] [encoding] [threads]
+    std::string host = "127.0.0.1";
+    int port = 8080;
+    std::string prefix = "host_agent";
+    size_t agent_count = 4;
+    size_t connection_count = 1;
+    std::string encoding = rpc::ENCODING_BINARY_DELTA;
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) host = argv[1];
+    if (argc > 2) port = std::stoi(argv[2]);
+    if (argc > 3) prefix = argv[3];
+    if (argc > 4) agent_count = std::stoul(argv[4]);
+    if (argc > 5) connection_count = std::max<size_t>(1, std::stoul(argv[5]));
+    if (argc > 6) encoding = argv[6];
+    if (argc > 7) threads = std::max<size_t>(1, std::stoul(argv[7]));
+    connection_count = std::min(connection_count, std::max<size_t>(1, agent_count));
+
+    metrics::Exporter exporter; // TP4_METRICS_PORT / TP4_METRICS_FILE
+    exporter.configureFromEnvironment();
+
+    std::vector<HostedAgent> hosted(agent_count);
+    for (size_t i = 0; i < agent_count; ++i) hosted[i].id = prefix + "_" + std::to_string(i);
+
+    Inbox inbox;
+    game::GameStateCache cache;
+    std::mutex game_over_mutex;
+    std::vector<std::unique_ptr<Link>> links;
+    for (size_t c = 0; c < connection_count; ++c) {
+        auto link = std::make_unique<Link>();
+        if (!link->connection.connect(host, port)) {
+            std::cerr << "Could not connect to " << host << ":" << port << std::endl;
+            return 1;
+        }
+        link->connection.setNoDelay(true);
+        link->client = std::make_unique<rpc::Client>(link->connection);
+        Link* self = link.get();
+        // Reader threads decode as frames arrive: the first one of a turn
+        // decodes it, the others wait for it or reuse it
+        link->client->onRequest([self, &inbox, &cache, &game_over_mutex](std::string_view frame) {
+            std::string type = rpc::isBinaryFrame(frame) ? "play_turn" : rpc::extractStringValue(frame, "type");
+            if (type == "play_turn") {
+                TurnRequest request{self->client.get(), "", "", nullptr};
+                try {
+                    request.state = decodeTurn(cache, frame, request.id, request.agent_id);
+                } catch (const std::exception& e) {
+                    std::cerr << "Dropping malformed play_turn: " << e.what() << std::endl;
+                    return;
+                }
+                if (!request.state) {
+                    // Missed a turn or diverged: no action, ask for a snapshot
+                    self->client->send(rpc::turn_response(request.id, "", true));
+                    return;
+                }
+                inbox.push(std::move(request));
+                return;
+            }
+            // receive_intel, notify_death and notify_game_over only need the ack
+            std::string id = rpc::extractStringValue(frame, "id");
+            self->client->sendFrame([&](std::string& out) { rpc::appendVoidResponse(out, id); });
+            if (type == "notify_game_over") {
+                cache.reset(); // Turn numbers start over with the next match
+                std::lock_guard<std::mutex> lock(game_over_mutex);
+                self->game_over = true;
+            }
+        });
+        link->client->start();
+        links.push_back(std::move(link));
+    }
+
+    // Agents are spread round robin over the connections
+    std::vector<std::future<std::string>> registrations;
+    for (size_t i = 0; i < agent_count; ++i) {
+        rpc::Client& client = *links[i % connection_count]->client;
+        registrations.push_back(client.call("register_agent", "\"agent_id\":\"" + rpc::escapeJson(hosted[i].id) +
+                                                                  "\",\"encoding\":\"" + rpc::escapeJson(encoding) +
+                                                                  "\""));
+    }
+    try {
+        for (auto& registration : registrations) registration.get();
+    } catch (const std::exception& e) {
+        std::cerr << "Registration failed: " << e.what() << std::endl;
+        return 1;
+    }
+    std::cout << "Hosting " << agent_count << " agents over " << connection_count << " connections with "
+              << threads << " threads" << std::endl;
+
+    // The main thread is one of the deciding threads
+    concurrency::ThreadPool pool(threads - 1);
+    TurnRunner runner(pool, hosted);
+    auto start = Clock::now();
+    while (true) {
+        std::vector<TurnRequest> batch = inbox.takeBatch(std::chrono::milliseconds(100), agent_count);
+        if (!batch.empty()) {
+            runner.run(batch);
+            continue;
+        }
+        bool finished = true;
+        bool connected = false;
+        {
+            std::lock_guard<std::mutex> lock(game_over_mutex);
+            for (const auto& link : links) {
+                finished = finished && link->game_over;
+                connected = connected || (link->client->isRunning() && link->connection.isConnected());
+            }
+        }
+        if (finished) {
+            std::cout << "Game over received. Exiting..." << std::endl;
+            break;
+        }
+        if (!connected) {
+            std::cout << "Connection lost. Exiting..." << std::endl;
+            break;
+        }
+    }
+    for (auto& link : links) link->client->stop();
+
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    game::GameStateCache::Stats stats = cache.stats();
+    std::cout << runner.decisions << " decisions in " << runner.batches << " batches, " << seconds << " s" << std::endl;
+    std::cout << "State cache: " << stats.misses << " decodes, " << stats.hits << " hits (" << stats.waits
+              << " waited), hit rate " << stats.hitRate() * 100 << "%, " << stats.failures << " failures, "
+              << stats.parse_ms << " ms decoding, " << stats.saved_ms << " ms saved" << std::endl;
+    return 0;
+}
@@ -0,0 +1,132 @@
+// bench/arena_bench.cpp
+// Heap allocations per turn of an agent that decodes the JSON play_turn and
+// decides, with the state on the heap against a reused TurnArena. Exits with
+// 1 when the arena path still allocates on the heap in steady state.
+#include "bench/bench_util.h"
+#include "common/game_rules.h"
+#include "common/rpc_protocol.h"
+#include "common/spatial_grid.h"
+#include "common/turn_arena.h"
+#include "logic/logic.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <optional>
+
+namespace {
+
+std::atomic<uint64_t> heap_allocations{0};
+std::atomic<uint64_t> heap_bytes{0};
+
+constexpr int WARMUP_TURNS = 5; // Buffers and the arena reach their size
+constexpr int TURNS = 40;
+
+struct Usage {
+    double allocations = 0; // Per turn
+    double bytes = 0;
+    double us = 0;
+};
+
+// Turns of a real match, as the coordinator would serialize them
+std::vector<std::string> makeTurns(int agents, int map) {
+    game::GameState state = bench::makeGameState(agents, map, 11);
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int> type(0, 3);
+    std::uniform_int_distribution<int> direction(0, 3);
+    std::vector<std::string> turns;
+    for (int t = 0; t < WARMUP_TURNS + TURNS; ++t) {
+        state.current_turn++;
+        turns.push_back(rpc::play_turn_request("1", state.agents.back().id.c_str(), rpc::serializeGameState(state)));
+        std::vector<game::Action> actions;
+        for (size_t i = 0; i < state.agents.size(); ++i) {
+            actions.emplace_back(static_cast<game::ActionType>(type(rng)), static_cast<game::Direction>(direction(rng)));
+        }
+        game::resolveTurn(state, actions);
+    }
+    return turns;
+}
+
+// decode(frame) returns the turn's state; the agent plays the last agent
+template <typename Decode>
+Usage measure(const std::vector<std::string>& turns, Decode&& decode) {
+    agent::SimpleAgent brain;
+    game::SpatialGrid grid;
+    Usage usage;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < turns.size(); ++t) {
+        if (t == WARMUP_TURNS) {
+            allocations = heap_allocations.load();
+            bytes = heap_bytes.load();
+            start = std::chrono::steady_clock::now();
+        }
+        const game::GameState& state = decode(turns[t]);
+        if (t == 0) brain.initialize(state.agents.back().id, state.agents.back().team);
+        grid.build(state);
+        bench::doNotOptimize(brain.processTurn(state, grid));
+    }
+    usage.us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / TURNS;
+    usage.allocations = static_cast<double>(heap_allocations.load() - allocations) / TURNS;
+    usage.bytes = static_cast<double>(heap_bytes.load() - bytes) / TURNS;
+    return usage;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// std::pmr::new_delete_resource goes through the aligned forms
+void* operator new(size_t size, std::align_val_t alignment) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    heap_bytes.fetch_add(size, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+int main() {
+    bench::printHeader("Heap allocations per turn: decode play_turn + decide, heap state vs TurnArena");
+    std::printf("%8s %12s %14s %12s %14s %14s %12s\n", "agents", "heap allocs", "heap bytes", "heap us",
+                "arena allocs", "arena bytes", "arena us");
+
+    bool steady = true;
+    for (int agents : {100, 1000, 10000}) {
+        std::vector<std::string> turns = makeTurns(agents, 200);
+
+        game::GameState heap_state;
+        Usage heap = measure(turns, [&](const std::string& frame) -> const game::GameState& {
+            heap_state = rpc::deserializeGameState(frame);
+            return heap_state;
+        });
+
+        game::TurnArena arena;
+        std::optional<game::GameState> arena_state;
+        Usage pooled = measure(turns, [&](const std::string& frame) -> const game::GameState& {
+            arena_state.reset();
+            arena.reset();
+            rpc::deserializeGameState(frame, arena_state.emplace(arena.resource()));
+            return *arena_state;
+        });
+
+        std::printf("%8d %12.1f %14.0f %12.1f %14.1f %14.0f %12.1f\n", agents, heap.allocations, heap.bytes, heap.us,
+                    pooled.allocations, pooled.bytes, pooled.us);
+        if (pooled.allocations >= 1.0) steady = false;
+    }
+
+    if (!steady) {
+        std::printf("TurnArena path still allocates on the heap every turn\n");
+        return 1;
+    }
+    return 0;
+}
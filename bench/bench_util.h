@@ -0,0 +1,68 @@
+// bench/bench_util.h
+// Small timing helpers shared by the microbenchmarks
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <random>
+#include "common/game_state.h"
+
+namespace bench {
+
+// Keeps the optimizer from discarding a computed value
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Runs fn repeatedly for at least min_ms milliseconds and returns the mean
+// time per call in nanoseconds
+template <typename Fn>
+double measureNs(Fn&& fn, double min_ms = 200.0) {
+    using clock = std::chrono::steady_clock;
+    fn(); // Warm-up
+    size_t iterations = 0;
+    auto start = clock::now();
+    double elapsed_ns = 0;
+    size_t batch = 1;
+    while (elapsed_ns < min_ms * 1e6) {
+        for (size_t i = 0; i < batch; ++i) fn();
+        iterations += batch;
+        elapsed_ns = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        batch *= 2;
+    }
+    return elapsed_ns / static_cast<double>(iterations);
+}
+
+// Builds a two-team match with agent_count agents spread over the map
+inline game::GameState makeGameState(int agent_count, int map_size, uint32_t seed = 42) {
+    game::GameState state;
+    state.config.map_width = map_size;
+    state.config.map_height = map_size;
+    state.current_turn = 42;
+
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> coord(0, map_size - 1);
+    std::uniform_int_distribution<int> hp(1, 100);
+    std::uniform_int_distribution<int> facing(0, 3);
+    for (int i = 0; i < agent_count; ++i) {
+        std::string team = (i % 2 == 0) ? "red" : "blue";
+        game::Agent agent(team + "_agent_" + std::to_string(i), team,
+                          game::Position(coord(rng), coord(rng)));
+        agent.hp = hp(rng);
+        agent.facing = static_cast<game::Direction>(facing(rng));
+        agent.is_alive = (i % 17) != 0;
+        state.agents.push_back(agent);
+    }
+    state.bases.emplace_back("red", game::Position(2, 2));
+    state.bases.emplace_back("blue", game::Position(map_size - 3, map_size - 3));
+    return state;
+}
+
+inline void printHeader(const char* title) {
+    std::printf("\n== %s ==\n", title);
+}
+
+} // namespace bench
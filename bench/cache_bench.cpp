@@ -0,0 +1,268 @@
+// bench/cache_bench.cpp
+// Decoded state cache shared by co-located agents: hit rate and decode time saved when every
+// agent asks for every turn, then the concurrent paths checked through the Stats counters: one
+// decode for many waiters, a failed decode taken over by a waiter, reset() during a decode and
+// eviction around a turn still loading. Exits with 1 when a counter, a returned state or the
+// exported metrics are not what the path implies.
+#include "bench/bench_util.h"
+#include "common/game_state_cache.h"
+#include "common/metrics.h"
+#include "common/rpc_protocol.h"
+#include <atomic>
+#include <barrier>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using StatePtr = game::GameStateCache::StatePtr;
+
+constexpr int AGENTS = 16; // Co-located agents asking for every turn
+constexpr int TURNS = 50;
+
+bool failed = false;
+
+void expect(bool ok, const char* what) {
+    if (ok) return;
+    std::printf("FAIL: %s\n", what);
+    failed = true;
+}
+
+// Every cache's counters, to compare with what was exported
+game::GameStateCache::Stats totals;
+
+void addTotals(const game::GameStateCache& cache) {
+    game::GameStateCache::Stats stats = cache.stats();
+    totals.hits += stats.hits;
+    totals.misses += stats.misses;
+    totals.failures += stats.failures;
+    totals.evictions += stats.evictions;
+}
+
+// A loader held inside load() until open() is called
+struct Gate {
+    std::promise<void> entered;
+    std::promise<void> opened;
+    std::shared_future<void> open_signal = opened.get_future().share();
+
+    void waitEntered() { entered.get_future().wait(); }
+    void open() { opened.set_value(); }
+    void hold() {
+        entered.set_value();
+        open_signal.wait();
+    }
+};
+
+// One caller of cache.get(turn) per entry of results, each on its own thread,
+// with a loader that counts its calls and returns state
+void askMany(game::GameStateCache& cache, int turn, const StatePtr& state, std::atomic<int>& loads,
+             std::vector<StatePtr>& results, std::vector<std::thread>& threads) {
+    for (StatePtr& result : results) {
+        threads.emplace_back([&cache, turn, state, &loads, &result] {
+            result = cache.get(turn, [&] {
+                loads++;
+                return state;
+            });
+        });
+    }
+}
+
+void joinAll(std::vector<std::thread>& threads) {
+    for (std::thread& thread : threads) thread.join();
+    threads.clear();
+}
+
+// Every agent decodes every turn through one cache, in lockstep like a host's batches
+void hitRate(const std::string& json) {
+    game::GameStateCache cache;
+    std::barrier turn_start(AGENTS);
+    std::vector<std::thread> threads;
+    for (int a = 0; a < AGENTS; ++a) {
+        threads.emplace_back([&] {
+            for (int turn = 1; turn <= TURNS; ++turn) {
+                turn_start.arrive_and_wait(); // Everybody finished the previous turn
+                bench::doNotOptimize(cache.get(turn, [&] {
+                    return std::make_shared<const game::GameState>(rpc::deserializeGameState(json));
+                }));
+            }
+        });
+    }
+    joinAll(threads);
+
+    game::GameStateCache::Stats stats = cache.stats();
+    bench::printHeader("Decoded state cache, 16 agents asking for each of 50 turns of a 400-agent match");
+    std::printf("hits %llu, misses %llu, waits %llu, evictions %llu, hit rate %.1f%%\n",
+                static_cast<unsigned long long>(stats.hits), static_cast<unsigned long long>(stats.misses),
+                static_cast<unsigned long long>(stats.waits), static_cast<unsigned long long>(stats.evictions),
+                100 * stats.hitRate());
+    std::printf("decoding %.1f ms, saved %.1f ms (%.1fx less decoding)\n", stats.parse_ms, stats.saved_ms,
+                (stats.parse_ms + stats.saved_ms) / stats.parse_ms);
+    expect(stats.misses == TURNS, "each turn is decoded once");
+    expect(stats.hits == static_cast<uint64_t>(TURNS) * (AGENTS - 1), "the other agents hit");
+    expect(stats.evictions == TURNS - 4, "only the newest 4 turns are kept");
+    expect(stats.failures == 0 && stats.saved_ms > 0, "hits count the decode time they saved");
+    addTotals(cache);
+}
+
+// Callers that arrive while a turn is loading wait for that decode instead of starting their own
+void waitersShareOneDecode(const StatePtr& state) {
+    game::GameStateCache cache;
+    Gate gate;
+    StatePtr first;
+    std::thread loader([&] {
+        first = cache.get(1, [&] {
+            gate.hold();
+            return state;
+        });
+    });
+    gate.waitEntered();
+    std::atomic<int> loads{0};
+    std::vector<std::thread> threads;
+    std::vector<StatePtr> results(AGENTS - 1);
+    askMany(cache, 1, std::make_shared<const game::GameState>(), loads, results, threads);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Most of them reach the wait; not checked
+    gate.open();
+    loader.join();
+    joinAll(threads);
+
+    game::GameStateCache::Stats stats = cache.stats();
+    bool same = first == state;
+    for (const StatePtr& result : results) same = same && result == state;
+    std::printf("%d callers during one decode: %llu waited, %d decoded again\n", AGENTS - 1,
+                static_cast<unsigned long long>(stats.waits), loads.load());
+    expect(same && loads == 0, "callers during a decode get that decode");
+    expect(stats.misses == 1 && stats.hits == AGENTS - 1 && stats.waits <= stats.hits, "one miss, the rest hits");
+    addTotals(cache);
+}
+
+// A loader that fails leaves the turn to the next caller; nothing is cached from it
+void failedDecodeIsTakenOver(const StatePtr& state, bool throws) {
+    game::GameStateCache cache;
+    Gate gate;
+    StatePtr first = state;
+    bool threw = false;
+    std::thread loader([&] {
+        try {
+            first = cache.get(1, [&]() -> StatePtr {
+                gate.hold();
+                if (throws) throw std::runtime_error("bad frame");
+                return nullptr;
+            });
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+    });
+    gate.waitEntered();
+    std::atomic<int> loads{0};
+    std::vector<std::thread> threads;
+    std::vector<StatePtr> results(AGENTS - 1);
+    askMany(cache, 1, state, loads, results, threads);
+    gate.open();
+    loader.join();
+    joinAll(threads);
+
+    game::GameStateCache::Stats stats = cache.stats();
+    bool same = true;
+    for (const StatePtr& result : results) same = same && result == state;
+    std::printf("loader %s: %d caller decoded instead, %llu failure\n", throws ? "throws" : "returns nullptr",
+                loads.load(), static_cast<unsigned long long>(stats.failures));
+    expect(throws ? threw : first == nullptr, "the failing caller sees its own failure");
+    expect(same && loads == 1, "exactly one waiter takes the decode over");
+    expect(stats.misses == 2 && stats.failures == 1 && stats.hits == AGENTS - 2, "two misses, one failure");
+    addTotals(cache);
+}
+
+// A decode that spans reset() belongs to the previous match: returned, never cached
+void resetDuringDecode(const StatePtr& state) {
+    game::GameStateCache cache;
+    Gate gate;
+    StatePtr old_match;
+    std::thread loader([&] {
+        old_match = cache.get(7, [&] {
+            gate.hold();
+            return state;
+        });
+    });
+    gate.waitEntered();
+    std::atomic<int> loads{0};
+    std::vector<std::thread> threads;
+    StatePtr new_state = std::make_shared<const game::GameState>();
+    std::vector<StatePtr> results(1);
+    askMany(cache, 7, new_state, loads, results, threads);
+    cache.reset();
+    gate.open();
+    loader.join();
+    joinAll(threads);
+
+    game::GameStateCache::Stats stats = cache.stats();
+    std::printf("reset during a decode: old decode %s, new match decoded %d time\n",
+                cache.find(7) == state ? "CACHED" : "dropped", loads.load());
+    expect(old_match == state, "the caller of a decode spanning reset() still gets it");
+    expect(results[0] == new_state && loads == 1 && cache.find(7) == new_state,
+           "turn 7 of the new match is its own decode");
+    expect(stats.misses == 2 && stats.hits == 0 && stats.failures == 0, "both decodes are misses");
+    addTotals(cache);
+}
+
+// Eviction drops the oldest finished turns and skips one still loading
+void evictionSkipsLoading(const StatePtr& state) {
+    game::GameStateCache cache(2);
+    Gate gate;
+    StatePtr first;
+    std::thread loader([&] {
+        first = cache.get(1, [&] {
+            gate.hold();
+            return state;
+        });
+    });
+    gate.waitEntered();
+    for (int turn = 2; turn <= 4; ++turn) {
+        cache.get(turn, [] { return std::make_shared<const game::GameState>(); });
+    }
+    std::atomic<int> loads{0};
+    std::vector<std::thread> threads;
+    std::vector<StatePtr> results(1);
+    askMany(cache, 1, std::make_shared<const game::GameState>(), loads, results, threads);
+    gate.open();
+    loader.join();
+    joinAll(threads);
+
+    game::GameStateCache::Stats stats = cache.stats();
+    std::printf("capacity 2, turn 1 loading while 2-4 load: %llu evicted, turn 1 %s\n",
+                static_cast<unsigned long long>(stats.evictions), cache.find(1) == state ? "kept" : "LOST");
+    expect(first == state && results[0] == state && loads == 0, "a waiter on the loading turn gets its decode");
+    expect(cache.find(1) == state && cache.find(4) != nullptr && cache.find(2) == nullptr && cache.find(3) == nullptr,
+           "the loading turn and the newest one are kept");
+    expect(stats.evictions == 2 && stats.misses == 4 && stats.hits == 1, "turns 2 and 3 are evicted");
+    addTotals(cache);
+}
+
+uint64_t exported(const char* name) {
+    return metrics::Registry::global().counter(name).value();
+}
+
+} // namespace
+
+int main() {
+    game::GameState match = bench::makeGameState(400, 40);
+    std::string json = rpc::serializeGameState(match);
+    StatePtr state = std::make_shared<const game::GameState>(match);
+
+    hitRate(json);
+    bench::printHeader("Concurrent paths");
+    waitersShareOneDecode(state);
+    failedDecodeIsTakenOver(state, true);
+    failedDecodeIsTakenOver(state, false);
+    resetDuringDecode(state);
+    evictionSkipsLoading(state);
+
+    expect(exported("game_state_cache_hits_total") == totals.hits &&
+           exported("game_state_cache_misses_total") == totals.misses &&
+           exported("game_state_cache_failures_total") == totals.failures &&
+           exported("game_state_cache_evictions_total") == totals.evictions,
+           "the exported counters add up every cache");
+    return failed ? 1 : 0;
+}
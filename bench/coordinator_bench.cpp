@@ -0,0 +1,97 @@
+// bench/coordinator_bench.cpp
+// Turn wall time of the GameCoordinator against agent count, with lightweight in-process agents
+#include "bench/bench_util.h"
+#include "common/event_loop.h"
+#include "common/rpc_protocol.h"
+#include "coordinator/coordinator.h"
+#include <sys/resource.h>
+#include <iostream>
+#include <thread>
+
+namespace {
+
+constexpr int PORT = 18481;
+
+// Answers every play_turn with a fixed action; silent agents never answer
+coordinator::MatchReport runMatch(size_t agent_count, size_t silent_agents, int turns,
+                                  std::chrono::milliseconds request_timeout) {
+    coordinator::CoordinatorConfig config;
+    config.port = PORT;
+    config.expected_agents = agent_count;
+    config.request_timeout = request_timeout;
+    config.game.max_turns = turns;
+    config.game.map_width = 200;
+    config.game.map_height = 200;
+    config.verbose = false;
+
+    coordinator::GameCoordinator game_coordinator(config);
+    game_coordinator.start();
+    coordinator::MatchReport report;
+    std::thread coordinator_thread([&] { report = game_coordinator.run(); });
+
+    net::EventLoop agents_loop;
+    agents_loop.init();
+    std::unordered_map<net::EventLoop::ConnectionId, bool> silent;
+    bool game_over = false;
+    agents_loop.onMessage([&](net::EventLoop::ConnectionId id, std::string_view frame) {
+        std::string type = rpc::extractStringValue(frame, "type");
+        std::string call_id = rpc::extractStringValue(frame, "id");
+        if (type == "play_turn") {
+            if (!silent[id]) agents_loop.send(id, rpc::turn_response(call_id, "defend_north"));
+        } else if (!type.empty()) {
+            agents_loop.send(id, rpc::void_response(call_id));
+            if (type == "notify_game_over") game_over = true;
+        }
+    });
+
+    for (size_t i = 0; i < agent_count; ++i) {
+        auto connection = std::make_unique<net::TcpConnection>();
+        connection->connect("127.0.0.1", PORT);
+        connection->setNoDelay(true);
+        net::EventLoop::ConnectionId id = agents_loop.addConnection(std::move(connection));
+        silent[id] = i < silent_agents;
+        agents_loop.send(id, rpc::register_message("1", "agent_" + std::to_string(i)));
+    }
+    while (!game_over) {
+        agents_loop.runOnce(50);
+    }
+    for (int i = 0; i < 5; ++i) agents_loop.runOnce(10); // Deliver the last acks
+    coordinator_thread.join();
+    return report;
+}
+
+void printRow(const char* label, size_t agents, const coordinator::MatchReport& report) {
+    std::vector<double> wall;
+    for (const auto& sample : report.turns) wall.push_back(sample.dispatch_ms + sample.resolve_ms);
+    std::sort(wall.begin(), wall.end());
+    double mean = 0;
+    for (double w : wall) mean += w;
+    mean /= wall.empty() ? 1 : wall.size();
+    std::printf("%-16s %8zu %8zu %12.2f %12.2f %12.2f\n", label, agents, report.turns.size(),
+                mean, wall.empty() ? 0.0 : wall[wall.size() / 2],
+                wall.empty() ? 0.0 : wall[wall.size() * 99 / 100]);
+}
+
+} // namespace
+
+int main() {
+    rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+
+    bench::printHeader("Coordinator turn wall time (dispatch + resolve) against agent count, 200x200 map");
+    std::printf("%-16s %8s %8s %12s %12s %12s\n", "scenario", "agents", "turns", "mean ms", "p50 ms", "p99 ms");
+    for (size_t agents : {10, 50, 100, 250, 500}) {
+        coordinator::MatchReport report = runMatch(agents, 0, 20, std::chrono::milliseconds(5000));
+        printRow("all responsive", agents, report);
+        // Intel is pipelined without waiting, so only the report shows whether it was acked
+        if (report.intel_sent == 0 || report.intel_acked != report.intel_sent) {
+            std::printf("FAIL: %zu of %zu receive_intel requests acked\n", report.intel_acked, report.intel_sent);
+            return 1;
+        }
+    }
+    // One silent agent: the turn waits for its own deadline only, the rest are read meanwhile
+    printRow("1 silent, 100ms", 100, runMatch(100, 1, 5, std::chrono::milliseconds(100)));
+    return 0;
+}
@@ -0,0 +1,196 @@
+// bench/coroutine_bench.cpp
+// Measures receive_intel ack latency while a long play_turn is being decided: inline handlers vs coroutines
+#include "bench/bench_util.h"
+#include "common/coroutine_loop.h"
+#include "common/rpc_protocol.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr int PORT = 18491;
+constexpr int TURNS = 20;
+constexpr int INTEL_PER_TURN = 8; // Spread over the decision
+constexpr auto DECISION = std::chrono::milliseconds(20);
+
+using clock_type = std::chrono::steady_clock;
+
+// Stands in for a slow processTurn
+void decide() {
+    auto end = clock_type::now() + DECISION;
+    while (clock_type::now() < end) {}
+}
+
+// Agent as it was: rpc::Client's reader thread runs every handler inline, so
+// an ack waits for the decision in front of it
+void inlineAgent() {
+    net::TcpConnection connection;
+    if (!connection.connect("127.0.0.1", PORT)) return;
+    connection.setNoDelay(true);
+    rpc::Client client(connection);
+    std::atomic<bool> game_over{false};
+    client.onRequest([&](std::string_view frame) {
+        std::string id = rpc::extractStringValue(frame, "id");
+        std::string type = rpc::extractStringValue(frame, "type");
+        if (type == "play_turn") {
+            decide();
+            client.sendFrame([&](std::string& out) { rpc::appendTurnResponse(out, id, "defend_north"); });
+            return;
+        }
+        client.sendFrame([&](std::string& out) { rpc::appendVoidResponse(out, id); });
+        if (type == "notify_game_over") game_over = true;
+    });
+    client.start();
+    while (!game_over && client.isRunning()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    client.stop();
+}
+
+// Agent as agent.cpp runs now: handlers are coroutines on one loop thread
+// and the decision is offloaded to a worker
+struct CoroutineAgent {
+    net::CoroutineLoop& loop;
+    net::AsyncConnection& link;
+    concurrency::ThreadPool decider{1};
+
+    net::Task<> serve() {
+        while (std::optional<std::string_view> frame = co_await link.receiveFrame()) {
+            loop.spawn(handle(*frame));
+        }
+        loop.stop();
+    }
+
+    net::Task<> handle(std::string_view frame) {
+        std::string id = rpc::extractStringValue(frame, "id");
+        std::string type = rpc::extractStringValue(frame, "type");
+        if (type == "play_turn") {
+            co_await loop.offload(decider, decide);
+            co_await link.sendFrame([&](std::string& out) { rpc::appendTurnResponse(out, id, "defend_north"); });
+            co_return;
+        }
+        co_await link.sendFrame([&](std::string& out) { rpc::appendVoidResponse(out, id); });
+        if (type == "notify_game_over") loop.stop();
+    }
+};
+
+void coroutineAgent() {
+    net::TcpConnection connection;
+    if (!connection.connect("127.0.0.1", PORT)) return;
+    connection.setNoDelay(true);
+    net::CoroutineLoop loop;
+    if (!loop.init()) return;
+    net::AsyncConnection link(loop, connection);
+    CoroutineAgent agent{loop, link};
+    loop.spawn(agent.serve());
+    loop.run();
+}
+
+struct Result {
+    double intel_p50_us;
+    double intel_p99_us;
+    double turn_p50_ms;
+    bool complete; // Every request got its response
+};
+
+double percentile(std::vector<double>& samples, double p) {
+    std::sort(samples.begin(), samples.end());
+    return samples[std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()))];
+}
+
+// Coordinator side: a play_turn, then intel frames while it is being decided;
+// a reader thread timestamps the responses by id
+Result run(void (*agent_main)()) {
+    net::TcpServer server(PORT);
+    server.setLogConnections(false);
+    server.setNoDelay(true);
+    server.start();
+    std::thread agent(agent_main);
+    std::unique_ptr<net::TcpConnection> connection = server.acceptConnection();
+
+    const int requests = TURNS * (1 + INTEL_PER_TURN) + 1;
+    std::vector<clock_type::time_point> sent(requests), answered(requests);
+    std::vector<bool> is_turn(requests, false);
+    std::atomic<int> received{0};
+    std::thread reader([&] {
+        while (received < requests) {
+            std::string_view frame = connection->receiveFrame();
+            if (!connection->isConnected()) break;
+            int id = std::stoi(rpc::extractStringValue(frame, "id"));
+            answered[id] = clock_type::now();
+            received++;
+        }
+    });
+
+    int id = 0;
+    auto request = [&](const std::string& message) {
+        sent[id] = clock_type::now();
+        connection->sendMessage(message);
+        ++id;
+    };
+    for (int turn = 0; turn < TURNS; ++turn) {
+        is_turn[id] = true;
+        request("{\"id\":\"" + std::to_string(id) + "\",\"type\":\"play_turn\"}");
+        for (int k = 0; k < INTEL_PER_TURN; ++k) {
+            std::this_thread::sleep_for(DECISION / (INTEL_PER_TURN + 1));
+            request(rpc::receive_intel_request(std::to_string(id), "ENEMY:10,5"));
+        }
+        while (received < id && connection->isConnected()) std::this_thread::yield(); // Turn answered
+    }
+    request("{\"id\":\"" + std::to_string(id) + "\",\"type\":\"notify_game_over\"}");
+    reader.join();
+    agent.join();
+    server.stop();
+
+    Result result{0, 0, 0, received == requests};
+    if (!result.complete) return result;
+    std::vector<double> intel_us, turn_ms;
+    for (int i = 0; i + 1 < requests; ++i) {
+        double us = std::chrono::duration<double, std::micro>(answered[i] - sent[i]).count();
+        if (is_turn[i]) turn_ms.push_back(us / 1000.0);
+        else intel_us.push_back(us);
+    }
+    result.intel_p50_us = percentile(intel_us, 0.50);
+    result.intel_p99_us = percentile(intel_us, 0.99);
+    result.turn_p50_ms = percentile(turn_ms, 0.50);
+    return result;
+}
+
+net::Task<int> leaf(int value) {
+    co_return value + 1;
+}
+
+net::Task<> parent(int& sink) {
+    sink += co_await leaf(sink);
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Task overhead (spawn + one nested co_await, no suspension)");
+    net::CoroutineLoop loop;
+    loop.init();
+    int sink = 0;
+    double task_ns = bench::measureNs([&] { loop.spawn(parent(sink)); });
+    bench::doNotOptimize(sink);
+    std::printf("%.1f ns per spawned task\n", task_ns);
+
+    bench::printHeader("receive_intel ack latency during a 20 ms play_turn decision");
+    std::printf("%-26s %12s %12s %14s\n", "agent", "ack p50 us", "ack p99 us", "turn p50 ms");
+    Result inline_result = run(inlineAgent);
+    Result coroutine_result = run(coroutineAgent);
+    std::printf("%-26s %12.1f %12.1f %14.2f\n", "inline on reader thread", inline_result.intel_p50_us,
+                inline_result.intel_p99_us, inline_result.turn_p50_ms);
+    std::printf("%-26s %12.1f %12.1f %14.2f\n", "coroutines + offload", coroutine_result.intel_p50_us,
+                coroutine_result.intel_p99_us, coroutine_result.turn_p50_ms);
+
+    if (!inline_result.complete || !coroutine_result.complete) {
+        std::printf("FAIL: responses missing\n");
+        return 1;
+    }
+    if (coroutine_result.intel_p50_us * 10 > inline_result.intel_p50_us) {
+        std::printf("FAIL: coroutine acks are not independent of the decision\n");
+        return 1;
+    }
+    std::printf("p50 ack latency %.0fx lower\n", inline_result.intel_p50_us / coroutine_result.intel_p50_us);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// bench/delta_bench.cpp
+// Per-turn bytes and encode/apply time of binary_delta against full binary snapshots,
+// over turns played with random actions so the change rate is that of a real match
+#include "bench/bench_util.h"
+#include "common/binary_codec.h"
+#include "common/game_rules.h"
+#include <cstdio>
+#include <random>
+
+namespace {
+
+std::vector<game::Action> randomActions(const game::GameState& state, std::mt19937& rng) {
+    std::uniform_int_distribution<int> kind(0, 9);
+    std::uniform_int_distribution<int> dir(0, 3);
+    std::vector<game::Action> actions;
+    actions.reserve(state.agents.size());
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        int k = kind(rng);
+        game::ActionType type = k < 6 ? game::ActionType::move
+                              : k < 8 ? game::ActionType::attack : game::ActionType::defend;
+        actions.emplace_back(type, static_cast<game::Direction>(dir(rng)));
+    }
+    return actions;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("play_turn state: binary snapshot vs binary_delta (200x200 map, 10 turns)");
+    std::printf("%8s %11s %9s %7s %11s %11s %11s %11s\n", "agents", "snapshot B", "delta B", "ratio",
+                "snap enc", "delta enc", "snap dec", "delta app");
+
+    for (int agents : {10, 100, 500, 1000, 5000, 10000}) {
+        game::GameState state = bench::makeGameState(agents, 200);
+        std::mt19937 rng(7);
+
+        double snapshot_bytes = 0, delta_bytes = 0;
+        double snapshot_encode = 0, delta_encode = 0, snapshot_decode = 0, delta_apply = 0;
+        const int turns = 10;
+        for (int turn = 0; turn < turns; ++turn) {
+            game::GameState previous = state;
+            game::resolveTurn(state, randomActions(state, rng));
+            state.current_turn++;
+
+            std::string snapshot;
+            rpc::encodeGameState(state, snapshot);
+            std::string delta;
+            rpc::encodeGameStateDelta(previous, state, delta);
+            snapshot_bytes += snapshot.size();
+            delta_bytes += delta.size();
+
+            // The receiver's cached state must end equal to the sender's
+            game::GameState cached = previous;
+            rpc::BinaryReader check(delta);
+            if (!rpc::applyGameStateDelta(check, cached) ||
+                rpc::checksumGameState(cached) != rpc::checksumGameState(state)) {
+                std::printf("delta did not reproduce the state for %d agents\n", agents);
+                return 1;
+            }
+
+            snapshot_encode += bench::measureNs([&] {
+                std::string out;
+                rpc::encodeGameState(state, out);
+                bench::doNotOptimize(out);
+            }, 20);
+            delta_encode += bench::measureNs([&] {
+                std::string out;
+                rpc::encodeGameStateDelta(previous, state, out);
+                bench::doNotOptimize(out);
+            }, 20);
+            snapshot_decode += bench::measureNs([&] {
+                game::GameState out;
+                rpc::BinaryReader in(snapshot);
+                rpc::decodeGameState(in, out);
+                bench::doNotOptimize(out);
+            }, 20);
+            // A delta applies in place, so it is timed against a rolled back copy
+            // whose cost is subtracted
+            game::GameState target = previous;
+            double copy = bench::measureNs([&] {
+                target = previous;
+                bench::doNotOptimize(target);
+            }, 20);
+            double copy_and_apply = bench::measureNs([&] {
+                target = previous;
+                rpc::BinaryReader in(delta);
+                rpc::applyGameStateDelta(in, target);
+                bench::doNotOptimize(target);
+            }, 20);
+            delta_apply += std::max(0.0, copy_and_apply - copy);
+        }
+
+        std::printf("%8d %11.0f %9.0f %6.1fx %9.1fus %9.1fus %9.1fus %9.1fus\n", agents,
+                    snapshot_bytes / turns, delta_bytes / turns, snapshot_bytes / delta_bytes,
+                    snapshot_encode / turns / 1e3, delta_encode / turns / 1e3,
+                    snapshot_decode / turns / 1e3, delta_apply / turns / 1e3);
+    }
+    return 0;
+}
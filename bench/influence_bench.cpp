@@ -0,0 +1,139 @@
+// bench/influence_bench.cpp
+// Shared influence map: flee scoring against every enemy vs one lookup per cell, and incremental vs full updates
+#include "bench/bench_util.h"
+#include "logic/influence_map.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr game::Direction DIRECTIONS[] = {
+    game::Direction::NORTH, game::Direction::SOUTH,
+    game::Direction::EAST, game::Direction::WEST
+};
+
+// What a fleeing agent did before: collect every living enemy, then sum the
+// distances to all of them for each of the four moves
+double scoreAgainstEveryEnemy(const game::GameState& state, const game::Agent& self,
+                              std::vector<game::Position>& enemies) {
+    enemies.clear();
+    for (const game::Agent& agent : state.agents) {
+        if (agent.is_alive && agent.team != self.team) enemies.push_back(agent.position);
+    }
+    double best = -1e9;
+    for (game::Direction dir : DIRECTIONS) {
+        game::Position offset = game::getDirectionOffset(dir);
+        game::Position next(self.position.x + offset.x, self.position.y + offset.y);
+        double score = 0;
+        for (const game::Position& enemy : enemies) {
+            double dx = next.x - enemy.x;
+            double dy = next.y - enemy.y;
+            score += std::sqrt(dx * dx + dy * dy) * 2;
+        }
+        best = std::max(best, score);
+    }
+    return best;
+}
+
+double scoreWithMap(const agent::InfluenceMap& map, const game::Agent& self) {
+    int team = map.team(self.team);
+    double best = -1e9;
+    for (game::Direction dir : DIRECTIONS) {
+        game::Position offset = game::getDirectionOffset(dir);
+        best = std::max(best, -static_cast<double>(map.threat(team, game::Position(self.position.x + offset.x,
+                                                                                  self.position.y + offset.y))));
+    }
+    return best;
+}
+
+// Moves count agents one cell along x (x ^ 1 stays inside an even-sized map) and starts a new turn
+void moveSome(game::GameState& state, size_t count, size_t& next) {
+    for (size_t k = 0; k < count; ++k) {
+        game::Agent& agent = state.agents[next++ % state.agents.size()];
+        agent.position.x ^= 1;
+    }
+    state.current_turn++;
+}
+
+bool sameMaps(const agent::InfluenceMap& a, const agent::InfluenceMap& b, const game::GameState& state) {
+    for (std::string_view team : {"red", "blue"}) {
+        for (int y = 0; y < state.config.map_height; ++y) {
+            for (int x = 0; x < state.config.map_width; ++x) {
+                game::Position pos(x, y);
+                if (a.support(a.team(team), pos) != b.support(b.team(team), pos) ||
+                    a.threat(a.team(team), pos) != b.threat(b.team(team), pos)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Flee scoring of one low-health agent (4 moves)");
+    std::printf("%8s %6s %20s %16s %18s\n", "agents", "map", "every enemy ns", "map lookup ns", "map update us");
+    for (auto [agents, map_size] : {std::pair{100, 20}, std::pair{400, 40}, std::pair{2000, 100}}) {
+        game::GameState state = bench::makeGameState(agents, map_size, 5);
+        std::vector<game::Position> enemies;
+        size_t next_agent = 0;
+        double loop_ns = bench::measureNs([&] {
+            const game::Agent& self = state.agents[next_agent++ % state.agents.size()];
+            bench::doNotOptimize(scoreAgainstEveryEnemy(state, self, enemies));
+        }, 100);
+
+        agent::InfluenceMap map;
+        map.update(state);
+        double lookup_ns = bench::measureNs([&] {
+            const game::Agent& self = state.agents[next_agent++ % state.agents.size()];
+            bench::doNotOptimize(scoreWithMap(map, self));
+        }, 100);
+        double build_ns = bench::measureNs([&] {
+            agent::InfluenceMap fresh;
+            fresh.update(state);
+            bench::doNotOptimize(fresh.changedSources());
+        }, 100);
+        std::printf("%8d %6d %20.1f %16.1f %18.1f\n", agents, map_size, loop_ns, lookup_ns, build_ns / 1e3);
+    }
+
+    bench::printHeader("Map update per turn, 2000 agents on a 100x100 map");
+    std::printf("%10s %12s %12s\n", "moved", "update us", "path");
+    game::GameState state = bench::makeGameState(2000, 100, 5);
+    for (double share : {0.01, 0.05, 0.25, 1.0}) {
+        size_t movers = static_cast<size_t>(share * state.agents.size());
+        agent::InfluenceMap map;
+        map.update(state);
+        size_t next = 0;
+        double update_ns = bench::measureNs([&] {
+            moveSome(state, movers, next);
+            map.update(state);
+        }, 200);
+        std::printf("%9.0f%% %12.1f %12s\n", share * 100, update_ns / 1e3, map.wasRebuilt() ? "rebuild" : "incremental");
+    }
+
+    // Many incremental turns, with deaths, must leave exactly what a fresh map computes
+    agent::InfluenceMap incremental;
+    incremental.update(state);
+    std::mt19937 rng(11);
+    size_t next = 0;
+    for (int turn = 0; turn < 200; ++turn) {
+        moveSome(state, 1 + rng() % 40, next);
+        if (turn % 10 == 0) state.agents[rng() % state.agents.size()].is_alive = false;
+        incremental.update(state);
+    }
+    agent::InfluenceMap fresh;
+    fresh.update(state);
+    if (!sameMaps(incremental, fresh, state)) {
+        std::printf("FAIL: the incremental map differs from a full rebuild\n");
+        return 1;
+    }
+    std::printf("200 incremental turns match a full rebuild\n");
+    return 0;
+}
@@ -0,0 +1,91 @@
+// bench/metrics_bench.cpp
+// Cost of recording into the metrics registry from 1 to 8 threads, and the
+// histogram's percentiles against the exact ones. Exits with 1 when a
+// percentile is off by more than the bucket resolution.
+#include "bench/bench_util.h"
+#include "common/metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+constexpr size_t OPERATIONS = 4000000; // Split between the threads
+
+// ns per operation with threads threads calling op OPERATIONS times in total
+template <typename Op>
+double contended(size_t threads, Op&& op) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    const size_t per_thread = OPERATIONS / threads;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            while (!go.load()) std::this_thread::yield();
+            for (size_t i = 0; i < per_thread; ++i) op(t * per_thread + i);
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (std::thread& worker : workers) worker.join();
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    return ns / (per_thread * threads);
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Recording cost, ns per operation (all threads on one metric)");
+    std::printf("%8s %14s %14s %14s\n", "threads", "counter", "atomic", "histogram");
+    for (size_t threads : {1, 2, 4, 8}) {
+        metrics::Counter counter;
+        std::atomic<uint64_t> shared{0};
+        metrics::Histogram histogram;
+        double sharded = contended(threads, [&](size_t) { counter.add(); });
+        double plain = contended(threads, [&](size_t) { shared.fetch_add(1, std::memory_order_relaxed); });
+        double recorded = contended(threads, [&](size_t i) { histogram.record(1000 + (i * 2654435761u) % 500000); });
+        bench::doNotOptimize(counter.value());
+        std::printf("%8zu %14.2f %14.2f %14.2f\n", threads, sharded, plain, recorded);
+    }
+
+    bench::printHeader("Histogram percentiles against the exact ones (log-normal latencies, ns)");
+    std::mt19937_64 rng(7);
+    std::lognormal_distribution<double> latency(11.0, 1.2); // ~60 us median, long tail
+    std::vector<uint64_t> values(1000000);
+    metrics::Histogram histogram;
+    for (uint64_t& value : values) {
+        value = static_cast<uint64_t>(latency(rng));
+        histogram.record(value);
+    }
+    std::sort(values.begin(), values.end());
+    metrics::Histogram::Snapshot snapshot = histogram.snapshot();
+
+    bool accurate = true;
+    std::printf("%10s %14s %14s %10s\n", "quantile", "exact", "histogram", "error");
+    for (double p : {0.5, 0.9, 0.99, 0.999, 1.0}) {
+        size_t rank = static_cast<size_t>(std::ceil(p * values.size()));
+        double exact = static_cast<double>(values[std::max<size_t>(rank, 1) - 1]);
+        double estimate = snapshot.percentile(p);
+        double error = std::abs(estimate - exact) / exact;
+        std::printf("%10.3f %14.0f %14.0f %9.2f%%\n", p, exact, estimate, error * 100);
+        if (error > 1.0 / metrics::Histogram::SUB_BUCKETS) accurate = false;
+    }
+
+    metrics::Registry registry;
+    registry.counter("frames_total").add(3);
+    registry.histogram("latency_ns", "type=\"play_turn\"").record(1500);
+    std::string text = registry.prometheusText();
+    bool exported = text.find("frames_total 3") != std::string::npos &&
+                    text.find("latency_ns{type=\"play_turn\",quantile=\"0.99\"}") != std::string::npos &&
+                    text.find("latency_ns_count{type=\"play_turn\"} 1") != std::string::npos;
+
+    if (!accurate) {
+        std::printf("Histogram percentile outside the bucket resolution\n");
+        return 1;
+    }
+    if (!exported) {
+        std::printf("Prometheus text is missing samples:\n%s", text.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,198 @@
+// bench/mpsc_bench.cpp
+// Outbound frame rate with 1 to 32 producer threads: the lock-free MpscQueue
+// against a mutex-protected deque, then end to end through an EventLoop
+#include "bench/bench_util.h"
+#include "common/event_loop.h"
+#include "common/mpsc_queue.h"
+#include <sys/socket.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+constexpr size_t TOTAL_FRAMES = 400000; // Split between the producers
+constexpr size_t BACKPRESSURE_BYTES = 256 * 1024;
+
+using clock_type = std::chrono::steady_clock;
+
+double secondsSince(clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+// The lock every sendMessage caller would otherwise share
+class LockedQueue {
+private:
+    std::mutex mutex;
+    std::deque<std::string> frames;
+
+public:
+    void push(std::string frame) {
+        std::lock_guard<std::mutex> lock(mutex);
+        frames.push_back(std::move(frame));
+    }
+
+    template <typename Fn>
+    size_t consumeAll(Fn&& fn) {
+        std::deque<std::string> taken;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            taken.swap(frames);
+        }
+        for (std::string& frame : taken) fn(std::move(frame));
+        return taken.size();
+    }
+};
+
+// Producers push TOTAL_FRAMES frames, one consumer thread drains; frames/s
+template <typename Queue>
+double queueRate(size_t producers, const std::string& payload) {
+    Queue queue;
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    const size_t per_producer = TOTAL_FRAMES / producers;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            while (!go.load()) std::this_thread::yield();
+            for (size_t i = 0; i < per_producer; ++i) queue.push(payload);
+        });
+    }
+
+    size_t expected = per_producer * producers;
+    size_t consumed = 0;
+    size_t bytes = 0;
+    auto start = clock_type::now();
+    go = true;
+    while (consumed < expected) {
+        size_t taken = queue.consumeAll([&](std::string&& frame) { bytes += frame.size(); });
+        if (taken == 0) std::this_thread::yield();
+        consumed += taken;
+    }
+    double seconds = secondsSince(start);
+    for (std::thread& thread : threads) thread.join();
+    bench::doNotOptimize(bytes);
+    return consumed / seconds;
+}
+
+struct EndToEnd {
+    double frames_per_second = 0;
+    size_t backpressure = 0; // Posts refused because the peer had not read enough yet
+};
+
+// Producers post on one connection of a running EventLoop; the peer reads
+// with a blocking TcpConnection on the other end of a socketpair
+EndToEnd endToEndRate(size_t producers, const std::string& payload) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) return {};
+
+    net::EventLoop loop;
+    loop.init();
+    net::EventLoop::ConnectionId id = loop.addConnection(std::make_unique<net::TcpConnection>(fds[0]));
+    std::shared_ptr<net::OutboundQueue> outbound = loop.outbound(id);
+    outbound->setMaxBytes(BACKPRESSURE_BYTES);
+    std::thread loop_thread([&] { loop.run(); });
+
+    net::TcpConnection peer(fds[1]);
+    const size_t per_producer = TOTAL_FRAMES / producers;
+    const size_t expected = per_producer * producers;
+    std::atomic<bool> go{false};
+    std::atomic<size_t> backpressure{0};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            while (!go.load()) std::this_thread::yield();
+            for (size_t i = 0; i < per_producer;) {
+                net::PostStatus status = outbound->post(payload);
+                if (status == net::PostStatus::queued) {
+                    ++i;
+                } else if (status == net::PostStatus::backpressure) {
+                    backpressure++;
+                    std::this_thread::yield();
+                } else {
+                    return;
+                }
+            }
+        });
+    }
+
+    auto start = clock_type::now();
+    go = true;
+    size_t received = 0;
+    while (received < expected && !peer.receiveFrame().empty()) received++;
+    EndToEnd result;
+    result.frames_per_second = received / secondsSince(start);
+    result.backpressure = backpressure.load();
+
+    for (std::thread& thread : threads) thread.join();
+    loop.stop();
+    loop_thread.join();
+    return result;
+}
+
+// One connection fed both ways at once, EventLoop::send from the loop thread
+// and OutboundQueue::post, while a slow peer keeps the socket buffer full.
+// Every frame must come out whole: a partial write of one path must not let
+// the other path's bytes in between.
+bool mixedSendsStayFramed() {
+    constexpr size_t FRAMES = 5000; // Per path
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) < 0) return false;
+    int small = 4096;
+    setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &small, sizeof(small));
+
+    net::EventLoop loop;
+    loop.init();
+    net::EventLoop::ConnectionId id = loop.addConnection(std::make_unique<net::TcpConnection>(fds[0]));
+    std::shared_ptr<net::OutboundQueue> outbound = loop.outbound(id);
+
+    net::TcpConnection peer(fds[1]);
+    std::atomic<size_t> received{0};
+    std::atomic<size_t> broken{0};
+    std::thread reader([&] {
+        while (received < 2 * FRAMES) {
+            std::string_view frame = peer.receiveFrame();
+            if (frame.empty()) return;
+            bool whole = frame.size() == 1000 && (frame[0] == 'p' || frame[0] == 's') &&
+                         frame.find_first_not_of(frame[0]) == std::string_view::npos;
+            if (!whole) broken++;
+            received++;
+        }
+    });
+
+    const std::string posted(1000, 'p');
+    const std::string sent(1000, 's');
+    for (size_t i = 0; i < FRAMES; ++i) {
+        while (outbound->post(posted) == net::PostStatus::backpressure) loop.runOnce(1);
+        loop.runOnce(0); // Flushes the posted frame, often only part of it
+        loop.send(id, sent);
+    }
+    auto deadline = clock_type::now() + std::chrono::seconds(10);
+    while (received < 2 * FRAMES && clock_type::now() < deadline) loop.runOnce(10);
+    shutdown(fds[1], SHUT_RDWR); // A corrupted length prefix would leave the reader waiting
+    reader.join();
+    return received == 2 * FRAMES && broken == 0;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Outbound frames from many producer threads (turn_request sized frames)");
+    const std::string payload(200, 'x');
+    std::printf("%10s %16s %16s %8s %16s %14s\n", "producers", "mpsc frames/s", "mutex frames/s", "ratio",
+                "e2e frames/s", "backpressure");
+    for (size_t producers : {1, 2, 4, 8, 16, 32}) {
+        double lock_free = queueRate<concurrency::MpscQueue<std::string>>(producers, payload);
+        double locked = queueRate<LockedQueue>(producers, payload);
+        EndToEnd e2e = endToEndRate(producers, payload);
+        std::printf("%10zu %16.0f %16.0f %7.2fx %16.0f %14zu\n", producers, lock_free, locked, lock_free / locked,
+                    e2e.frames_per_second, e2e.backpressure);
+    }
+
+    if (!mixedSendsStayFramed()) {
+        std::printf("FAIL: posted and loop-sent frames interleaved on one connection\n");
+        return 1;
+    }
+    std::printf("Posted and loop-sent frames on one connection under backpressure: all whole\n");
+    return 0;
+}
@@ -0,0 +1,82 @@
+// bench/parser_bench.cpp
+// Compares the single-pass GameState parser against the previous find/substr parser
+#include "bench/bench_util.h"
+#include "bench/legacy_parser.h"
+#include "common/json_cursor.h"
+#include "common/rpc_protocol.h"
+#include <cstdio>
+#include <string_view>
+
+namespace {
+
+std::string makePlayTurn(const game::GameState& state) {
+    return "{\"id\":\"3\",\"type\":\"play_turn\",\"agent_id\":\"red_agent_0\",\"state\":" +
+           rpc::serializeGameState(state) + "}";
+}
+
+bool sameState(const game::GameState& a, const game::GameState& b) {
+    if (a.agents.size() != b.agents.size() || a.bases.size() != b.bases.size()) return false;
+    for (size_t i = 0; i < a.agents.size(); ++i) {
+        const auto& x = a.agents[i];
+        const auto& y = b.agents[i];
+        if (x.id != y.id || x.team != y.team || !(x.position == y.position) ||
+            x.facing != y.facing || x.hp != y.hp || x.max_hp != y.max_hp || x.is_alive != y.is_alive) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.bases.size(); ++i) {
+        if (a.bases[i].team != b.bases[i].team || !(a.bases[i].position == b.bases[i].position) ||
+            a.bases[i].hp != b.bases[i].hp) {
+            return false;
+        }
+    }
+    return a.current_turn == b.current_turn && a.config.map_width == b.config.map_width &&
+           a.config.map_height == b.config.map_height && a.config.max_turns == b.config.max_turns;
+}
+
+// What readInt accepts, with the value it reads
+bool readsInt(std::string_view text, int& out) {
+    rpc::JsonCursor cursor(text);
+    return cursor.readInt(out);
+}
+
+// The int range reads exactly; past it fails instead of wrapping
+bool intRangeChecked() {
+    int value = 0;
+    return readsInt("2147483647", value) && value == 2147483647 &&
+           readsInt("-2147483648", value) && value == -2147483647 - 1 &&
+           !readsInt("2147483648", value) && !readsInt("-2147483649", value) &&
+           !readsInt("123456789012345678901234567890", value);
+}
+
+} // namespace
+
+int main() {
+    if (!intRangeChecked()) {
+        std::printf("FAIL: JsonCursor::readInt accepts integers outside the int range\n");
+        return 1;
+    }
+
+    bench::printHeader("deserializeGameState: legacy find/substr vs single pass");
+    std::printf("%8s %10s %14s %14s %9s\n", "agents", "bytes", "legacy ns/op", "cursor ns/op", "speedup");
+
+    for (int agents : {10, 50, 200, 500, 1000, 2000}) {
+        game::GameState state = bench::makeGameState(agents, 200);
+        std::string message = makePlayTurn(state);
+
+        if (!sameState(legacy::deserializeGameState(message), rpc::deserializeGameState(message))) {
+            std::printf("parsers disagree for %d agents\n", agents);
+            return 1;
+        }
+
+        double legacy_ns = bench::measureNs([&] {
+            bench::doNotOptimize(legacy::deserializeGameState(message));
+        });
+        double cursor_ns = bench::measureNs([&] {
+            bench::doNotOptimize(rpc::deserializeGameState(message));
+        });
+        std::printf("%8d %10zu %14.0f %14.0f %8.1fx\n", agents, message.size(),
+                    legacy_ns, cursor_ns, legacy_ns / cursor_ns);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+// bench/path_bench.cpp
+// Pathfinding on a 200x200 map: full BFS build against the incremental repair of the
+// base distance fields as agents move, bounded A*, and the per-agent decision time
+#include "bench/bench_util.h"
+#include "common/game_rules.h"
+#include "common/spatial_grid.h"
+#include "logic/logic.h"
+#include "logic/pathfinding.h"
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace {
+
+constexpr int MAP = 200;
+
+double microsecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::vector<uint16_t> occupancy(const game::GameState& state) {
+    std::vector<uint16_t> blocked(static_cast<size_t>(MAP) * MAP, 0);
+    for (const game::Agent& agent : state.agents) {
+        if (agent.is_alive) blocked[agent.position.y * MAP + agent.position.x]++;
+    }
+    return blocked;
+}
+
+std::vector<game::Action> randomMoves(const game::GameState& state, std::mt19937& rng) {
+    std::uniform_int_distribution<int> dir(0, 3);
+    std::vector<game::Action> actions;
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        actions.emplace_back(rng() % 10 < 6 ? game::ActionType::move : game::ActionType::defend,
+                             static_cast<game::Direction>(dir(rng)));
+    }
+    return actions;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Pathfinding on a 200x200 map: BFS build vs incremental repair, A*, decisions");
+    std::printf("%8s %11s %12s %12s %12s %14s\n", "agents", "BFS build", "repair/turn", "A* (d~60)", "decision",
+                "turn (all)");
+
+    for (int agents : {100, 1000, 5000, 10000}) {
+        game::GameState state = bench::makeGameState(agents, MAP);
+        for (game::Agent& agent : state.agents) agent.hp = agent.max_hp; // Nobody flees
+        std::mt19937 rng(3);
+
+        const game::Position red_base = state.bases[0].position;
+        const game::Position blue_base = state.bases[1].position;
+        double build = bench::measureNs([&] {
+            agent::DistanceField field(red_base, MAP, MAP);
+            field.build(occupancy(state));
+            bench::doNotOptimize(field);
+        }, 100);
+
+        // Incremental repair, checked against a full build every turn
+        agent::PathCache cache;
+        cache.update(state);
+        cache.field(red_base);
+        cache.field(blue_base);
+        double repair_total = 0;
+        const int turns = 20;
+        for (int turn = 0; turn < turns; ++turn) {
+            game::resolveTurn(state, randomMoves(state, rng));
+            state.current_turn++;
+            auto start = std::chrono::steady_clock::now();
+            cache.update(state);
+            repair_total += microsecondsSince(start);
+
+            std::vector<uint16_t> blocked = occupancy(state);
+            for (const game::Position& base : {red_base, blue_base}) {
+                agent::DistanceField fresh(base, MAP, MAP);
+                fresh.build(blocked);
+                const agent::DistanceField& repaired = cache.field(base);
+                for (int y = 0; y < MAP; ++y) {
+                    for (int x = 0; x < MAP; ++x) {
+                        if (fresh.distanceFrom(game::Position(x, y)) != repaired.distanceFrom(game::Position(x, y))) {
+                            std::printf("repaired field differs from a full BFS at (%d,%d), %d agents\n", x, y, agents);
+                            return 1;
+                        }
+                    }
+                }
+            }
+        }
+
+        // A* between living agents about 60 steps apart
+        std::vector<std::pair<game::Position, game::Position>> queries;
+        for (size_t i = 0; i < state.agents.size() && queries.size() < 64; ++i) {
+            for (size_t j = i + 1; j < state.agents.size(); ++j) {
+                const game::Position& a = state.agents[i].position;
+                const game::Position& b = state.agents[j].position;
+                int d = std::abs(a.x - b.x) + std::abs(a.y - b.y);
+                if (state.agents[i].is_alive && state.agents[j].is_alive && d >= 55 && d <= 65) {
+                    queries.emplace_back(a, b);
+                    break;
+                }
+            }
+        }
+        size_t next_query = 0;
+        double astar = bench::measureNs([&] {
+            const auto& query = queries[next_query++ % queries.size()];
+            game::Direction step;
+            bench::doNotOptimize(cache.firstStepTowards(query.first, query.second, 4096, step));
+        }, 100);
+
+        // Every agent decides with one shared grid, path cache and influence map
+        auto shared = std::make_shared<agent::PathCache>();
+        auto influence = std::make_shared<agent::InfluenceMap>();
+        std::vector<agent::SimpleAgent> brains(state.agents.size());
+        for (size_t i = 0; i < brains.size(); ++i) {
+            brains[i].initialize(state.agents[i].id, state.agents[i].team);
+            brains[i].setPathCache(shared);
+            brains[i].setInfluenceMap(influence);
+        }
+        game::SpatialGrid grid(state);
+        influence->update(state); // The owner updates the shared map before the agents decide
+        for (agent::SimpleAgent& brain : brains) brain.processTurn(state, grid); // Builds the fields once
+        double turn = bench::measureNs([&] {
+            game::SpatialGrid fresh(state);
+            influence->update(state);
+            for (agent::SimpleAgent& brain : brains) bench::doNotOptimize(brain.processTurn(state, fresh));
+        }, 200);
+
+        std::printf("%8d %9.1fus %10.1fus %10.2fus %10.2fus %12.1fus\n", agents, build / 1e3, repair_total / turns,
+                    astar / 1e3, turn / 1e3 / agents, turn / 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// bench/reactor_bench.cpp
+// Load generator for the epoll EventLoop: connection rate and framed message rate
+#include "bench/bench_util.h"
+#include "common/event_loop.h"
+#include <sys/resource.h>
+#include <atomic>
+#include <thread>
+
+namespace {
+
+constexpr int PORT = 18471;
+
+using clock_type = std::chrono::steady_clock;
+
+double secondsSince(clock_type::time_point start) {
+    return std::chrono::duration<double>(clock_type::now() - start).count();
+}
+
+void raiseFileLimit() {
+    rlimit limit{};
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+}
+
+void runScenario(int clients, int messages_per_client, int window) {
+    // Coordinator side: one reactor thread echoing every frame
+    net::TcpServer server(PORT);
+    server.setNonBlocking(true);
+    server.setNoDelay(true);
+    server.setLogConnections(false);
+    server.start();
+
+    net::EventLoop server_loop(&server);
+    server_loop.init();
+    std::atomic<int> accepted{0};
+    server_loop.onConnect([&](net::EventLoop::ConnectionId) { accepted++; });
+    server_loop.onMessage([&](net::EventLoop::ConnectionId id, std::string_view frame) {
+        server_loop.send(id, frame);
+    });
+    std::thread server_thread([&] { server_loop.run(); });
+
+    // Load generator side: blocking connects, then a reactor of its own
+    auto connect_start = clock_type::now();
+    std::vector<std::unique_ptr<net::TcpConnection>> pending;
+    for (int i = 0; i < clients; ++i) {
+        auto connection = std::make_unique<net::TcpConnection>();
+        if (!connection->connect("127.0.0.1", PORT)) break;
+        connection->setNoDelay(true);
+        pending.push_back(std::move(connection));
+    }
+    while (accepted.load() < static_cast<int>(pending.size())) {
+        std::this_thread::yield();
+    }
+    double connect_seconds = secondsSince(connect_start);
+
+    net::EventLoop client_loop;
+    client_loop.init();
+    std::unordered_map<net::EventLoop::ConnectionId, int> remaining;
+    long long received = 0;
+    long long expected = static_cast<long long>(pending.size()) * messages_per_client;
+    const std::string payload = "{\"id\":\"12\",\"action\":\"move_north\"}";
+
+    client_loop.onMessage([&](net::EventLoop::ConnectionId id, std::string_view) {
+        received++;
+        int& left = remaining[id];
+        if (left > 0) {
+            left--;
+            client_loop.send(id, payload);
+        }
+    });
+
+    auto message_start = clock_type::now();
+    for (auto& connection : pending) {
+        net::EventLoop::ConnectionId id = client_loop.addConnection(std::move(connection));
+        int initial = std::min(window, messages_per_client);
+        remaining[id] = messages_per_client - initial;
+        for (int i = 0; i < initial; ++i) client_loop.send(id, payload);
+    }
+    while (received < expected) {
+        client_loop.runOnce(100);
+    }
+    double message_seconds = secondsSince(message_start);
+
+    std::printf("%8zu %8d %14.0f %14.0f\n", remaining.size(), window,
+                remaining.size() / connect_seconds, received / message_seconds);
+
+    server_loop.stop();
+    server_thread.join();
+}
+
+} // namespace
+
+int main() {
+    raiseFileLimit();
+    bench::printHeader("EventLoop load generator (echo of turn_response sized frames)");
+    std::printf("%8s %8s %14s %14s\n", "clients", "window", "conns/s", "msgs/s");
+    runScenario(100, 200, 1);
+    runScenario(1000, 50, 1);
+    runScenario(1000, 50, 8);
+    runScenario(4000, 20, 4);
+    return 0;
+}
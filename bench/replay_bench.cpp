@@ -0,0 +1,137 @@
+// bench/replay_bench.cpp
+// Records a simulated match to a replay log, then times seeking to random
+// turns, rebuilding every state from the mapped log (against a plain memcpy
+// of the same bytes) and replaying it through SimpleAgent::processTurn. Exits
+// with 1 when the replayed decisions differ from the recorded ones, a state
+// fails its checksum, a log cut short loses more than its last turn or a
+// footer with a bad keyframe is trusted.
+#include "bench/bench_util.h"
+#include "common/binary_codec.h"
+#include "common/replay_log.h"
+#include "simulator/match_simulator.h"
+#include "simulator/replay_engine.h"
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+
+constexpr const char* LOG_PATH = "replay_bench.log";
+constexpr const char* CUT_PATH = "replay_bench_cut.log";
+constexpr const char* PATCHED_PATH = "replay_bench_patched.log";
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    // Usage: ./replay_bench [agents] [turns]
+    size_t agents = argc > 1 ? std::stoul(argv[1]) : 1000;
+    int turns = argc > 2 ? std::stoi(argv[2]) : 500;
+
+    simulator::SimulatorConfig config;
+    config.agents = agents;
+    config.game.max_turns = turns;
+    config.game.map_width = config.game.map_height = 200;
+    config.seed = 9;
+    config.replay_path = LOG_PATH;
+    auto record_start = std::chrono::steady_clock::now();
+    simulator::SimulationReport simulated = simulator::MatchSimulator(config).run();
+    double record_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - record_start).count();
+
+    replay::ReplayReader log;
+    if (!log.open(LOG_PATH)) {
+        std::printf("Could not open %s\n", LOG_PATH);
+        return 1;
+    }
+    bench::printHeader("Replay log of a simulated match");
+    std::printf("%zu agents, %zu turns recorded in %.2f s (simulation included), %zu bytes, %.0f bytes/turn\n",
+                agents, log.turnCount(), record_s, log.fileSize(),
+                static_cast<double>(log.fileSize()) / std::max<size_t>(1, log.turnCount()));
+
+    // Seek: index lookup, then the keyframe and at most interval - 1 deltas
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<size_t> pick(0, log.turnCount() - 1);
+    game::GameState state;
+    bool ok = true;
+    double seek_ns = bench::measureNs([&] { ok = log.stateAt(pick(rng), state) && ok; });
+    size_t last = log.turnCount() - 1;
+    double from_start_ns = bench::measureNs([&] {
+        for (size_t e = 0; e <= last; ++e) ok = log.advance(e, state) && ok;
+    });
+    std::printf("%-34s %12.1f us\n", "seek to a random turn", seek_ns / 1e3);
+    std::printf("%-34s %12.1f us\n", "walk from the first turn to the last", from_start_ns / 1e3);
+
+    // Decode only: every state rebuilt from the mapping, against copying the bytes
+    simulator::ReplayConfig decode_only;
+    decode_only.decide = false;
+    simulator::ReplayReport decoded = simulator::ReplayEngine(log).run(decode_only);
+    std::string file_bytes(log.fileSize(), '\0');
+    std::ifstream(LOG_PATH, std::ios::binary).read(file_bytes.data(), file_bytes.size());
+    std::string copy(file_bytes.size(), '\0');
+    double memcpy_ns = bench::measureNs([&] {
+        std::memcpy(copy.data(), file_bytes.data(), file_bytes.size());
+        bench::doNotOptimize(copy.data());
+    });
+    double decode_mbs = decoded.bytes / decoded.decode_seconds / 1e6;
+    double memcpy_mbs = file_bytes.size() / memcpy_ns * 1e3;
+    std::printf("%-34s %12.0f MB/s (%.0f turns/s)\n", "rebuild states from the log", decode_mbs,
+                decoded.turns / decoded.decode_seconds);
+    std::printf("%-34s %12.0f MB/s\n", "memcpy of the same bytes", memcpy_mbs);
+
+    // Full replay: the agents decide again and must answer as recorded
+    simulator::ReplayReport replayed = simulator::ReplayEngine(log).run(simulator::ReplayConfig());
+    std::printf("%-34s %12.0f decisions/s, %zu of %zu differ (simulation decided %.0f/s)\n",
+                "replay through processTurn", replayed.decisions / replayed.decide_seconds, replayed.mismatches,
+                replayed.compared, simulated.decisionsPerSecond());
+
+    // A recorder that dies mid-turn: no index and a torn last record
+    {
+        std::ofstream cut(CUT_PATH, std::ios::binary | std::ios::trunc);
+        cut.write(file_bytes.data(), static_cast<std::streamsize>(log.recordBytes(0, last) + replay::HEADER_SIZE + 7));
+    }
+    replay::ReplayReader torn;
+    bool recovered = torn.open(CUT_PATH) && !torn.hasIndex() && torn.turnCount() == last &&
+                     torn.stateAt(last - 1, state);
+    std::printf("%-34s %12s (%zu of %zu turns)\n", "log cut mid-record", recovered ? "recovered" : "LOST",
+                torn.turnCount(), log.turnCount());
+    std::remove(CUT_PATH);
+
+    // A footer that points turn 3 at a later keyframe, or at a delta, must
+    // be dropped for the index the records give
+    bool keyframes_checked = true;
+    for (uint32_t keyframe : {5u, 1u}) {
+        std::string patched = file_bytes;
+        uint64_t index_offset;
+        std::memcpy(&index_offset, patched.data() + patched.size() - replay::FOOTER_SIZE, sizeof(index_offset));
+        std::memcpy(patched.data() + index_offset + replay::RECORD_HEADER_SIZE + 3 * replay::INDEX_ENTRY_SIZE + 8,
+                    &keyframe, sizeof(keyframe));
+        std::ofstream(PATCHED_PATH, std::ios::binary | std::ios::trunc).write(patched.data(), patched.size());
+        replay::ReplayReader reader;
+        game::GameState expected;
+        game::GameState rebuilt;
+        keyframes_checked = keyframes_checked && reader.open(PATCHED_PATH) && !reader.hasIndex() &&
+                            reader.turnCount() == log.turnCount() && log.stateAt(3, expected) &&
+                            reader.stateAt(3, rebuilt) &&
+                            rpc::checksumGameState(expected) == rpc::checksumGameState(rebuilt);
+    }
+    std::printf("%-34s %12s\n", "footer with a bad keyframe", keyframes_checked ? "rebuilt" : "TRUSTED");
+    std::remove(PATCHED_PATH);
+    std::remove(LOG_PATH);
+
+    if (!ok || !decoded.ok || !replayed.ok) {
+        std::printf("A replayed state failed to decode or its checksum\n");
+        return 1;
+    }
+    if (replayed.mismatches > 0) {
+        std::printf("Replayed decisions differ from the recorded ones\n");
+        return 1;
+    }
+    if (!recovered) {
+        std::printf("The cut log did not recover its complete turns\n");
+        return 1;
+    }
+    if (!keyframes_checked) {
+        std::printf("A footer with a bad keyframe was trusted\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// bench/resolve_bench.cpp
+// Turn resolution time of the serial resolveTurn against the tiled parallel one,
+// from 1 to N threads, for 10k to 1M agents
+#include "bench/bench_util.h"
+#include "common/binary_codec.h"
+#include "common/game_rules.h"
+#include "common/thread_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+
+namespace {
+
+constexpr int TURNS = 5;  // Turns resolved per run, each with its own actions
+constexpr int RUNS = 3;   // Best of
+
+std::vector<std::vector<game::Action>> makeActions(size_t agents, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> type(0, 3);
+    std::uniform_int_distribution<int> direction(0, 3);
+    std::vector<std::vector<game::Action>> turns(TURNS);
+    for (std::vector<game::Action>& actions : turns) {
+        actions.reserve(agents);
+        for (size_t i = 0; i < agents; ++i) {
+            actions.emplace_back(static_cast<game::ActionType>(type(rng)), static_cast<game::Direction>(direction(rng)));
+        }
+    }
+    return turns;
+}
+
+bool sameState(const game::GameState& a, const game::GameState& b) {
+    if (a.agents.size() != b.agents.size() || a.bases.size() != b.bases.size()) return false;
+    for (size_t i = 0; i < a.agents.size(); ++i) {
+        const game::Agent& x = a.agents[i];
+        const game::Agent& y = b.agents[i];
+        if (x.position.x != y.position.x || x.position.y != y.position.y || x.hp != y.hp ||
+            x.is_alive != y.is_alive || x.facing != y.facing) {
+            std::printf("agent %zu differs\n", i);
+            return false;
+        }
+    }
+    for (size_t i = 0; i < a.bases.size(); ++i) {
+        if (a.bases[i].hp != b.bases[i].hp || a.bases[i].is_destroyed != b.bases[i].is_destroyed) {
+            std::printf("base %zu differs\n", i);
+            return false;
+        }
+    }
+    return rpc::checksumGameState(a) == rpc::checksumGameState(b);
+}
+
+// Best wall time of TURNS turns in ms; the state copy is not timed
+template <typename Resolve>
+double timeTurns(const game::GameState& initial, const std::vector<std::vector<game::Action>>& turns,
+                 Resolve&& resolve, game::GameState* result) {
+    using clock = std::chrono::steady_clock;
+    double best = 0;
+    for (int run = 0; run < RUNS; ++run) {
+        game::GameState state = initial;
+        auto start = clock::now();
+        for (const std::vector<game::Action>& actions : turns) resolve(state, actions);
+        double ms = std::chrono::duration<double, std::milli>(clock::now() - start).count();
+        if (run == 0 || ms < best) best = ms;
+        if (run == 0 && result) *result = std::move(state);
+    }
+    return best;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("resolveTurn: serial against tiled parallel");
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t <= std::max<size_t>(cores, 8); t *= 2) thread_counts.push_back(t);
+    if (thread_counts.back() != cores && cores > 8) thread_counts.push_back(cores);
+    std::printf("hardware threads: %zu, %d turns per run, best of %d\n\n", cores, TURNS, RUNS);
+    std::printf("%10s %6s %10s %14s %14s %9s\n", "agents", "map", "threads", "ms/turn", "agents/us", "speedup");
+
+    for (int agents : {10000, 100000, 1000000}) {
+        const int map = static_cast<int>(std::sqrt(4.0 * agents));
+        game::GameState initial = bench::makeGameState(agents, map, 42);
+        // Dense enough that attacks and move claims cross tile borders every turn
+        std::vector<std::vector<game::Action>> turns = makeActions(initial.agents.size(), 7);
+
+        game::GameState serial_result;
+        double serial_ms = timeTurns(initial, turns, [](game::GameState& state, const std::vector<game::Action>& a) {
+            game::resolveTurn(state, a);
+        }, &serial_result);
+        std::printf("%10d %6d %10s %14.3f %14.2f %9s\n", agents, map, "serial", serial_ms / TURNS,
+                    agents / (serial_ms / TURNS * 1e3), "1.00x");
+
+        for (size_t threads : thread_counts) {
+            concurrency::ThreadPool pool(threads - 1);
+            game::GameState tiled_result;
+            double ms = timeTurns(initial, turns, [&](game::GameState& state, const std::vector<game::Action>& a) {
+                game::resolveTurn(state, a, pool);
+            }, &tiled_result);
+            if (!sameState(serial_result, tiled_result)) {
+                std::printf("tiled resolveTurn with %zu threads differs from the serial one (%d agents)\n", threads,
+                            agents);
+                return 1;
+            }
+            std::printf("%10d %6d %10zu %14.3f %14.2f %8.2fx\n", agents, map, threads, ms / TURNS,
+                        agents / (ms / TURNS * 1e3), serial_ms / ms);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,156 @@
+// bench/response_bench.cpp
+// Agent -> coordinator responses: the operator+ builders they replaced
+// against the append writers filling a reused send buffer. Exits with 1 when
+// the writers disagree with the old bytes or still allocate in steady state.
+#include "bench/bench_util.h"
+#include "common/game_rules.h"
+#include "common/rpc_protocol.h"
+#include "common/tcp_connection.h"
+#include "logic/logic.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> heap_allocations{0};
+
+// The builders as they were, with the action assembled like agent.cpp did
+std::string legacyTurnResponse(const std::string& id, const std::string& action, bool resync = false) {
+    return std::string("{") +
+        "\"id\":\"" + id + "\"," +
+        "\"action\":\"" + action + "\"" +
+        (resync ? ",\"resync\":true" : "") +
+    "}";
+}
+
+std::string legacyVoidResponse(const std::string& id) {
+    return std::string("{") +
+        "\"id\":\"" + id + "\"," +
+        "\"status\":\"ok\"" +
+    "}";
+}
+
+std::string legacyAction(const agent::SimpleAction& action) {
+    std::string direction_str = game::getStringFromDirection(action.direction);
+    switch (action.type) {
+        case agent::SimpleActionType::move: return "move_" + direction_str;
+        case agent::SimpleActionType::attack: return "attack_" + direction_str;
+        default: return "defend_" + direction_str;
+    }
+}
+
+struct Result {
+    double ns = 0;
+    double allocations = 0; // Per response
+};
+
+template <typename Fn>
+Result measure(Fn&& fn) {
+    Result result;
+    result.ns = bench::measureNs(fn);
+    constexpr int CALLS = 10000;
+    uint64_t before = heap_allocations.load();
+    for (int i = 0; i < CALLS; ++i) fn();
+    result.allocations = static_cast<double>(heap_allocations.load() - before) / CALLS;
+    return result;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    bench::printHeader("Turn and void responses: operator+ builders vs append writers into the send buffer");
+
+    // Every type x direction the agent can answer with, and realistic call ids
+    std::vector<agent::SimpleAction> actions;
+    for (agent::SimpleActionType type :
+         {agent::SimpleActionType::move, agent::SimpleActionType::attack, agent::SimpleActionType::defend}) {
+        for (int d = 0; d < 4; ++d) {
+            agent::SimpleAction action;
+            action.type = type;
+            action.direction = static_cast<game::Direction>(d);
+            actions.push_back(action);
+        }
+    }
+    std::vector<std::string> ids;
+    for (int i = 0; i < 64; ++i) ids.push_back(std::to_string(1000000 + i * 7919));
+
+    bool same = true;
+    std::string check;
+    for (size_t i = 0; i < ids.size(); ++i) {
+        const agent::SimpleAction& action = actions[i % actions.size()];
+        check.clear();
+        rpc::appendTurnResponse(check, ids[i], agent::actionName(action));
+        if (check != legacyTurnResponse(ids[i], legacyAction(action))) same = false;
+        check.clear();
+        rpc::appendTurnResponse(check, ids[i], "", true);
+        if (check != legacyTurnResponse(ids[i], "", true)) same = false;
+        check.clear();
+        rpc::appendVoidResponse(check, ids[i]);
+        if (check != legacyVoidResponse(ids[i])) same = false;
+    }
+    // Payloads that do need escaping still go through escapeJson
+    check.clear();
+    rpc::appendVoidResponse(check, "a\"b");
+    if (check != "{\"id\":\"a\\\"b\",\"status\":\"ok\"}") same = false;
+
+    // A connection that never flushes: the frames pile up in its send buffer,
+    // which is cleared between batches the way a drained flush would
+    net::TcpConnection connection;
+    size_t next = 0;
+    size_t frames = 0;
+    auto recycle = [&] {
+        if (++frames % 1024 == 0) connection.beginFrame().clear(); // Drops the open frame too
+    };
+
+    std::printf("%-10s %14s %14s %8s %16s %16s\n", "response", "operator+ ns", "writer ns", "speedup",
+                "operator+ allocs", "writer allocs");
+
+    Result old_turn = measure([&] {
+        const agent::SimpleAction& action = actions[next % actions.size()];
+        std::string frame = legacyTurnResponse(ids[next++ % ids.size()], legacyAction(action));
+        connection.queueMessage(frame);
+        recycle();
+    });
+    Result new_turn = measure([&] {
+        const agent::SimpleAction& action = actions[next % actions.size()];
+        std::string_view id = ids[next++ % ids.size()];
+        rpc::appendTurnResponse(connection.beginFrame(), id, agent::actionName(action));
+        connection.endFrame();
+        recycle();
+    });
+    std::printf("%-10s %14.1f %14.1f %7.2fx %16.2f %16.2f\n", "turn", old_turn.ns, new_turn.ns,
+                old_turn.ns / new_turn.ns, old_turn.allocations, new_turn.allocations);
+
+    Result old_void = measure([&] {
+        std::string frame = legacyVoidResponse(ids[next++ % ids.size()]);
+        connection.queueMessage(frame);
+        recycle();
+    });
+    Result new_void = measure([&] {
+        rpc::appendVoidResponse(connection.beginFrame(), ids[next++ % ids.size()]);
+        connection.endFrame();
+        recycle();
+    });
+    std::printf("%-10s %14.1f %14.1f %7.2fx %16.2f %16.2f\n", "void", old_void.ns, new_void.ns,
+                old_void.ns / new_void.ns, old_void.allocations, new_void.allocations);
+
+    if (!same) {
+        std::printf("Append writers differ from the operator+ builders\n");
+        return 1;
+    }
+    if (new_turn.allocations >= 0.01 || new_void.allocations >= 0.01) {
+        std::printf("Append writers still allocate per response\n");
+        return 1;
+    }
+    return 0;
+}
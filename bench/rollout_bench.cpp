@@ -0,0 +1,175 @@
+// bench/rollout_bench.cpp
+// Monte Carlo rollout planner: rollouts per second per core as threads are added, identical results at any
+// thread count, simulated turns that never reach the heap, and the planner deciding inside SimpleAgent
+#include "bench/bench_util.h"
+#include "common/spatial_grid.h"
+#include "common/thread_pool.h"
+#include "logic/rollout_planner.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> heap_allocations{0};
+
+constexpr size_t DECIDERS = 16; // Agents planned for per round
+
+// Alive agents with an enemy at most 3 cells away: the ones whose rollouts matter
+std::vector<size_t> contestedAgents(const game::GameState& state) {
+    std::vector<size_t> found;
+    for (size_t i = 0; i < state.agents.size() && found.size() < DECIDERS; ++i) {
+        const game::Agent& me = state.agents[i];
+        if (!me.is_alive) continue;
+        for (const game::Agent& other : state.agents) {
+            if (other.is_alive && other.team != me.team &&
+                std::abs(other.position.x - me.position.x) + std::abs(other.position.y - me.position.y) <= 3) {
+                found.push_back(i);
+                break;
+            }
+        }
+    }
+    return found;
+}
+
+struct Round {
+    std::vector<std::vector<agent::RolloutStats>> stats; // Per decider
+};
+
+Round planAll(const agent::RolloutPlanner& planner, const game::GameState& state, const std::vector<size_t>& deciders) {
+    Round round;
+    for (size_t i : deciders) round.stats.push_back(planner.evaluate(state, i, agent::RolloutPlanner::actions()));
+    return round;
+}
+
+bool sameStats(const Round& a, const Round& b) {
+    for (size_t d = 0; d < a.stats.size(); ++d) {
+        for (size_t c = 0; c < a.stats[d].size(); ++c) {
+            const agent::RolloutStats& x = a.stats[d][c];
+            const agent::RolloutStats& y = b.stats[d][c];
+            if (x.rollouts != y.rollouts || x.wins != y.wins || x.losses != y.losses || x.hp_delta != y.hp_delta) {
+                return false;
+            }
+        }
+    }
+    return a.stats.size() == b.stats.size();
+}
+
+// Heap allocations of one round on the caller alone
+uint64_t roundAllocations(const game::GameState& state, const std::vector<size_t>& deciders, int horizon) {
+    concurrency::ThreadPool serial(0);
+    agent::RolloutConfig config;
+    config.horizon = horizon;
+    agent::RolloutPlanner planner(serial, config);
+    uint64_t before = heap_allocations.load();
+    bench::doNotOptimize(planAll(planner, state, deciders));
+    return heap_allocations.load() - before;
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+// std::pmr::new_delete_resource goes through the aligned forms
+void* operator new(size_t size, std::align_val_t alignment) {
+    heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t align = static_cast<size_t>(alignment);
+    if (void* p = std::aligned_alloc(align, (size + align - 1) / align * align)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+int main() {
+    game::GameState state = bench::makeGameState(400, 40, 9);
+    std::vector<size_t> deciders = contestedAgents(state);
+    if (deciders.empty()) {
+        std::printf("FAIL: no agent has an enemy nearby\n");
+        return 1;
+    }
+    agent::RolloutConfig config; // 64 rollouts x 9 actions, 10 turns, 13x13 window
+    const double rollouts_per_round =
+        static_cast<double>(deciders.size()) * agent::RolloutPlanner::actions().size() * config.rollouts_per_action;
+
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> thread_counts;
+    for (size_t t = 1; t < cores; t *= 2) thread_counts.push_back(t);
+    thread_counts.push_back(cores);
+
+    char title[128];
+    std::snprintf(title, sizeof(title), "Rollouts for %zu agents of a 400-agent match, %zu cores", deciders.size(), cores);
+    bench::printHeader(title);
+    std::printf("%8s %14s %18s %12s %12s\n", "threads", "rollouts/s", "rollouts/s/core", "us/rollout", "efficiency");
+    double single_rate = 0;
+    for (size_t threads : thread_counts) {
+        concurrency::ThreadPool pool(threads - 1); // The caller of parallelFor works too
+        agent::RolloutPlanner planner(pool, config);
+        double round_ns = bench::measureNs([&] { bench::doNotOptimize(planAll(planner, state, deciders)); }, 1000.0);
+        double rate = rollouts_per_round / (round_ns / 1e9);
+        if (threads == 1) single_rate = rate;
+        std::printf("%8zu %14.0f %18.0f %12.2f %11.0f%%\n", threads, rate, rate / threads, 1e6 / rate,
+                    100.0 * rate / (single_rate * threads));
+    }
+
+    // Each task seeds its own generator from (seed, turn, agent, candidate, task),
+    // so scheduling cannot change the numbers
+    concurrency::ThreadPool serial(0);
+    concurrency::ThreadPool parallel(3);
+    Round expected = planAll(agent::RolloutPlanner(serial, config), state, deciders);
+    Round actual = planAll(agent::RolloutPlanner(parallel, config), state, deciders);
+
+    bench::printHeader("First decider, 64 rollouts per action");
+    std::printf("%-14s %8s %8s %12s %10s\n", "action", "win %", "loss %", "mean dHP", "value");
+    const std::vector<agent::RolloutStats>& first = expected.stats.front();
+    for (const agent::RolloutStats& s : first) {
+        std::printf("%-14s %7.1f%% %7.1f%% %+12.1f %+10.1f\n", std::string(agent::actionName(s.action)).c_str(),
+                    100 * s.winRate(), 100.0 * s.losses / s.rollouts, s.meanHpDelta(), s.value());
+    }
+    std::printf("best: %s\n", std::string(agent::actionName(first[agent::RolloutPlanner::best(first)].action)).c_str());
+
+    if (!sameStats(expected, actual)) {
+        std::printf("FAIL: 1 thread and 4 threads gave different statistics\n");
+        return 1;
+    }
+    std::printf("1 thread and 4 threads: identical statistics\n");
+
+    // The copies live in the thread's arena and resolveTurn works in another
+    // one, so twice the turns per rollout must not allocate once more
+    roundAllocations(state, deciders, 20); // The arenas reach their size
+    uint64_t short_round = roundAllocations(state, deciders, 10);
+    uint64_t long_round = roundAllocations(state, deciders, 20);
+    std::printf("heap allocations per round: %llu with 10 simulated turns, %llu with 20\n",
+                static_cast<unsigned long long>(short_round), static_cast<unsigned long long>(long_round));
+    if (long_round != short_round) {
+        std::printf("FAIL: simulated turns allocate on the heap\n");
+        return 1;
+    }
+
+    // With a rollout budget, an agent next to an enemy answers what plan() picks
+    agent::SimpleAgent brain;
+    const game::Agent& self = state.agents[deciders.front()];
+    brain.initialize(self.id, self.team);
+    brain.setRolloutBudget(config.rollouts_per_action, parallel);
+    game::SpatialGrid grid(state);
+    agent::SimpleAction chosen = brain.processTurn(state, grid);
+    agent::SimpleAction planned = agent::RolloutPlanner(serial, config).plan(state, deciders.front());
+    if (agent::actionName(chosen) != agent::actionName(planned)) {
+        std::printf("FAIL: the agent answered %s, the planner picks %s\n", std::string(agent::actionName(chosen)).c_str(),
+                    std::string(agent::actionName(planned)).c_str());
+        return 1;
+    }
+    std::printf("agent with a rollout budget answers the planner's action: %s\n",
+                std::string(agent::actionName(chosen)).c_str());
+    return 0;
+}
@@ -0,0 +1,123 @@
+// bench/roundtrip_bench.cpp
+// Measures request/response round trips over loopback TCP for the framing and socket options
+#include "bench/bench_util.h"
+#include "common/tcp_connection.h"
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+constexpr int PORT = 18461;
+
+// Previous framing: header and body in two separate send calls
+bool sendTwoCalls(net::TcpConnection& connection, const std::string& message) {
+    uint32_t length = htonl(message.length());
+    int fd = connection.getSocketFd();
+    return ::send(fd, &length, sizeof(length), MSG_NOSIGNAL) == sizeof(length) &&
+           ::send(fd, message.data(), message.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(message.size());
+}
+
+struct Result {
+    double p50_us;
+    double p99_us;
+};
+
+// Echo server: replies to every frame with the same payload
+void echoServer(net::TcpServer& server, bool no_delay, bool two_calls) {
+    auto connection = server.acceptConnection();
+    if (!connection) return;
+    connection->setNoDelay(no_delay);
+    while (connection->isConnected()) {
+        std::string message(connection->receiveFrame());
+        if (!connection->isConnected()) break;
+        if (two_calls) sendTwoCalls(*connection, message);
+        else connection->sendMessage(message);
+    }
+}
+
+Result pingPong(bool no_delay, bool two_calls, int rounds, size_t payload_size) {
+    net::TcpServer server(PORT);
+    server.start();
+    std::thread echo(echoServer, std::ref(server), no_delay, two_calls);
+
+    net::TcpConnection client;
+    client.connect("127.0.0.1", PORT);
+    client.setNoDelay(no_delay);
+
+    std::string payload(payload_size, 'x');
+    std::vector<double> samples;
+    for (int i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        if (two_calls) sendTwoCalls(client, payload);
+        else client.sendMessage(payload);
+        bench::doNotOptimize(client.receiveFrame());
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    client.disconnect();
+    echo.join();
+    server.stop();
+
+    std::sort(samples.begin(), samples.end());
+    return {samples[samples.size() / 2], samples[samples.size() * 99 / 100]};
+}
+
+// Sink server: counts frames until the peer disconnects
+void sinkServer(net::TcpServer& server, std::atomic<size_t>& frames) {
+    auto connection = server.acceptConnection();
+    if (!connection) return;
+    while (connection->isConnected()) {
+        connection->receiveFrame();
+        if (connection->isConnected()) frames++;
+    }
+}
+
+double framesPerSecond(bool batched, int batches, size_t batch_size) {
+    net::TcpServer server(PORT + 1);
+    server.start();
+    std::atomic<size_t> frames{0};
+    std::thread sink(sinkServer, std::ref(server), std::ref(frames));
+
+    net::TcpConnection client;
+    client.connect("127.0.0.1", PORT + 1);
+    client.setNoDelay(true);
+
+    std::vector<std::string> messages(batch_size, "{\"id\":\"7\",\"type\":\"receive_intel\",\"intel\":\"ENEMY:10,5\"}");
+    auto start = std::chrono::steady_clock::now();
+    for (int b = 0; b < batches; ++b) {
+        if (batched) {
+            client.sendBatch(messages);
+        } else {
+            for (const auto& message : messages) client.sendMessage(message);
+        }
+    }
+    client.disconnect();
+    sink.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    server.stop();
+    return frames.load() / seconds;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("play_turn sized round trip over loopback (30 KB request, 30 KB reply)");
+    std::printf("%-28s %10s %10s\n", "mode", "p50 us", "p99 us");
+    struct Mode { const char* name; bool no_delay; bool two_calls; int rounds; };
+    for (Mode mode : {Mode{"two sends, Nagle on", false, true, 40},
+                      Mode{"writev, Nagle on", false, false, 2000},
+                      Mode{"writev, TCP_NODELAY", true, false, 2000}}) {
+        Result result = pingPong(mode.no_delay, mode.two_calls, mode.rounds, 30000);
+        std::printf("%-28s %10.1f %10.1f\n", mode.name, result.p50_us, result.p99_us);
+    }
+
+    bench::printHeader("receive_intel fan-out to one connection (64 frames per team broadcast)");
+    double single = framesPerSecond(false, 2000, 64);
+    double batch = framesPerSecond(true, 2000, 64);
+    std::printf("sendMessage per frame: %12.0f frames/s\n", single);
+    std::printf("sendBatch:             %12.0f frames/s (%.1fx)\n", batch, batch / single);
+    return 0;
+}
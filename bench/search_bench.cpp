@@ -0,0 +1,197 @@
+// bench/search_bench.cpp
+// Anytime lookahead of SimpleAgent: search nodes/s and depth per budget, deadline overshoot,
+// and skirmishes of searching agents against the plain heuristic. Exits with 1 when a search
+// cut by its deadline answers something other than its last complete depth, or runs more
+// than CLOCK_STRIDE nodes past a deadline it should see at its first clock read. Overshoot
+// is wall time and only printed.
+#include "bench/bench_util.h"
+#include "common/game_rules.h"
+#include "common/spatial_grid.h"
+#include "logic/logic.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr int ARENA_MAP = 16;
+constexpr int ARENA_AGENTS = 12;
+constexpr int ARENA_TURNS = 100;
+constexpr int ARENA_MATCHES = 10; // Per side
+
+// Everybody alive at full health, so every agent decides and nobody flees at once
+game::GameState freshState(int agents, int map_size, uint32_t seed) {
+    game::GameState state = bench::makeGameState(agents, map_size, seed);
+    for (game::Agent& agent : state.agents) {
+        agent.hp = agent.max_hp;
+        agent.is_alive = true;
+    }
+    state.current_turn = 1;
+    return state;
+}
+
+struct BudgetResult {
+    double nodes_per_second;
+    double mean_depth;
+    double median_overshoot_us; // processTurn time beyond the budget
+    double max_overshoot_us;    // Includes time the process was descheduled
+    double timed_out_share;
+};
+
+BudgetResult measureBudget(std::chrono::microseconds budget, int decisions) {
+    game::GameState state = freshState(400, 40, 9); // Crowded: most agents have neighbours to search over
+    game::SpatialGrid grid(state);
+    std::vector<agent::SimpleAgent> brains(state.agents.size());
+    auto paths = std::make_shared<agent::PathCache>(); // Shared and warmed first: only the search is timed against the budget
+    paths->prepareTurn(state);
+    for (size_t i = 0; i < brains.size(); ++i) {
+        brains[i].initialize(state.agents[i].id, state.agents[i].team);
+        brains[i].setPathCache(paths);
+        bench::doNotOptimize(brains[i].processTurn(state, grid));
+    }
+    uint64_t nodes = 0;
+    double search_seconds = 0;
+    double depth = 0;
+    std::vector<double> overshoot;
+    int timed_out = 0;
+    for (int d = 0; d < decisions; ++d) {
+        size_t i = static_cast<size_t>(d) % brains.size();
+        brains[i].setSearchBudget(budget);
+        auto start = clock_type::now();
+        bench::doNotOptimize(brains[i].processTurn(state, grid));
+        double elapsed_us = std::chrono::duration<double, std::micro>(clock_type::now() - start).count();
+        const agent::SearchResult& search = brains[i].lastSearch();
+        nodes += search.nodes;
+        search_seconds += elapsed_us / 1e6;
+        depth += search.depth;
+        timed_out += search.timed_out;
+        overshoot.push_back(elapsed_us - static_cast<double>(budget.count()));
+    }
+    std::sort(overshoot.begin(), overshoot.end());
+    return {nodes / search_seconds, depth / decisions, overshoot[overshoot.size() / 2], overshoot.back(),
+            static_cast<double>(timed_out) / decisions};
+}
+
+struct CutoffCheck {
+    int cut = 0;     // Searches stopped by the deadline
+    int checked = 0; // Of those, with a complete depth to compare against
+    bool ok = true;
+};
+
+bool sameAction(const game::Action& a, const game::Action& b) {
+    return a.type == b.type && a.direction == b.direction;
+}
+
+// Whatever the scheduler does, a search cut by its deadline must answer what a
+// search limited to its last complete depth answers without a deadline, or
+// the heuristic if no depth completed. A deadline that has passed by the
+// first clock read, every CLOCK_STRIDE nodes, stops the search there.
+CutoffCheck checkCutoffs() {
+    game::GameState state = freshState(400, 40, 9);
+    game::SpatialGrid grid(state);
+    agent::AnytimeSearch search;
+    const game::Action heuristic(game::ActionType::defend, game::Direction::NORTH);
+    CutoffCheck check;
+    for (size_t i = 0; i < state.agents.size(); i += 4) {
+        for (int budget_us : {50, 200, 1000}) {
+            auto deadline = agent::SearchClock::now() + std::chrono::microseconds(budget_us);
+            agent::SearchResult result = search.search(state, grid, i, heuristic, nullptr, deadline);
+            if (!result.timed_out) continue;
+            check.cut++;
+            if (result.depth == 0) {
+                check.ok = check.ok && sameAction(result.action, heuristic);
+                continue;
+            }
+            agent::SearchResult full =
+                search.search(state, grid, i, heuristic, nullptr, agent::SearchClock::time_point::max(), result.depth);
+            check.checked++;
+            check.ok = check.ok && !full.timed_out && full.depth == result.depth &&
+                       sameAction(full.action, result.action) && full.score == result.score;
+        }
+        // 64 simulated turns take far longer than 1 us
+        auto deadline = agent::SearchClock::now() + std::chrono::microseconds(1);
+        agent::SearchResult result = search.search(state, grid, i, heuristic, nullptr, deadline);
+        check.ok = check.ok && result.nodes <= agent::AnytimeSearch::CLOCK_STRIDE;
+    }
+    return check;
+}
+
+struct MatchResult {
+    int search_wins = 0;
+    int heuristic_wins = 0;
+    int draws = 0;
+    long hp_margin = 0; // Searching side's HP minus the other's at the end, summed
+};
+
+// One match: the agents of search_team search with budget, the others use the heuristic
+void playMatch(uint32_t seed, std::string_view search_team, std::chrono::microseconds budget, MatchResult& result) {
+    game::GameState state = freshState(ARENA_AGENTS, ARENA_MAP, seed);
+    state.config.max_turns = ARENA_TURNS;
+    state.current_turn = 0;
+    std::vector<agent::SimpleAgent> brains(state.agents.size());
+    for (size_t i = 0; i < brains.size(); ++i) {
+        brains[i].initialize(state.agents[i].id, state.agents[i].team);
+        if (state.agents[i].team == search_team) brains[i].setSearchBudget(budget);
+    }
+
+    game::SpatialGrid grid;
+    std::vector<game::Action> actions;
+    while (!state.game_over && state.current_turn < state.config.max_turns) {
+        state.current_turn++;
+        grid.build(state);
+        actions.assign(state.agents.size(), game::Action());
+        for (size_t i = 0; i < state.agents.size(); ++i) {
+            if (state.agents[i].is_alive) actions[i] = game::parseAction(agent::actionToString(brains[i].processTurn(state, grid)));
+        }
+        game::resolveTurn(state, actions);
+        game::checkGameOver(state);
+    }
+
+    long margin = 0;
+    for (const game::Agent& agent : state.agents) {
+        if (agent.is_alive) margin += agent.team == search_team ? agent.hp : -agent.hp;
+    }
+    result.hp_margin += margin;
+    if (state.winner.empty()) result.draws++;
+    else if (state.winner == search_team) result.search_wins++;
+    else result.heuristic_wins++;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Anytime search per decision, 400 agents on a 40x40 map");
+    std::printf("%10s %14s %10s %16s %16s %10s\n", "budget", "nodes/s", "depth", "p50 overshoot", "max overshoot",
+                "cut off");
+    for (int budget_us : {200, 1000, 5000, 20000}) {
+        int decisions = std::max(20, 200000 / budget_us);
+        BudgetResult result = measureBudget(std::chrono::microseconds(budget_us), decisions);
+        std::printf("%8d us %14.0f %10.2f %13.1f us %13.1f us %9.0f%%\n", budget_us, result.nodes_per_second,
+                    result.mean_depth, result.median_overshoot_us, result.max_overshoot_us, result.timed_out_share * 100);
+    }
+    // The clock is read every 64 nodes, about 60 us of search. Both overshoots
+    // are wall time and include descheduling on a loaded machine: reported, not checked
+
+    CutoffCheck cutoffs = checkCutoffs();
+    std::printf("%d searches cut by the deadline, %d compared with their last complete depth: %s\n", cutoffs.cut,
+                cutoffs.checked, cutoffs.ok ? "same answers" : "DIFFERENT");
+
+    bench::printHeader("Skirmishes, 6 vs 6 on a 16x16 map, 10 seeds per side, searching side with 1 ms per decision");
+    MatchResult result;
+    for (uint32_t seed = 1; seed <= ARENA_MATCHES; ++seed) {
+        playMatch(seed, "red", std::chrono::microseconds(1000), result);
+        playMatch(seed, "blue", std::chrono::microseconds(1000), result);
+    }
+    std::printf("search wins %d, heuristic wins %d, draws %d, mean HP margin %+.1f\n", result.search_wins,
+                result.heuristic_wins, result.draws, static_cast<double>(result.hp_margin) / (2 * ARENA_MATCHES));
+
+    if (!cutoffs.ok) {
+        std::printf("FAIL: a search cut by its deadline did not answer its last complete depth\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,169 @@
+// bench/simd_bench.cpp
+// Batch squared-distance kernels (scalar, SSE4.1, AVX2) against the agent's previous
+// per-enemy sqrt(pow) scan, for 16 to 100k enemies, in the layout of Google Benchmark
+#include "bench/bench_util.h"
+#include "common/simd_distance.h"
+#include "common/spatial_grid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+
+namespace {
+
+constexpr int MAP = 1000;
+
+struct Enemies {
+    std::vector<game::Agent> agents; // The previous layout: scan with a team check
+    std::vector<int32_t> xs;
+    std::vector<int32_t> ys;
+};
+
+Enemies makeEnemies(size_t n, std::mt19937& rng) {
+    std::uniform_int_distribution<int> coord(0, MAP - 1);
+    Enemies enemies;
+    for (size_t i = 0; i < n; ++i) {
+        game::Position pos(coord(rng), coord(rng));
+        enemies.agents.emplace_back("blue_agent_" + std::to_string(i), "blue", pos);
+        enemies.xs.push_back(pos.x);
+        enemies.ys.push_back(pos.y);
+    }
+    return enemies;
+}
+
+// What findNearestEnemy did before the grid: one double sqrt(pow) per enemy
+int64_t legacyNearest(const std::vector<game::Agent>& agents, const game::Position& from) {
+    int64_t nearest = -1;
+    double best = 0;
+    for (size_t i = 0; i < agents.size(); ++i) {
+        const game::Agent& other = agents[i];
+        if (!other.is_alive || other.team == "red") continue;
+        double d = std::sqrt(std::pow(other.position.x - from.x, 2) + std::pow(other.position.y - from.y, 2));
+        if (nearest < 0 || d < best) {
+            best = d;
+            nearest = static_cast<int64_t>(i);
+        }
+    }
+    return nearest;
+}
+
+void report(const std::string& name, size_t n, double ns) {
+    std::printf("%-36s %12.1f ns %14.3fM items/s\n", (name + "/" + std::to_string(n)).c_str(), ns,
+                static_cast<double>(n) / ns * 1e3);
+}
+
+// The hybrid grid queries against a brute-force scan over state.agents
+bool checkGrid(int agents, int map, uint32_t seed) {
+    game::GameState state = bench::makeGameState(agents, map, seed);
+    game::SpatialGrid grid(state);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> coord(0, map - 1);
+    for (int q = 0; q < 200; ++q) {
+        game::Position from(coord(rng), coord(rng));
+        int expected = -1;
+        int64_t best = 0;
+        std::vector<int> in_radius;
+        for (size_t i = 0; i < state.agents.size(); ++i) {
+            const game::Agent& other = state.agents[i];
+            if (!other.is_alive || other.team == "red") continue;
+            int64_t dx = other.position.x - from.x, dy = other.position.y - from.y;
+            int64_t d = dx * dx + dy * dy;
+            if (expected < 0 || d < best) {
+                expected = static_cast<int>(i);
+                best = d;
+            }
+            if (d <= 1) in_radius.push_back(static_cast<int>(i));
+        }
+        std::vector<int> found = grid.enemiesInRadius(from, "red", 1);
+        std::sort(found.begin(), found.end());
+        if (grid.nearestEnemy(from, "red") != expected || found != in_radius) {
+            std::printf("grid query differs from a linear scan: %d agents, map %d, query %d\n", agents, map, q);
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Nearest enemy and in-range filter over packed int32 coordinates");
+    std::printf("best level on this CPU: %s\n\n", game::simdLevelName(game::bestSimdLevel()));
+    std::printf("%-36s %15s %24s\n", "Benchmark", "Time", "Throughput");
+
+    const game::SimdLevel levels[] = {game::SimdLevel::scalar, game::SimdLevel::sse41, game::SimdLevel::avx2};
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> coord(0, MAP - 1);
+
+    for (size_t n : {16, 64, 256, 1024, 4096, 16384, 100000}) {
+        Enemies enemies = makeEnemies(n, rng);
+        std::vector<game::Position> queries;
+        for (int q = 0; q < 64; ++q) queries.emplace_back(coord(rng), coord(rng));
+
+        // Every level must pick the same enemy as the legacy scan (ties: first index)
+        for (const game::Position& from : queries) {
+            int64_t expected = legacyNearest(enemies.agents, from);
+            for (game::SimdLevel level : levels) {
+                game::NearestPoint got = game::nearestSquared(enemies.xs.data(), enemies.ys.data(), n, from.x, from.y,
+                                                              level);
+                if (got.index != expected) {
+                    std::printf("%s picked %lld, expected %lld (n=%zu)\n", game::simdLevelName(level),
+                                static_cast<long long>(got.index), static_cast<long long>(expected), n);
+                    return 1;
+                }
+            }
+        }
+
+        size_t next = 0;
+        report("BM_NearestLegacySqrtPow", n, bench::measureNs([&] {
+            bench::doNotOptimize(legacyNearest(enemies.agents, queries[next++ % queries.size()]));
+        }, 50));
+        for (game::SimdLevel level : levels) {
+            report(std::string("BM_Nearest<") + game::simdLevelName(level) + ">", n, bench::measureNs([&] {
+                const game::Position& from = queries[next++ % queries.size()];
+                bench::doNotOptimize(
+                    game::nearestSquared(enemies.xs.data(), enemies.ys.data(), n, from.x, from.y, level));
+            }, 50));
+        }
+
+        // In-range filter with the attack radius used by the agent
+        std::vector<uint32_t> out(n);
+        size_t reference = game::withinRange(enemies.xs.data(), enemies.ys.data(), n, queries[0].x, queries[0].y, 1,
+                                             out.data(), game::SimdLevel::scalar);
+        for (game::SimdLevel level : levels) {
+            if (game::withinRange(enemies.xs.data(), enemies.ys.data(), n, queries[0].x, queries[0].y, 1, out.data(),
+                                  level) != reference) {
+                std::printf("%s range filter disagrees with scalar (n=%zu)\n", game::simdLevelName(level), n);
+                return 1;
+            }
+            report(std::string("BM_WithinRange<") + game::simdLevelName(level) + ">", n, bench::measureNs([&] {
+                const game::Position& from = queries[next++ % queries.size()];
+                bench::doNotOptimize(
+                    game::withinRange(enemies.xs.data(), enemies.ys.data(), n, from.x, from.y, 1, out.data(), level));
+            }, 50));
+        }
+        std::printf("\n");
+    }
+
+    // The grid switches between ring walks and packed scans; both must match brute force
+    for (int agents : {8, 40, 400, 4000}) {
+        for (int map : {20, 200}) {
+            if (!checkGrid(agents, map, static_cast<uint32_t>(agents + map))) return 1;
+        }
+    }
+
+    std::printf("%-36s %15s\n", "grid nearestEnemy (200x200 map)", "Time");
+    for (int agents : {16, 64, 256, 1024, 4096, 16384}) {
+        game::GameState state = bench::makeGameState(agents, 200);
+        game::SpatialGrid grid(state);
+        size_t next = 0;
+        std::vector<game::Position> queries;
+        for (int q = 0; q < 64; ++q) queries.emplace_back(coord(rng) % 200, coord(rng) % 200);
+        double ns = bench::measureNs([&] {
+            bench::doNotOptimize(grid.nearestEnemy(queries[next++ % queries.size()], "red"));
+        }, 50);
+        std::printf("%-36s %12.1f ns\n", ("BM_GridNearest/" + std::to_string(agents)).c_str(), ns);
+    }
+    return 0;
+}
@@ -0,0 +1,193 @@
+// bench/soa_bench.cpp
+// The per-agent scans of logic.cpp over the AoS GameState against GameStateSoA,
+// plus the cost of deserializing straight into the SoA layout
+#include "bench/bench_util.h"
+#include "common/game_state_soa.h"
+#include "common/rpc_protocol.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+namespace {
+
+struct ScanResult {
+    size_t self;
+    size_t enemies;
+    size_t nearest;
+    int free_cells;
+
+    bool operator==(const ScanResult& other) const {
+        return self == other.self && enemies == other.enemies && nearest == other.nearest &&
+               free_cells == other.free_cells;
+    }
+};
+
+const game::Position STEPS[] = {{0, -1}, {0, 1}, {1, 0}, {-1, 0}};
+
+// updateSelfState, updateMemory, findNearestEnemy and isValidPosition as
+// SimpleAgent writes them over GameState::agents
+ScanResult scanAoS(const game::GameState& state, std::string_view agent_id, std::string_view team,
+                   std::vector<game::Position>& enemies) {
+    ScanResult result{};
+    game::Position self;
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        if (state.agents[i].id == agent_id) {
+            result.self = i;
+            self = state.agents[i].position;
+            break;
+        }
+    }
+
+    enemies.clear();
+    for (const game::Agent& agent : state.agents) {
+        if (agent.is_alive && agent.team != team) enemies.push_back(agent.position);
+    }
+    result.enemies = enemies.size();
+
+    double best = -1;
+    for (size_t i = 0; i < enemies.size(); ++i) {
+        double d = std::sqrt(std::pow(enemies[i].x - self.x, 2) + std::pow(enemies[i].y - self.y, 2));
+        if (best < 0 || d < best) {
+            best = d;
+            result.nearest = i;
+        }
+    }
+
+    for (const game::Position& step : STEPS) {
+        game::Position pos(self.x + step.x, self.y + step.y);
+        bool free = true;
+        for (const game::Agent& agent : state.agents) {
+            if (agent.is_alive && agent.position == pos) {
+                free = false;
+                break;
+            }
+        }
+        result.free_cells += free;
+    }
+    return result;
+}
+
+// The same scans over the SoA arrays, with interned ids
+ScanResult scanSoA(const game::GameStateSoA& state, uint32_t agent_id, uint16_t team,
+                   std::vector<int32_t>& enemy_x, std::vector<int32_t>& enemy_y) {
+    ScanResult result{};
+    const size_t count = state.agentCount();
+    for (size_t i = 0; i < count; ++i) {
+        if (state.agent_id[i] == agent_id) {
+            result.self = i;
+            break;
+        }
+    }
+    const int32_t sx = state.x[result.self];
+    const int32_t sy = state.y[result.self];
+
+    // Branch-free compaction: every slot is written, only enemies advance.
+    // The alive bitset is consumed a word at a time.
+    enemy_x.resize(count);
+    enemy_y.resize(count);
+    size_t enemies = 0;
+    for (size_t word = 0; word * 64 < count; ++word) {
+        uint64_t alive = state.alive_bits[word];
+        size_t end = std::min(count, word * 64 + 64);
+        for (size_t i = word * 64; i < end; ++i, alive >>= 1) {
+            enemy_x[enemies] = state.x[i];
+            enemy_y[enemies] = state.y[i];
+            enemies += (alive & 1) & (state.team_id[i] != team);
+        }
+    }
+    enemy_x.resize(enemies);
+    enemy_y.resize(enemies);
+    result.enemies = enemies;
+
+    // Argmin in two vectorizable passes: the minimum, then its first index
+    // (squared distances fit in 32 bits for any map below 32768 cells a side)
+    int32_t best = INT32_MAX;
+    for (size_t i = 0; i < enemies; ++i) {
+        int32_t dx = enemy_x[i] - sx;
+        int32_t dy = enemy_y[i] - sy;
+        best = std::min(best, dx * dx + dy * dy);
+    }
+    for (size_t i = 0; i < enemies; ++i) {
+        int32_t dx = enemy_x[i] - sx;
+        int32_t dy = enemy_y[i] - sy;
+        if (dx * dx + dy * dy == best) {
+            result.nearest = i;
+            break;
+        }
+    }
+
+    // The four neighbours in one pass over the position arrays: a bit per
+    // occupied neighbour (north, south, east, west)
+    unsigned occupied = 0;
+    for (size_t i = 0; i < count; ++i) {
+        int32_t dx = state.x[i] - sx;
+        int32_t dy = state.y[i] - sy;
+        if (__builtin_expect(std::abs(dx) + std::abs(dy) == 1, 0) && state.alive(i)) {
+            occupied |= dx == 0 ? (dy < 0 ? 1 : 2) : (dx > 0 ? 4 : 8);
+        }
+    }
+    result.free_cells = 4 - __builtin_popcount(occupied);
+    return result;
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("logic.cpp scans for one agent: AoS GameState vs GameStateSoA (200x200 map)");
+    std::printf("%8s %12s %12s %9s %12s %12s %12s\n", "agents", "AoS scan", "SoA scan", "speedup", "AoS parse",
+                "SoA parse", "SoA reparse");
+
+    for (int agents : {10, 100, 1000, 10000, 50000}) {
+        game::GameState state = bench::makeGameState(agents, 200);
+        game::GameStateSoA soa;
+        game::toSoA(state, soa);
+
+        // Round trip through both layouts
+        game::GameState back;
+        game::toAoS(soa, back);
+        if (rpc::serializeGameState(back) != rpc::serializeGameState(state)) {
+            std::printf("AoS -> SoA -> AoS changed the state for %d agents\n", agents);
+            return 1;
+        }
+
+        // Scans from the point of view of the last agent, the worst case for the id lookup
+        const game::Agent& self = state.agents.back();
+        uint32_t self_id = soa.ids.find(self.id);
+        uint16_t self_team = static_cast<uint16_t>(soa.teams.find(self.team));
+        std::vector<game::Position> enemies;
+        std::vector<int32_t> enemy_x, enemy_y;
+        if (!(scanAoS(state, self.id, self.team, enemies) == scanSoA(soa, self_id, self_team, enemy_x, enemy_y))) {
+            std::printf("AoS and SoA scans disagree for %d agents\n", agents);
+            return 1;
+        }
+
+        double aos = bench::measureNs([&] {
+            bench::doNotOptimize(scanAoS(state, self.id, self.team, enemies));
+        }, 100);
+        double soa_scan = bench::measureNs([&] {
+            bench::doNotOptimize(scanSoA(soa, self_id, self_team, enemy_x, enemy_y));
+        }, 100);
+
+        // Parsing: a fresh SoA interns every name, a reused one only looks them up
+        std::string json = rpc::serializeGameState(state);
+        double aos_parse = bench::measureNs([&] {
+            bench::doNotOptimize(rpc::deserializeGameState(json));
+        }, 100);
+        double soa_parse = bench::measureNs([&] {
+            game::GameStateSoA fresh;
+            rpc::deserializeGameState(json, fresh);
+            bench::doNotOptimize(fresh);
+        }, 100);
+        game::GameStateSoA reused;
+        double soa_reparse = bench::measureNs([&] {
+            rpc::deserializeGameState(json, reused);
+            bench::doNotOptimize(reused);
+        }, 100);
+
+        std::printf("%8d %10.1fus %10.1fus %8.1fx %10.1fus %10.1fus %10.1fus\n", agents, aos / 1e3, soa_scan / 1e3,
+                    aos / soa_scan, aos_parse / 1e3, soa_parse / 1e3, soa_reparse / 1e3);
+    }
+    return 0;
+}
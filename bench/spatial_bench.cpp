@@ -0,0 +1,119 @@
+// bench/spatial_bench.cpp
+// Per-turn cost of the agent's neighbourhood queries: linear scans over state.agents
+// (what SimpleAgent did before) against the SpatialGrid built once per turn
+#include "bench/bench_util.h"
+#include "common/spatial_grid.h"
+#include "logic/logic.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+const game::Position STEPS[] = {{0, -1}, {0, 1}, {1, 0}, {-1, 0}};
+
+// The previous SimpleAgent queries: occupancy of the four neighbours,
+// adjacent enemy and nearest enemy, each a scan over every agent
+int linearQueries(const game::GameState& state, const game::Agent& self) {
+    int result = 0;
+    for (const game::Position& step : STEPS) {
+        game::Position pos(self.position.x + step.x, self.position.y + step.y);
+        bool free = true;
+        for (const game::Agent& other : state.agents) {
+            if (other.is_alive && other.position == pos) {
+                free = false;
+                break;
+            }
+        }
+        result += free;
+    }
+    int nearest = -1;
+    double best = 0;
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        const game::Agent& other = state.agents[i];
+        if (!other.is_alive || other.team == self.team) continue;
+        double d = std::sqrt(std::pow(other.position.x - self.position.x, 2) +
+                             std::pow(other.position.y - self.position.y, 2));
+        if (d <= 1) result++;
+        if (nearest < 0 || d < best) {
+            best = d;
+            nearest = static_cast<int>(i);
+        }
+    }
+    return result + nearest;
+}
+
+int gridQueries(const game::SpatialGrid& grid, const game::Agent& self) {
+    int result = 0;
+    for (const game::Position& step : STEPS) {
+        result += !grid.occupied(game::Position(self.position.x + step.x, self.position.y + step.y));
+    }
+    result += static_cast<int>(grid.enemiesInRadius(self.position, self.team, 1).size());
+    return result + grid.nearestEnemy(self.position, self.team);
+}
+
+} // namespace
+
+int main() {
+    bench::printHeader("Neighbourhood queries for every agent of one turn (map side 4*sqrt(agents))");
+    std::printf("%8s %6s %12s %12s %12s %9s %14s %14s\n", "agents", "map", "linear", "grid build", "grid total",
+                "speedup", "processTurn", "healthy turn");
+
+    for (int agents : {10, 100, 500, 1000, 5000, 10000}) {
+        int map = std::max(20, static_cast<int>(4 * std::sqrt(agents)));
+        game::GameState state = bench::makeGameState(agents, map);
+        game::SpatialGrid grid(state);
+
+        // Both must find the same nearest enemy
+        for (const game::Agent& self : state.agents) {
+            if (linearQueries(state, self) != gridQueries(grid, self)) {
+                std::printf("grid and linear scan disagree for %d agents\n", agents);
+                return 1;
+            }
+        }
+
+        double min_ms = agents >= 5000 ? 500 : 100;
+        double linear = bench::measureNs([&] {
+            int sum = 0;
+            for (const game::Agent& self : state.agents) sum += linearQueries(state, self);
+            bench::doNotOptimize(sum);
+        }, min_ms);
+        double build = bench::measureNs([&] {
+            game::SpatialGrid fresh(state);
+            bench::doNotOptimize(fresh);
+        }, min_ms);
+        double total = bench::measureNs([&] {
+            game::SpatialGrid fresh(state);
+            int sum = 0;
+            for (const game::Agent& self : state.agents) sum += gridQueries(fresh, self);
+            bench::doNotOptimize(sum);
+        }, min_ms);
+
+        // Whole decision of every agent, sharing one grid, one path cache and one
+        // influence map as a multi-agent host would. Only agents with low health read
+        // the influence map, so the turn is also timed with everybody healthy.
+        auto shared = std::make_shared<agent::PathCache>();
+        auto influence = std::make_shared<agent::InfluenceMap>();
+        std::vector<agent::SimpleAgent> brains(state.agents.size());
+        for (size_t i = 0; i < brains.size(); ++i) {
+            brains[i].initialize(state.agents[i].id, state.agents[i].team);
+            brains[i].setPathCache(shared);
+            brains[i].setInfluenceMap(influence);
+        }
+        auto timeTurn = [&](const game::GameState& turn_state) {
+            return bench::measureNs([&] {
+                game::SpatialGrid fresh(turn_state);
+                influence->update(turn_state); // By the owner, before the agents decide
+                for (agent::SimpleAgent& brain : brains) bench::doNotOptimize(brain.processTurn(turn_state, fresh));
+            }, min_ms);
+        };
+        double turn = timeTurn(state);
+        game::GameState healthy = state;
+        for (game::Agent& agent : healthy.agents) agent.hp = agent.max_hp;
+        double healthy_turn = timeTurn(healthy);
+
+        std::printf("%8d %6d %10.1fus %10.1fus %10.1fus %8.1fx %12.1fus %12.1fus\n", agents, map, linear / 1e3,
+                    build / 1e3, total / 1e3, linear / total, turn / 1e3, healthy_turn / 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+// bench/wire_bench.cpp
+// Bytes on the wire and encode/decode time of the play_turn state: JSON against the binary encoding
+#include "bench/bench_util.h"
+#include "common/binary_codec.h"
+#include "common/rpc_protocol.h"
+#include <cstdio>
+
+int main() {
+    bench::printHeader("play_turn state: JSON vs binary (200x200 map)");
+    std::printf("%8s %10s %10s %7s %11s %11s %11s %11s\n", "agents", "json B", "binary B", "ratio",
+                "json enc", "bin enc", "json dec", "bin dec");
+
+    for (int agents : {10, 100, 500, 1000, 5000, 10000}) {
+        game::GameState state = bench::makeGameState(agents, 200);
+
+        std::string json = rpc::serializeGameState(state);
+        std::string binary;
+        rpc::encodeGameState(state, binary);
+
+        // Round trip check
+        game::GameState decoded;
+        rpc::BinaryReader reader(binary);
+        if (!rpc::decodeGameState(reader, decoded) || decoded.agents.size() != state.agents.size() ||
+            decoded.agents.back().id != state.agents.back().id ||
+            !(decoded.agents.back().position == state.agents.back().position)) {
+            std::printf("binary round trip failed for %d agents\n", agents);
+            return 1;
+        }
+
+        double json_encode = bench::measureNs([&] {
+            std::string out;
+            rpc::serializeGameState(state, out);
+            bench::doNotOptimize(out);
+        }, 100);
+        double binary_encode = bench::measureNs([&] {
+            std::string out;
+            rpc::encodeGameState(state, out);
+            bench::doNotOptimize(out);
+        }, 100);
+        double json_decode = bench::measureNs([&] {
+            bench::doNotOptimize(rpc::deserializeGameState(json));
+        }, 100);
+        double binary_decode = bench::measureNs([&] {
+            game::GameState out;
+            rpc::BinaryReader in(binary);
+            rpc::decodeGameState(in, out);
+            bench::doNotOptimize(out);
+        }, 100);
+
+        std::printf("%8d %10zu %10zu %6.1fx %9.1fus %9.1fus %9.1fus %9.1fus\n", agents, json.size(),
+                    binary.size(), static_cast<double>(json.size()) / binary.size(),
+                    json_encode / 1e3, binary_encode / 1e3, json_decode / 1e3, binary_decode / 1e3);
+    }
+    return 0;
+}
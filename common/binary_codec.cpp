@@ -0,0 +1,346 @@
+// common/binary_codec.cpp
+// Implements the compact binary encoding of play_turn
+#include "binary_codec.h"
+#include <vector>
+
+namespace rpc {
+
+namespace {
+
+// Index of team in teams, appended when first seen
+uint64_t internTeam(std::vector<std::string_view>& teams, std::string_view team) {
+    for (size_t i = 0; i < teams.size(); ++i) {
+        if (teams[i] == team) return i;
+    }
+    teams.push_back(team);
+    return teams.size() - 1;
+}
+
+} // namespace
+
+void encodeGameState(const game::GameState& state, std::string& out) {
+    BinaryWriter writer(out);
+
+    // Team table: a match has a handful of teams, a linear search is enough
+    std::vector<std::string_view> teams;
+    for (const game::Agent& agent : state.agents) internTeam(teams, agent.team);
+    for (const game::Base& base : state.bases) internTeam(teams, base.team);
+
+    writer.varint(state.current_turn);
+    writer.byte(state.game_over ? 1 : 0);
+    writer.string(state.winner);
+    writer.varint(state.config.map_width);
+    writer.varint(state.config.map_height);
+    writer.varint(state.config.max_turns);
+
+    writer.varint(teams.size());
+    for (std::string_view team : teams) writer.string(team);
+
+    writer.varint(state.agents.size());
+    for (const game::Agent& agent : state.agents) {
+        writer.string(agent.id);
+        writer.varint(internTeam(teams, agent.team));
+        writer.zigzag(agent.position.x);
+        writer.zigzag(agent.position.y);
+        writer.byte(static_cast<uint8_t>(agent.facing) | (agent.is_alive ? 0x04 : 0));
+        writer.zigzag(agent.hp);
+        writer.zigzag(agent.max_hp);
+    }
+
+    writer.varint(state.bases.size());
+    for (const game::Base& base : state.bases) {
+        writer.varint(internTeam(teams, base.team));
+        writer.zigzag(base.position.x);
+        writer.zigzag(base.position.y);
+        writer.zigzag(base.hp);
+        writer.zigzag(base.max_hp);
+        writer.byte(base.is_destroyed ? 1 : 0);
+    }
+}
+
+bool decodeGameState(BinaryReader& reader, game::GameState& state) {
+    state.current_turn = static_cast<int>(reader.varint());
+    state.game_over = reader.byte() != 0;
+    state.winner = reader.string();
+    state.config.map_width = static_cast<int>(reader.varint());
+    state.config.map_height = static_cast<int>(reader.varint());
+    state.config.max_turns = static_cast<int>(reader.varint());
+
+    std::vector<std::string_view> teams(reader.varint());
+    if (!reader.ok() || teams.size() > reader.remaining()) return false;
+    for (std::string_view& team : teams) team = reader.string();
+    auto teamAt = [&teams, &reader](uint64_t index) {
+        if (index >= teams.size()) {
+            return std::string_view();
+        }
+        return teams[index];
+    };
+
+    uint64_t agent_count = reader.varint();
+    if (!reader.ok() || agent_count > reader.remaining()) return false; // Every agent takes bytes
+    state.agents.clear();
+    state.agents.reserve(agent_count);
+    for (uint64_t i = 0; i < agent_count && reader.ok(); ++i) {
+        std::string_view id = reader.string();
+        std::string_view team = teamAt(reader.varint());
+        state.agents.emplace_back(std::string(id), std::string(team), game::Position(0, 0), 0);
+        game::Agent& agent = state.agents.back();
+        agent.position.x = static_cast<int>(reader.zigzag());
+        agent.position.y = static_cast<int>(reader.zigzag());
+        uint8_t flags = reader.byte();
+        agent.facing = static_cast<game::Direction>(flags & 0x03);
+        agent.is_alive = (flags & 0x04) != 0;
+        agent.hp = static_cast<int>(reader.zigzag());
+        agent.max_hp = static_cast<int>(reader.zigzag());
+    }
+
+    uint64_t base_count = reader.varint();
+    if (!reader.ok() || base_count > reader.remaining()) return false;
+    state.bases.clear();
+    state.bases.reserve(base_count);
+    for (uint64_t i = 0; i < base_count && reader.ok(); ++i) {
+        std::string_view team = teamAt(reader.varint());
+        state.bases.emplace_back(std::string(team), game::Position(0, 0), 0);
+        game::Base& base = state.bases.back();
+        base.position.x = static_cast<int>(reader.zigzag());
+        base.position.y = static_cast<int>(reader.zigzag());
+        base.hp = static_cast<int>(reader.zigzag());
+        base.max_hp = static_cast<int>(reader.zigzag());
+        base.is_destroyed = reader.byte() != 0;
+    }
+    return reader.ok();
+}
+
+std::string binary_play_turn_request(const std::string& id, const std::string& agent_id,
+                                     const std::string& encoded_state) {
+    std::string frame;
+    frame.reserve(2 + id.size() + agent_id.size() + 4 + encoded_state.size());
+    BinaryWriter writer(frame);
+    writer.byte(BINARY_PLAY_TURN);
+    writer.byte(BINARY_VERSION);
+    writer.string(id);
+    writer.string(agent_id);
+    writer.raw(encoded_state);
+    return frame;
+}
+
+bool decodePlayTurn(std::string_view frame, std::string& id, std::string& agent_id, game::GameState& state) {
+    BinaryReader reader(frame);
+    if (reader.byte() != BINARY_PLAY_TURN || reader.byte() != BINARY_VERSION) return false;
+    id = reader.string();
+    agent_id = reader.string();
+    return reader.ok() && decodeGameState(reader, state);
+}
+
+// Delta mode
+
+namespace {
+
+// Bits of the per-entry change mask
+constexpr uint8_t CHANGED_POSITION = 0x01;
+constexpr uint8_t CHANGED_FACING = 0x02;
+constexpr uint8_t CHANGED_HP = 0x04;
+constexpr uint8_t CHANGED_MAX_HP = 0x08;
+constexpr uint8_t CHANGED_FLAG = 0x10; // is_alive / is_destroyed
+
+// FNV-1a over 64-bit words instead of bytes: one multiply per word keeps the
+// checksum well below the cost of the delta itself
+struct Fnv1a {
+    uint64_t hash = 1469598103934665603ULL;
+
+    void add(uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    }
+};
+
+// Position, facing and flag of one entry packed into a word
+uint64_t packEntry(const game::Position& position, uint64_t small, bool flag) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(position.x)) & 0xFFFFFF) |
+           ((static_cast<uint64_t>(static_cast<uint32_t>(position.y)) & 0xFFFFFF) << 24) |
+           ((small & 0x7F) << 48) | (static_cast<uint64_t>(flag) << 55);
+}
+
+uint64_t packHp(int hp, int max_hp) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(hp)) |
+           (static_cast<uint64_t>(static_cast<uint32_t>(max_hp)) << 32);
+}
+
+} // namespace
+
+uint64_t checksumGameState(const game::GameState& state) {
+    Fnv1a fnv;
+    fnv.add(static_cast<uint64_t>(state.current_turn));
+    fnv.add(state.game_over);
+    fnv.add(state.agents.size());
+    for (const game::Agent& agent : state.agents) {
+        fnv.add(packEntry(agent.position, static_cast<uint64_t>(agent.facing), agent.is_alive));
+        fnv.add(packHp(agent.hp, agent.max_hp));
+    }
+    fnv.add(state.bases.size());
+    for (const game::Base& base : state.bases) {
+        fnv.add(packEntry(base.position, 0, base.is_destroyed));
+        fnv.add(packHp(base.hp, base.max_hp));
+    }
+    return fnv.hash;
+}
+
+bool encodeGameStateDelta(const game::GameState& previous, const game::GameState& current, std::string& out) {
+    if (previous.agents.size() != current.agents.size() || previous.bases.size() != current.bases.size()) {
+        return false;
+    }
+    BinaryWriter writer(out);
+    writer.varint(previous.current_turn); // Base turn
+    writer.varint(current.current_turn);
+    writer.byte(current.game_over ? 1 : 0);
+    writer.string(current.winner);
+
+    // Agents: count of changed entries is not known up front, so they are
+    // written to a scratch buffer first
+    std::string changes;
+    BinaryWriter change_writer(changes);
+    uint64_t changed = 0;
+    for (size_t i = 0; i < current.agents.size(); ++i) {
+        const game::Agent& before = previous.agents[i];
+        const game::Agent& after = current.agents[i];
+        uint8_t mask = 0;
+        if (!(before.position == after.position)) mask |= CHANGED_POSITION;
+        if (before.facing != after.facing) mask |= CHANGED_FACING;
+        if (before.hp != after.hp) mask |= CHANGED_HP;
+        if (before.max_hp != after.max_hp) mask |= CHANGED_MAX_HP;
+        if (before.is_alive != after.is_alive) mask |= CHANGED_FLAG;
+        if (mask == 0) continue;
+
+        changed++;
+        change_writer.varint(i);
+        change_writer.byte(mask);
+        if (mask & CHANGED_POSITION) {
+            change_writer.zigzag(after.position.x - before.position.x);
+            change_writer.zigzag(after.position.y - before.position.y);
+        }
+        if (mask & CHANGED_FACING) change_writer.byte(static_cast<uint8_t>(after.facing));
+        if (mask & CHANGED_HP) change_writer.zigzag(after.hp);
+        if (mask & CHANGED_MAX_HP) change_writer.zigzag(after.max_hp);
+        if (mask & CHANGED_FLAG) change_writer.byte(after.is_alive ? 1 : 0);
+    }
+    writer.varint(changed);
+    writer.raw(changes);
+
+    changes.clear();
+    changed = 0;
+    for (size_t i = 0; i < current.bases.size(); ++i) {
+        const game::Base& before = previous.bases[i];
+        const game::Base& after = current.bases[i];
+        uint8_t mask = 0;
+        if (!(before.position == after.position)) mask |= CHANGED_POSITION;
+        if (before.hp != after.hp) mask |= CHANGED_HP;
+        if (before.max_hp != after.max_hp) mask |= CHANGED_MAX_HP;
+        if (before.is_destroyed != after.is_destroyed) mask |= CHANGED_FLAG;
+        if (mask == 0) continue;
+
+        changed++;
+        change_writer.varint(i);
+        change_writer.byte(mask);
+        if (mask & CHANGED_POSITION) {
+            change_writer.zigzag(after.position.x);
+            change_writer.zigzag(after.position.y);
+        }
+        if (mask & CHANGED_HP) change_writer.zigzag(after.hp);
+        if (mask & CHANGED_MAX_HP) change_writer.zigzag(after.max_hp);
+        if (mask & CHANGED_FLAG) change_writer.byte(after.is_destroyed ? 1 : 0);
+    }
+    writer.varint(changed);
+    writer.raw(changes);
+
+    writer.varint(checksumGameState(current));
+    return true;
+}
+
+bool applyGameStateDelta(BinaryReader& reader, game::GameState& cached) {
+    uint64_t base_turn = reader.varint();
+    if (!reader.ok() || base_turn != static_cast<uint64_t>(cached.current_turn)) return false;
+
+    cached.current_turn = static_cast<int>(reader.varint());
+    cached.game_over = reader.byte() != 0;
+    cached.winner = reader.string();
+
+    uint64_t changed_agents = reader.varint();
+    for (uint64_t n = 0; n < changed_agents && reader.ok(); ++n) {
+        uint64_t index = reader.varint();
+        if (index >= cached.agents.size()) return false;
+        game::Agent& agent = cached.agents[index];
+        uint8_t mask = reader.byte();
+        if (mask & CHANGED_POSITION) {
+            agent.position.x += static_cast<int>(reader.zigzag());
+            agent.position.y += static_cast<int>(reader.zigzag());
+        }
+        if (mask & CHANGED_FACING) agent.facing = static_cast<game::Direction>(reader.byte() & 0x03);
+        if (mask & CHANGED_HP) agent.hp = static_cast<int>(reader.zigzag());
+        if (mask & CHANGED_MAX_HP) agent.max_hp = static_cast<int>(reader.zigzag());
+        if (mask & CHANGED_FLAG) agent.is_alive = reader.byte() != 0;
+    }
+
+    uint64_t changed_bases = reader.varint();
+    for (uint64_t n = 0; n < changed_bases && reader.ok(); ++n) {
+        uint64_t index = reader.varint();
+        if (index >= cached.bases.size()) return false;
+        game::Base& base = cached.bases[index];
+        uint8_t mask = reader.byte();
+        if (mask & CHANGED_POSITION) {
+            base.position.x = static_cast<int>(reader.zigzag());
+            base.position.y = static_cast<int>(reader.zigzag());
+        }
+        if (mask & CHANGED_HP) base.hp = static_cast<int>(reader.zigzag());
+        if (mask & CHANGED_MAX_HP) base.max_hp = static_cast<int>(reader.zigzag());
+        if (mask & CHANGED_FLAG) base.is_destroyed = reader.byte() != 0;
+    }
+
+    uint64_t checksum = reader.varint();
+    return reader.ok() && checksum == checksumGameState(cached);
+}
+
+std::string binary_play_turn_delta_request(const std::string& id, const std::string& agent_id,
+                                           const std::string& encoded_delta) {
+    std::string frame;
+    frame.reserve(2 + id.size() + agent_id.size() + 4 + encoded_delta.size());
+    BinaryWriter writer(frame);
+    writer.byte(BINARY_PLAY_TURN_DELTA);
+    writer.byte(BINARY_VERSION);
+    writer.string(id);
+    writer.string(agent_id);
+    writer.raw(encoded_delta);
+    return frame;
+}
+
+bool decodePlayTurnDelta(std::string_view frame, std::string& id, std::string& agent_id, game::GameState& cached) {
+    BinaryReader reader(frame);
+    if (reader.byte() != BINARY_PLAY_TURN_DELTA || reader.byte() != BINARY_VERSION) return false;
+    id = reader.string();
+    agent_id = reader.string();
+    return reader.ok() && applyGameStateDelta(reader, cached);
+}
+
+bool decodePlayTurnHeader(std::string_view frame, std::string& id, std::string& agent_id) {
+    if (!isBinaryFrame(frame)) return false;
+    BinaryReader reader(frame);
+    reader.byte(); // Tag
+    if (reader.byte() != BINARY_VERSION) return false;
+    id = reader.string();
+    agent_id = reader.string();
+    return reader.ok();
+}
+
+bool peekPlayTurn(std::string_view frame, std::string& id, std::string& agent_id, int& turn, int* base_turn) {
+    if (!isBinaryFrame(frame)) return false;
+    BinaryReader reader(frame);
+    bool delta = reader.byte() == BINARY_PLAY_TURN_DELTA;
+    if (reader.byte() != BINARY_VERSION) return false;
+    id = reader.string();
+    agent_id = reader.string();
+    int base = delta ? static_cast<int>(reader.varint()) : -1;
+    if (base_turn) *base_turn = base;
+    turn = static_cast<int>(reader.varint());
+    return reader.ok();
+}
+
+} // namespace rpc
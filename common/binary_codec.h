@@ -0,0 +1,150 @@
+// common/binary_codec.h
+// Declares the compact binary encoding of play_turn, an alternative to JSON negotiated at register_agent
+#pragma once
+#include "game_state.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace rpc {
+
+// Frames whose first byte is one of these tags are binary; JSON frames always start with '{'
+constexpr uint8_t BINARY_PLAY_TURN = 0x01;       // Full snapshot
+constexpr uint8_t BINARY_PLAY_TURN_DELTA = 0x02; // Changes since the previous turn
+constexpr uint8_t BINARY_VERSION = 1;
+
+// Encoding names advertised in register_agent ("encoding" field)
+constexpr const char* ENCODING_JSON = "json";
+constexpr const char* ENCODING_BINARY = "binary";
+constexpr const char* ENCODING_BINARY_DELTA = "binary_delta"; // Snapshot first, then deltas
+
+// Appends LEB128 varints, zigzag ints and length-prefixed strings to a buffer
+class BinaryWriter {
+private:
+    std::string& out;
+
+public:
+    explicit BinaryWriter(std::string& out) : out(out) {}
+
+    void byte(uint8_t value) { out += static_cast<char>(value); }
+    void varint(uint64_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>((value & 0x7F) | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+    void zigzag(int64_t value) { varint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); }
+    void string(std::string_view value) {
+        varint(value.size());
+        out.append(value.data(), value.size());
+    }
+    void raw(std::string_view bytes) { out.append(bytes.data(), bytes.size()); }
+};
+
+// Reads what BinaryWriter wrote. Reading past the end sets ok() to false and
+// returns zeros, so callers can check once after a whole record.
+class BinaryReader {
+private:
+    const uint8_t* cur;
+    const uint8_t* end;
+    bool valid;
+
+public:
+    explicit BinaryReader(std::string_view input)
+        : cur(reinterpret_cast<const uint8_t*>(input.data())),
+          end(reinterpret_cast<const uint8_t*>(input.data()) + input.size()), valid(true) {}
+
+    bool ok() const { return valid; }
+    size_t remaining() const { return static_cast<size_t>(end - cur); }
+    std::string_view rest() const { return std::string_view(reinterpret_cast<const char*>(cur), remaining()); }
+
+    uint8_t byte() {
+        if (cur >= end) return fail();
+        return *cur++;
+    }
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (cur >= end) return fail();
+            uint8_t b = *cur++;
+            value |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return value;
+        }
+        return fail(); // Over-long varint
+    }
+    int64_t zigzag() {
+        uint64_t value = varint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+    std::string_view string() {
+        uint64_t length = varint();
+        if (length > remaining()) {
+            fail();
+            return {};
+        }
+        std::string_view value(reinterpret_cast<const char*>(cur), length);
+        cur += length;
+        return value;
+    }
+
+private:
+    uint8_t fail() {
+        valid = false;
+        cur = end;
+        return 0;
+    }
+};
+
+inline bool isBinaryFrame(std::string_view frame) {
+    if (frame.empty()) return false;
+    uint8_t tag = static_cast<uint8_t>(frame[0]);
+    return tag == BINARY_PLAY_TURN || tag == BINARY_PLAY_TURN_DELTA;
+}
+
+inline bool isDeltaFrame(std::string_view frame) {
+    return !frame.empty() && static_cast<uint8_t>(frame[0]) == BINARY_PLAY_TURN_DELTA;
+}
+
+// GameState body. Team names are interned into a table at the front and each
+// agent/base refers to its team by index; facing and is_alive share one byte.
+void encodeGameState(const game::GameState& state, std::string& out);
+bool decodeGameState(BinaryReader& reader, game::GameState& state);
+
+// Whole play_turn frame: tag, version, call id, agent id, then the state body
+// (already encoded, so one encoding is shared by every agent of a turn)
+std::string binary_play_turn_request(const std::string& id, const std::string& agent_id,
+                                     const std::string& encoded_state);
+bool decodePlayTurn(std::string_view frame, std::string& id, std::string& agent_id, game::GameState& state);
+
+// Delta mode. A delta lists, by index in the agents/bases arrays, only the
+// entries whose position, facing, hp, max_hp or alive/destroyed flag changed,
+// plus the turn fields; the config is never repeated. It names the turn it
+// applies on and ends with the checksum of the resulting state, so a receiver
+// that missed a turn or diverged detects it and asks for a snapshot.
+uint64_t checksumGameState(const game::GameState& state);
+
+// Returns false when current cannot be expressed against previous (agents or
+// bases were added or removed); a snapshot must be sent instead.
+bool encodeGameStateDelta(const game::GameState& previous, const game::GameState& current, std::string& out);
+
+// Applies a delta to cached in place. Returns false when the delta does not
+// apply to cached (wrong base turn, bad index, checksum mismatch): cached is
+// then unusable until the next snapshot.
+bool applyGameStateDelta(BinaryReader& reader, game::GameState& cached);
+
+std::string binary_play_turn_delta_request(const std::string& id, const std::string& agent_id,
+                                           const std::string& encoded_delta);
+bool decodePlayTurnDelta(std::string_view frame, std::string& id, std::string& agent_id, game::GameState& cached);
+
+// Call id and agent id of a binary play_turn of either tag. A receiver with
+// no usable cached state still needs the id to answer with a resync.
+bool decodePlayTurnHeader(std::string_view frame, std::string& id, std::string& agent_id);
+
+// Call id, agent id and turn of a binary play_turn of either tag, without
+// decoding the state, so a host serving several agents decodes each turn once.
+// base_turn, if given, gets the turn a delta applies on (-1 for a snapshot).
+bool peekPlayTurn(std::string_view frame, std::string& id, std::string& agent_id, int& turn,
+                  int* base_turn = nullptr);
+
+} // namespace rpc
@@ -0,0 +1,201 @@
+// common/coroutine_loop.cpp
+// Implements the coroutine scheduler and the awaitable connection on top of epoll
+#include "coroutine_loop.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cstdint>
+#include <iostream>
+
+namespace net {
+
+// Fire-and-forget frame around a spawned Task. It starts eagerly, frees
+// itself when the task finishes and is registered in loop.detached meanwhile,
+// so the loop can destroy whatever is still suspended when it goes away.
+struct CoroutineLoop::Detached {
+    struct promise_type {
+        CoroutineLoop& loop;
+
+        promise_type(CoroutineLoop& loop, Task<>&) : loop(loop) {
+            loop.detached.insert(std::coroutine_handle<promise_type>::from_promise(*this).address());
+        }
+        ~promise_type() { loop.detached.erase(std::coroutine_handle<promise_type>::from_promise(*this).address()); }
+
+        Detached get_return_object() const noexcept { return {}; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); } // The body catches everything
+    };
+};
+
+CoroutineLoop::CoroutineLoop(size_t max_events)
+    : epoll_fd(-1), wake_fd(-1), running(false), events(max_events), dispatching(0), dispatch_end(0) {}
+
+CoroutineLoop::~CoroutineLoop() {
+    while (!detached.empty()) { // Each destroy erases its own entry
+        std::coroutine_handle<>::from_address(*detached.begin()).destroy();
+    }
+    if (wake_fd >= 0) ::close(wake_fd);
+    if (epoll_fd >= 0) ::close(epoll_fd);
+}
+
+bool CoroutineLoop::init() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        std::cerr << "epoll_create1 failed" << std::endl;
+        return false;
+    }
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        std::cerr << "eventfd failed" << std::endl;
+        return false;
+    }
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN | EPOLLET;
+    wake_event.data.ptr = nullptr; // Connections carry their AsyncConnection
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event) < 0) {
+        std::cerr << "epoll_ctl failed for wake fd" << std::endl;
+        return false;
+    }
+    running = true; // Set here so a stop() issued before run() is not lost
+    return true;
+}
+
+CoroutineLoop::Detached CoroutineLoop::detach(CoroutineLoop&, Task<> task) {
+    try {
+        co_await task;
+    } catch (const std::exception& e) {
+        std::cerr << "Coroutine failed: " << e.what() << std::endl;
+    }
+}
+
+void CoroutineLoop::spawn(Task<> task) {
+    detach(*this, std::move(task));
+}
+
+void CoroutineLoop::post(std::coroutine_handle<> handle) {
+    ready.push(handle);
+    wakeup();
+}
+
+void CoroutineLoop::wakeup() {
+    uint64_t one = 1;
+    if (::write(wake_fd, &one, sizeof(one)) < 0) {
+        // Counter saturated: the loop is already due to wake up
+    }
+}
+
+void CoroutineLoop::stop() {
+    running = false;
+    wakeup();
+}
+
+void CoroutineLoop::run() {
+    while (running) {
+        runOnce(-1);
+    }
+}
+
+int CoroutineLoop::runOnce(int timeout_ms) {
+    int count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), timeout_ms);
+    if (count < 0) count = 0; // EINTR
+    dispatch_end = static_cast<size_t>(count);
+    for (dispatching = 0; dispatching < dispatch_end; ++dispatching) {
+        epoll_event& event = events[dispatching];
+        if (event.events == 0) continue; // Its connection was removed by an earlier resume
+        if (!event.data.ptr) {
+            uint64_t drained;
+            while (::read(wake_fd, &drained, sizeof(drained)) > 0) {}
+            continue;
+        }
+        static_cast<AsyncConnection*>(event.data.ptr)->handleEvents(event.events);
+    }
+    dispatch_end = 0;
+    resumeReady();
+    return count;
+}
+
+size_t CoroutineLoop::resumeReady() {
+    return ready.consumeAll([](std::coroutine_handle<> handle) { handle.resume(); });
+}
+
+bool CoroutineLoop::add(AsyncConnection* connection, int fd) {
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET; // Edge-triggered: drain on every event
+    event.data.ptr = connection;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+        std::cerr << "epoll_ctl failed for connection" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void CoroutineLoop::remove(AsyncConnection* connection, int fd) {
+    if (fd >= 0) epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, nullptr); // -1 once disconnected: closing removed it
+    for (size_t i = dispatching + 1; i < dispatch_end; ++i) {
+        if (events[i].data.ptr == connection) events[i].events = 0;
+    }
+}
+
+// AsyncConnection
+
+AsyncConnection::AsyncConnection(CoroutineLoop& loop, TcpConnection& connection)
+    : loop(loop), connection(connection), registered(false), closed(!connection.isConnected()) {
+    if (closed) return;
+    connection.setNonBlocking(true);
+    registered = loop.add(this, connection.getSocketFd());
+    closed = !registered;
+}
+
+AsyncConnection::~AsyncConnection() {
+    if (registered) loop.remove(this, connection.getSocketFd());
+}
+
+void AsyncConnection::handleEvents(uint32_t events) {
+    // Decided first, resumed last: a resumed coroutine may destroy this
+    std::coroutine_handle<> wake_reader;
+    std::vector<std::coroutine_handle<>> wake_writers;
+    if ((events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) && tryFlush()) { // Awaited or not
+        wake_writers.swap(writers);
+    }
+    if ((events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP)) && reader && tryReceive()) {
+        wake_reader = std::exchange(reader, {});
+    }
+    if (closed) {
+        for (std::coroutine_handle<> writer : writers) wake_writers.push_back(writer);
+        writers.clear();
+        if (reader) {
+            received.reset();
+            wake_reader = std::exchange(reader, {});
+        }
+    }
+    for (std::coroutine_handle<> writer : wake_writers) writer.resume();
+    if (wake_reader) wake_reader.resume();
+}
+
+bool AsyncConnection::tryReceive() {
+    std::string_view frame;
+    while (!closed && !connection.nextFrame(frame)) {
+        if (!connection.isConnected()) { // Unframeable stream
+            closed = true;
+            break;
+        }
+        IoStatus status = connection.receiveSome();
+        if (status == IoStatus::would_block) return false;
+        if (status == IoStatus::closed) closed = true;
+    }
+    if (closed) received.reset();
+    else received = frame;
+    return true;
+}
+
+bool AsyncConnection::tryFlush() {
+    if (closed) return true;
+    IoStatus status = connection.flushPending();
+    if (status == IoStatus::closed) closed = true;
+    return status != IoStatus::would_block;
+}
+
+} // namespace net
@@ -0,0 +1,188 @@
+// common/coroutine_loop.h
+// Declares the epoll loop that runs Task coroutines over non-blocking TcpConnections
+#pragma once
+#include "mpsc_queue.h"
+#include "task.h"
+#include "tcp_connection.h"
+#include "thread_pool.h"
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <variant>
+#include <vector>
+
+struct epoll_event;
+
+namespace net {
+
+class AsyncConnection;
+
+// Single-threaded scheduler for coroutines. Every coroutine runs on the thread
+// that calls run()/runOnce(); a coroutine suspended on a socket is resumed
+// inline when epoll reports it ready, and one suspended in offload() is
+// resumed through the ready queue once its worker finished. Handlers that
+// wait on each other therefore never block the loop: a request can be
+// answered while another one is still being computed on a worker.
+class CoroutineLoop {
+private:
+    struct Detached; // Frame of a spawned task, owned by the loop
+
+    int epoll_fd;
+    int wake_fd; // eventfd used to interrupt epoll_wait from other threads
+    std::atomic<bool> running;
+    std::vector<epoll_event> events;
+    size_t dispatching;  // Index of the event being handled, for remove()
+    size_t dispatch_end; // Events returned by the current epoll_wait
+    concurrency::MpscQueue<std::coroutine_handle<>> ready; // Posted from any thread
+    std::unordered_set<void*> detached;                    // Spawned frames still running
+
+public:
+    explicit CoroutineLoop(size_t max_events = 64);
+    ~CoroutineLoop(); // Destroys the spawned tasks that are still suspended
+
+    CoroutineLoop(const CoroutineLoop&) = delete;
+    CoroutineLoop& operator=(const CoroutineLoop&) = delete;
+
+    bool init(); // Creates the epoll instance
+
+    // Starts task right away, on the calling (loop) thread, until its first
+    // suspension; the loop owns it from there. Arguments the task took by view
+    // (e.g. a received frame) are safe to read up to that first suspension.
+    void spawn(Task<> task);
+
+    // Resumes handle on the loop thread at its next round. Safe from any thread.
+    void post(std::coroutine_handle<> handle);
+
+    // co_await loop.offload(pool, fn): runs fn() on a pool worker and resumes
+    // the caller on the loop thread with its result (or its exception). The
+    // pool must be stopped before the loop is destroyed.
+    template <typename Fn>
+    class OffloadAwaiter {
+    public:
+        using Result = std::invoke_result_t<Fn&>;
+
+    private:
+        using Slot = std::conditional_t<std::is_void_v<Result>, std::monostate, std::optional<Result>>;
+        CoroutineLoop& loop;
+        concurrency::ThreadPool& pool;
+        Fn fn;
+        Slot result;
+        std::exception_ptr error;
+
+    public:
+        OffloadAwaiter(CoroutineLoop& loop, concurrency::ThreadPool& pool, Fn fn)
+            : loop(loop), pool(pool), fn(std::move(fn)) {}
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> caller) {
+            pool.submit([this, caller] {
+                try {
+                    if constexpr (std::is_void_v<Result>) fn();
+                    else result.emplace(fn());
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                loop.post(caller); // Written before the push, read after the pop
+            });
+        }
+        Result await_resume() {
+            if (error) std::rethrow_exception(error);
+            if constexpr (!std::is_void_v<Result>) return std::move(*result);
+        }
+    };
+
+    template <typename Fn>
+    OffloadAwaiter<Fn> offload(concurrency::ThreadPool& pool, Fn fn) {
+        return OffloadAwaiter<Fn>(*this, pool, std::move(fn));
+    }
+
+    // Loop control
+    int runOnce(int timeout_ms); // One epoll_wait round plus the posted coroutines; returns events handled
+    void run();                  // Until stop()
+    void stop();                 // Safe from any thread
+    void wakeup();               // Interrupts a blocked runOnce, safe from any thread
+    bool isRunning() const { return running; }
+
+private:
+    friend class AsyncConnection;
+    bool add(AsyncConnection* connection, int fd);
+    void remove(AsyncConnection* connection, int fd); // Also drops its events still to be handled
+    size_t resumeReady();
+
+    static Detached detach(CoroutineLoop& loop, Task<> task);
+};
+
+// A TcpConnection served by a CoroutineLoop: receiveFrame and sendFrame are
+// awaited instead of blocking. The connection is switched to non-blocking
+// mode and must only be used from the loop thread while this exists. Destroy
+// it only once no coroutine is suspended on it.
+class AsyncConnection {
+private:
+    CoroutineLoop& loop;
+    TcpConnection& connection;
+    std::coroutine_handle<> reader;               // Suspended in receiveFrame, at most one
+    std::vector<std::coroutine_handle<>> writers; // Suspended in sendFrame until the buffer drains
+    std::optional<std::string_view> received;     // Handed to the reader when it resumes
+    bool registered;
+    bool closed;
+
+public:
+    AsyncConnection(CoroutineLoop& loop, TcpConnection& connection);
+    ~AsyncConnection();
+
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+
+    // co_await receiveFrame(): the next frame, nullopt once the peer is gone.
+    // The view is valid until the next receiveFrame.
+    class FrameAwaiter {
+    private:
+        AsyncConnection& owner;
+
+    public:
+        explicit FrameAwaiter(AsyncConnection& owner) : owner(owner) {}
+        bool await_ready() { return owner.tryReceive(); }
+        void await_suspend(std::coroutine_handle<> caller) { owner.reader = caller; }
+        std::optional<std::string_view> await_resume() { return owner.received; }
+    };
+    FrameAwaiter receiveFrame() { return FrameAwaiter(*this); }
+
+    // co_await sendFrame(write): true once the frame reached the socket,
+    // false if the connection is gone. write(std::string&) appends the frame
+    // body straight into the send buffer; it runs before sendFrame returns, so
+    // frames go out in call order whether or not they are awaited.
+    class SendAwaiter {
+    private:
+        AsyncConnection& owner;
+        bool flushed;
+
+    public:
+        SendAwaiter(AsyncConnection& owner, bool flushed) : owner(owner), flushed(flushed) {}
+        bool await_ready() const noexcept { return flushed; }
+        void await_suspend(std::coroutine_handle<> caller) { owner.writers.push_back(caller); }
+        bool await_resume() const noexcept { return !owner.closed; }
+    };
+    template <typename Write>
+    SendAwaiter sendFrame(Write&& write) {
+        if (closed) return SendAwaiter(*this, true);
+        write(connection.beginFrame());
+        connection.endFrame();
+        return SendAwaiter(*this, tryFlush());
+    }
+
+    bool isOpen() const { return !closed; }
+    TcpConnection& socket() { return connection; }
+
+private:
+    friend class CoroutineLoop;
+    void handleEvents(uint32_t events); // From the loop, resumes whoever the events unblocked
+    bool tryReceive();                  // True once received holds the reader's result
+    bool tryFlush();                    // True once nothing is pending or the connection is gone
+};
+
+} // namespace net
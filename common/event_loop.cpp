@@ -0,0 +1,222 @@
+// common/event_loop.cpp
+// Implements the edge-triggered epoll reactor
+#include "event_loop.h"
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <iostream>
+
+namespace net {
+
+EventLoop::EventLoop(TcpServer* server, size_t max_events)
+    : epoll_fd(-1), wake_fd(-1), server(server), accept_paused(false), running(false), next_id(WAKE_ID + 1),
+      events(max_events) {}
+
+EventLoop::~EventLoop() {
+    connections.clear(); // Sockets close themselves
+    if (wake_fd >= 0) ::close(wake_fd);
+    if (epoll_fd >= 0) ::close(epoll_fd);
+}
+
+bool EventLoop::init() {
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        std::cerr << "epoll_create1 failed" << std::endl;
+        return false;
+    }
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        std::cerr << "eventfd failed" << std::endl;
+        return false;
+    }
+    epoll_event wake_event{};
+    wake_event.events = EPOLLIN | EPOLLET;
+    wake_event.data.u64 = WAKE_ID;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &wake_event) < 0) {
+        std::cerr << "epoll_ctl failed for wake fd" << std::endl;
+        return false;
+    }
+
+    if (server) { // The listening socket must be non-blocking and already started
+        epoll_event listen_event{};
+        listen_event.events = EPOLLIN | EPOLLET;
+        listen_event.data.u64 = LISTENER_ID;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, server->getServerFd(), &listen_event) < 0) {
+            std::cerr << "epoll_ctl failed for listening socket" << std::endl;
+            return false;
+        }
+    }
+    running = true; // Set here so a stop() issued before run() is not lost
+    return true;
+}
+
+EventLoop::ConnectionId EventLoop::addConnection(std::unique_ptr<TcpConnection> connection) {
+    if (!connection || !connection->isConnected()) return 0;
+    connection->setNonBlocking(true);
+
+    ConnectionId id = next_id++;
+    epoll_event event{};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET; // Edge-triggered: drain on every event
+    event.data.u64 = id;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, connection->getSocketFd(), &event) < 0) {
+        std::cerr << "epoll_ctl failed for connection" << std::endl;
+        return 0;
+    }
+    connection->outboundQueue()->onReady([this, id] {
+        ready.push(id);
+        wakeup();
+    });
+    connections.emplace(id, std::move(connection));
+
+    if (on_connect) on_connect(id);
+    return id;
+}
+
+bool EventLoop::send(ConnectionId id, std::string_view message, bool flush) {
+    TcpConnection* conn = connection(id);
+    if (!conn) return false;
+
+    conn->queueMessage(message);
+    if (!flush) return true; // Goes out with the next flushing send or EPOLLOUT
+    return flushQueued(id, *conn);
+}
+
+bool EventLoop::flushQueued(ConnectionId id, TcpConnection& conn) {
+    if (conn.flushPending() == IoStatus::closed) { // Remaining bytes wait for EPOLLOUT
+        close(id);
+        return false;
+    }
+    return true;
+}
+
+void EventLoop::close(ConnectionId id) {
+    auto it = connections.find(id);
+    if (it == connections.end()) return;
+
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, it->second->getSocketFd(), nullptr);
+    connections.erase(it); // Closes the socket
+    if (on_close) on_close(id);
+}
+
+std::shared_ptr<OutboundQueue> EventLoop::outbound(ConnectionId id) {
+    TcpConnection* conn = connection(id);
+    return conn ? conn->outboundQueue() : nullptr;
+}
+
+TcpConnection* EventLoop::connection(ConnectionId id) {
+    auto it = connections.find(id);
+    return it == connections.end() ? nullptr : it->second.get();
+}
+
+int EventLoop::runOnce(int timeout_ms) {
+    if (accept_paused) { // Wake up in time to retry the queued connections
+        auto left = std::chrono::ceil<std::chrono::milliseconds>(accept_retry - std::chrono::steady_clock::now());
+        int retry_ms = static_cast<int>(std::max<long long>(0, left.count()));
+        timeout_ms = timeout_ms < 0 ? retry_ms : std::min(timeout_ms, retry_ms);
+    }
+    int count = epoll_wait(epoll_fd, events.data(), static_cast<int>(events.size()), timeout_ms);
+    if (count < 0) {
+        if (errno != EINTR) std::cerr << "epoll_wait failed" << std::endl;
+        return 0;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        ConnectionId id = events[i].data.u64;
+        uint32_t flags = events[i].events;
+
+        if (id == LISTENER_ID) {
+            acceptPending();
+        } else if (id == WAKE_ID) {
+            uint64_t value;
+            while (read(wake_fd, &value, sizeof(value)) > 0) {} // Reset the counter
+        } else {
+            if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) handleReadable(id);
+            if (flags & EPOLLOUT) handleWritable(id);
+        }
+    }
+    if (accept_paused && std::chrono::steady_clock::now() >= accept_retry) acceptPending();
+    flushReady();
+    return count;
+}
+
+void EventLoop::run() {
+    while (running) {
+        runOnce(-1);
+    }
+}
+
+void EventLoop::stop() {
+    running = false;
+    wakeup();
+}
+
+void EventLoop::wakeup() {
+    uint64_t one = 1;
+    if (wake_fd >= 0) {
+        ssize_t ignored = write(wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+void EventLoop::acceptPending() { // Edge-triggered: accept until the queue is empty
+    accept_paused = false;
+    while (server) {
+        int error = 0;
+        std::unique_ptr<TcpConnection> accepted = server->acceptConnection(&error);
+        if (accepted) {
+            addConnection(std::move(accepted));
+            continue;
+        }
+        if (error == ECONNABORTED || error == EINTR) continue; // Only that one is lost
+        if (error == EMFILE || error == ENFILE || error == ENOBUFS || error == ENOMEM) {
+            // The rest stay queued and no new edge comes for them: retry
+            // later instead of waiting for another client to connect
+            accept_paused = true;
+            accept_retry = std::chrono::steady_clock::now() + ACCEPT_BACKOFF;
+        }
+        break; // EAGAIN: nothing left; anything else is not worth retrying
+    }
+}
+
+void EventLoop::handleReadable(ConnectionId id) {
+    // Alternate reading and dispatching so the buffer stays bounded while the
+    // socket is drained until it would block
+    while (true) {
+        TcpConnection* conn = connection(id);
+        if (!conn) return; // Closed by a handler
+
+        IoStatus status = conn->receiveSome();
+
+        std::string_view frame;
+        while (conn->nextFrame(frame)) {
+            if (on_message) on_message(id, frame);
+            conn = connection(id);
+            if (!conn) return; // Closed by a handler
+        }
+
+        if (status == IoStatus::closed || !conn->isConnected()) {
+            close(id);
+            return;
+        }
+        if (status == IoStatus::would_block) return;
+    }
+}
+
+void EventLoop::handleWritable(ConnectionId id) {
+    TcpConnection* conn = connection(id);
+    if (!conn) return; // Even without pending writes: posted frames may be waiting
+    if (conn->flushPending() == IoStatus::closed) {
+        close(id);
+    }
+}
+
+void EventLoop::flushReady() {
+    ready.consumeAll([this](ConnectionId id) {
+        handleWritable(id); // Closed meanwhile: no longer found. What blocks waits for EPOLLOUT
+    });
+}
+
+} // namespace net
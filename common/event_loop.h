@@ -0,0 +1,94 @@
+// common/event_loop.h
+// Declare the edge-triggered epoll reactor that serves many TcpConnections from one thread
+#pragma once
+#include "mpsc_queue.h"
+#include "tcp_connection.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct epoll_event;
+
+namespace net {
+
+class EventLoop {
+public:
+    using ConnectionId = uint64_t;
+    using ConnectHandler = std::function<void(ConnectionId)>;
+    using MessageHandler = std::function<void(ConnectionId, std::string_view)>; // View valid during the call
+    using CloseHandler = std::function<void(ConnectionId)>;
+
+private:
+    int epoll_fd;
+    int wake_fd;                  // eventfd used to interrupt epoll_wait from other threads
+    TcpServer* server;            // Optional listening socket, accepted connections join the loop
+    bool accept_paused;           // Out of descriptors: accepting again at accept_retry
+    std::chrono::steady_clock::time_point accept_retry;
+    std::atomic<bool> running;
+    ConnectionId next_id;
+
+    std::unordered_map<ConnectionId, std::unique_ptr<TcpConnection>> connections;
+    std::vector<epoll_event> events;
+    concurrency::MpscQueue<ConnectionId> ready; // Connections with frames posted from other threads
+
+    ConnectHandler on_connect;
+    MessageHandler on_message;
+    CloseHandler on_close;
+
+public:
+    static constexpr ConnectionId LISTENER_ID = 0;
+    static constexpr ConnectionId WAKE_ID = 1;
+    static constexpr std::chrono::milliseconds ACCEPT_BACKOFF{50}; // After EMFILE/ENFILE
+
+    explicit EventLoop(TcpServer* server = nullptr, size_t max_events = 1024);
+    ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    bool init(); // Creates the epoll instance and registers the listening socket
+
+    // Callbacks
+    void onConnect(ConnectHandler handler) { on_connect = std::move(handler); }
+    void onMessage(MessageHandler handler) { on_message = std::move(handler); }
+    void onClose(CloseHandler handler) { on_close = std::move(handler); }
+
+    // Connections
+    ConnectionId addConnection(std::unique_ptr<TcpConnection> connection); // Takes ownership, 0 on failure
+    bool send(ConnectionId id, std::string_view message, bool flush = true); // Queues a frame, flushes unless pipelining
+    // Like send, but write(std::string&) appends the payload straight into the send buffer
+    template <typename Write>
+    bool sendFrame(ConnectionId id, Write&& write, bool flush = true) {
+        TcpConnection* conn = connection(id);
+        if (!conn) return false;
+        write(conn->beginFrame());
+        conn->endFrame();
+        return !flush || flushQueued(id, *conn);
+    }
+    void close(ConnectionId id);
+    // Per-connection queue for producers on other threads. Fetch it on the
+    // loop thread; posting wakes the loop, which writes the frames out.
+    std::shared_ptr<OutboundQueue> outbound(ConnectionId id);
+    TcpConnection* connection(ConnectionId id);
+    size_t connectionCount() const { return connections.size(); }
+
+    // Loop control
+    int runOnce(int timeout_ms); // One epoll_wait round; returns the number of events handled
+    void run();                  // Until stop()
+    void stop();                 // Safe from any thread
+    void wakeup();               // Interrupts a blocked runOnce, safe from any thread
+
+private:
+    void acceptPending();
+    void handleReadable(ConnectionId id);
+    void handleWritable(ConnectionId id);
+    void flushReady(); // Connections announced through the ready queue
+    bool flushQueued(ConnectionId id, TcpConnection& conn); // Closes the connection on a dead peer
+};
+
+} // namespace net
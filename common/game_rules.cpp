@@ -0,0 +1,408 @@
+// common/game_rules.cpp
+// Implements the turn rules shared by the coordinator and any offline tooling
+#include "game_rules.h"
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+
+namespace game {
+
+namespace {
+
+bool insideMap(const GameState& state, const Position& pos) {
+    return pos.x >= 0 && pos.y >= 0 &&
+           pos.x < state.config.map_width && pos.y < state.config.map_height;
+}
+
+size_t cellIndex(const GameState& state, const Position& pos) {
+    return static_cast<size_t>(pos.y) * state.config.map_width + pos.x;
+}
+
+Position step(const Position& from, Direction dir) {
+    Position offset = getDirectionOffset(dir);
+    return Position(from.x + offset.x, from.y + offset.y);
+}
+
+} // namespace
+
+std::string_view actionName(ActionType type, Direction direction) {
+    // Indexed by [type - move][direction], in enum order
+    static constexpr std::string_view NAMES[3][4] = {
+        {"move_north", "move_south", "move_east", "move_west"},
+        {"attack_north", "attack_south", "attack_east", "attack_west"},
+        {"defend_north", "defend_south", "defend_east", "defend_west"},
+    };
+    int row = static_cast<int>(type) - static_cast<int>(ActionType::move);
+    int column = static_cast<int>(direction);
+    if (row < 0 || row >= 3 || column < 0 || column >= 4) return {};
+    return NAMES[row][column];
+}
+
+Action parseAction(std::string_view text) {
+    size_t separator = text.find_first_of("_ ");
+    if (separator == std::string_view::npos) return Action();
+
+    std::string_view verb = text.substr(0, separator);
+    std::string_view dir = text.substr(separator + 1);
+    if (dir != "north" && dir != "south" && dir != "east" && dir != "west") return Action();
+    Direction direction = getDirectionFromString(dir);
+
+    if (verb == "move") return Action(ActionType::move, direction);
+    if (verb == "attack") return Action(ActionType::attack, direction);
+    if (verb == "defend") return Action(ActionType::defend, direction);
+    return Action();
+}
+
+void resolveTurn(GameState& state, const std::vector<Action>& actions, std::pmr::memory_resource* scratch) {
+    const size_t agent_count = state.agents.size();
+    const size_t cells = static_cast<size_t>(std::max(0, state.config.map_width)) *
+                         static_cast<size_t>(std::max(0, state.config.map_height));
+    auto actionOf = [&actions](size_t i) { return i < actions.size() ? actions[i] : Action(); };
+
+    // Occupancy at the start of the turn
+    std::pmr::vector<int> agent_at(cells, -1, scratch);
+    std::pmr::vector<int> base_at(cells, -1, scratch);
+    for (size_t i = 0; i < agent_count; ++i) {
+        const Agent& agent = state.agents[i];
+        if (agent.is_alive && insideMap(state, agent.position)) {
+            agent_at[cellIndex(state, agent.position)] = static_cast<int>(i);
+        }
+    }
+    for (size_t i = 0; i < state.bases.size(); ++i) {
+        const Base& base = state.bases[i];
+        if (!base.is_destroyed && insideMap(state, base.position)) {
+            base_at[cellIndex(state, base.position)] = static_cast<int>(i);
+        }
+    }
+
+    // 1. Facing
+    for (size_t i = 0; i < agent_count; ++i) {
+        Action action = actionOf(i);
+        if (state.agents[i].is_alive && action.type != ActionType::none) {
+            state.agents[i].facing = action.direction;
+        }
+    }
+
+    // 2. Attacks, accumulated so that every attacker sees the same board
+    std::pmr::vector<int> agent_damage(agent_count, 0, scratch);
+    std::pmr::vector<int> base_damage(state.bases.size(), 0, scratch);
+    for (size_t i = 0; i < agent_count; ++i) {
+        const Agent& attacker = state.agents[i];
+        Action action = actionOf(i);
+        if (!attacker.is_alive || action.type != ActionType::attack) continue;
+
+        Position target = step(attacker.position, action.direction);
+        if (!insideMap(state, target)) continue;
+
+        int victim = agent_at[cellIndex(state, target)];
+        if (victim >= 0 && state.agents[victim].team != attacker.team) {
+            bool defending = actionOf(victim).type == ActionType::defend;
+            agent_damage[victim] += defending ? ATTACK_DAMAGE / 2 : ATTACK_DAMAGE;
+            continue;
+        }
+        int base = base_at[cellIndex(state, target)];
+        if (base >= 0 && state.bases[base].team != attacker.team) {
+            base_damage[base] += ATTACK_DAMAGE;
+        }
+    }
+
+    // 3. Deaths
+    for (size_t i = 0; i < agent_count; ++i) {
+        Agent& agent = state.agents[i];
+        if (!agent.is_alive || agent_damage[i] == 0) continue;
+        agent.hp = std::max(0, agent.hp - agent_damage[i]);
+        if (agent.hp == 0) {
+            agent.is_alive = false;
+            if (insideMap(state, agent.position)) agent_at[cellIndex(state, agent.position)] = -1;
+        }
+    }
+    for (size_t i = 0; i < state.bases.size(); ++i) {
+        Base& base = state.bases[i];
+        if (base.is_destroyed || base_damage[i] == 0) continue;
+        base.hp = std::max(0, base.hp - base_damage[i]);
+        base.is_destroyed = (base.hp == 0);
+    }
+
+    // 4. Moves: the lowest index claiming a free cell gets it
+    std::pmr::vector<int> claimed_by(cells, -1, scratch);
+    for (size_t i = 0; i < agent_count; ++i) {
+        const Agent& agent = state.agents[i];
+        Action action = actionOf(i);
+        if (!agent.is_alive || action.type != ActionType::move) continue;
+
+        Position target = step(agent.position, action.direction);
+        if (!insideMap(state, target)) continue;
+        size_t cell = cellIndex(state, target);
+        if (agent_at[cell] >= 0 || claimed_by[cell] >= 0) continue;
+        claimed_by[cell] = static_cast<int>(i);
+    }
+    for (size_t i = 0; i < agent_count; ++i) {
+        Agent& agent = state.agents[i];
+        Action action = actionOf(i);
+        if (!agent.is_alive || action.type != ActionType::move) continue;
+
+        Position target = step(agent.position, action.direction);
+        if (insideMap(state, target) && claimed_by[cellIndex(state, target)] == static_cast<int>(i)) {
+            agent.position = target;
+        }
+    }
+
+    // 5. Healing next to the own base
+    for (Agent& agent : state.agents) {
+        if (!agent.is_alive) continue;
+        for (const Base& base : state.bases) {
+            if (base.is_destroyed || base.team != agent.team) continue;
+            if (std::abs(base.position.x - agent.position.x) <= 1 &&
+                std::abs(base.position.y - agent.position.y) <= 1) {
+                agent.hp = std::min(agent.max_hp, agent.hp + BASE_HEAL);
+            }
+        }
+    }
+}
+
+void resolveTurn(GameState& state, const std::vector<Action>& actions, concurrency::ThreadPool& pool, int tile_size) {
+    const int width = std::max(0, state.config.map_width);
+    const int height = std::max(0, state.config.map_height);
+    if (width == 0 || height == 0) {
+        resolveTurn(state, actions); // Nothing to cut into tiles
+        return;
+    }
+    tile_size = std::max(1, tile_size);
+    const int tiles_x = (width + tile_size - 1) / tile_size;
+    const int tiles_y = (height + tile_size - 1) / tile_size;
+    const size_t tile_count = static_cast<size_t>(tiles_x) * tiles_y;
+    const size_t agent_count = state.agents.size();
+    const size_t cells = static_cast<size_t>(width) * height;
+    auto actionOf = [&actions](size_t i) { return i < actions.size() ? actions[i] : Action(); };
+    auto tileOf = [&](Position pos) { // Agents off the map go to the nearest tile
+        pos.x = std::clamp(pos.x, 0, width - 1);
+        pos.y = std::clamp(pos.y, 0, height - 1);
+        return (pos.y / tile_size) * tiles_x + pos.x / tile_size;
+    };
+
+    // Living agents bucketed by tile, index order kept inside a tile
+    std::vector<uint32_t> tile_start(tile_count + 1, 0);
+    for (const Agent& agent : state.agents) {
+        if (agent.is_alive) tile_start[tileOf(agent.position) + 1]++;
+    }
+    for (size_t t = 0; t < tile_count; ++t) tile_start[t + 1] += tile_start[t];
+    std::vector<uint32_t> tile_agents(tile_start[tile_count]);
+    {
+        std::vector<uint32_t> fill(tile_start.begin(), tile_start.end() - 1);
+        for (size_t i = 0; i < agent_count; ++i) {
+            if (state.agents[i].is_alive) tile_agents[fill[tileOf(state.agents[i].position)]++] = i;
+        }
+    }
+    auto forTiles = [&](auto&& body) {
+        pool.parallelFor(tile_count, [&](size_t t) { body(static_cast<int>(t)); });
+    };
+    auto forAgents = [&](int t, auto&& body) {
+        for (uint32_t k = tile_start[t]; k < tile_start[t + 1]; ++k) body(tile_agents[k]);
+    };
+    auto forNeighbours = [&](int t, auto&& body) { // Steps are one cell long: effects only reach these
+        int tx = t % tiles_x, ty = t / tiles_x;
+        for (int ny = std::max(0, ty - 1); ny <= std::min(tiles_y - 1, ty + 1); ++ny) {
+            for (int nx = std::max(0, tx - 1); nx <= std::min(tiles_x - 1, tx + 1); ++nx) {
+                if (nx != tx || ny != ty) body(ny * tiles_x + nx);
+            }
+        }
+    };
+
+    std::vector<int> agent_at(cells, -1);
+    std::vector<int> base_at(cells, -1);
+    for (size_t i = 0; i < state.bases.size(); ++i) {
+        const Base& base = state.bases[i];
+        if (!base.is_destroyed && insideMap(state, base.position)) {
+            base_at[cellIndex(state, base.position)] = static_cast<int>(i);
+        }
+    }
+
+    // Effects crossing a tile border, posted by the source tile
+    struct Hit {
+        int tile; // Tile that owns the target cell
+        int victim;
+        int damage;
+        bool base;
+    };
+    struct Claim {
+        int tile;
+        size_t cell;
+        int mover;
+    };
+    std::vector<std::vector<Hit>> hits_out(tile_count);
+    std::vector<std::vector<Claim>> claims_out(tile_count);
+    std::vector<int> agent_damage(agent_count, 0);
+    std::vector<int> base_damage(state.bases.size(), 0);
+    std::vector<int> claimed_by(cells, -1);
+    auto applyHit = [&](const Hit& hit) {
+        (hit.base ? base_damage : agent_damage)[hit.victim] += hit.damage;
+    };
+    auto applyClaim = [&](size_t cell, int mover) {
+        if (claimed_by[cell] < 0 || mover < claimed_by[cell]) claimed_by[cell] = mover;
+    };
+
+    // 1. Occupancy at the start of the turn, and facing
+    forTiles([&](int t) {
+        forAgents(t, [&](uint32_t i) {
+            Agent& agent = state.agents[i];
+            if (insideMap(state, agent.position)) agent_at[cellIndex(state, agent.position)] = static_cast<int>(i);
+            Action action = actionOf(i);
+            if (action.type != ActionType::none) agent.facing = action.direction;
+        });
+    });
+
+    // 2. Attacks against the start-of-turn board
+    forTiles([&](int t) {
+        forAgents(t, [&](uint32_t i) {
+            const Agent& attacker = state.agents[i];
+            Action action = actionOf(i);
+            if (action.type != ActionType::attack) return;
+            Position target = step(attacker.position, action.direction);
+            if (!insideMap(state, target)) return;
+
+            size_t cell = cellIndex(state, target);
+            Hit hit{tileOf(target), agent_at[cell], 0, false};
+            if (hit.victim >= 0 && state.agents[hit.victim].team != attacker.team) {
+                bool defending = actionOf(hit.victim).type == ActionType::defend;
+                hit.damage = defending ? ATTACK_DAMAGE / 2 : ATTACK_DAMAGE;
+            } else if (base_at[cell] >= 0 && state.bases[base_at[cell]].team != attacker.team) {
+                hit = Hit{hit.tile, base_at[cell], ATTACK_DAMAGE, true};
+            } else {
+                return;
+            }
+            if (hit.tile == t) {
+                applyHit(hit);
+            } else {
+                hits_out[t].push_back(hit);
+            }
+        });
+    });
+
+    // 3. Hits from the neighbours, then deaths
+    forTiles([&](int t) {
+        forNeighbours(t, [&](int n) {
+            for (const Hit& hit : hits_out[n]) {
+                if (hit.tile == t) applyHit(hit);
+            }
+        });
+        forAgents(t, [&](uint32_t i) {
+            Agent& agent = state.agents[i];
+            if (agent_damage[i] == 0) return;
+            agent.hp = std::max(0, agent.hp - agent_damage[i]);
+            if (agent.hp == 0) {
+                agent.is_alive = false;
+                if (insideMap(state, agent.position)) agent_at[cellIndex(state, agent.position)] = -1;
+            }
+        });
+        for (size_t b = 0; b < state.bases.size(); ++b) {
+            Base& base = state.bases[b];
+            if (base_damage[b] == 0 || tileOf(base.position) != t) continue;
+            base.hp = std::max(0, base.hp - base_damage[b]);
+            base.is_destroyed = (base.hp == 0);
+        }
+    });
+
+    // 4. Move claims: the lowest index claiming a free cell gets it
+    forTiles([&](int t) {
+        forAgents(t, [&](uint32_t i) {
+            const Agent& agent = state.agents[i];
+            Action action = actionOf(i);
+            if (!agent.is_alive || action.type != ActionType::move) return;
+            Position target = step(agent.position, action.direction);
+            if (!insideMap(state, target)) return;
+            size_t cell = cellIndex(state, target);
+            if (agent_at[cell] >= 0) return;
+            int target_tile = tileOf(target);
+            if (target_tile == t) {
+                applyClaim(cell, static_cast<int>(i));
+            } else {
+                claims_out[t].push_back({target_tile, cell, static_cast<int>(i)});
+            }
+        });
+    });
+    forTiles([&](int t) {
+        forNeighbours(t, [&](int n) {
+            for (const Claim& claim : claims_out[n]) {
+                if (claim.tile == t) applyClaim(claim.cell, claim.mover);
+            }
+        });
+    });
+
+    // 5. Moves and healing next to the own base
+    forTiles([&](int t) {
+        forAgents(t, [&](uint32_t i) {
+            Agent& agent = state.agents[i];
+            if (!agent.is_alive) return;
+            Action action = actionOf(i);
+            if (action.type == ActionType::move) {
+                Position target = step(agent.position, action.direction);
+                if (insideMap(state, target) && claimed_by[cellIndex(state, target)] == static_cast<int>(i)) {
+                    agent.position = target;
+                }
+            }
+            for (const Base& base : state.bases) {
+                if (base.is_destroyed || base.team != agent.team) continue;
+                if (std::abs(base.position.x - agent.position.x) <= 1 &&
+                    std::abs(base.position.y - agent.position.y) <= 1) {
+                    agent.hp = std::min(agent.max_hp, agent.hp + BASE_HEAL);
+                }
+            }
+        });
+    });
+}
+
+bool checkGameOver(GameState& state) {
+    if (state.game_over) return true;
+
+    // Teams and their remaining strength, keyed by views into the state
+    std::map<std::string_view, int> team_hp;
+    for (const Base& base : state.bases) team_hp.emplace(base.team, 0);
+    for (const Agent& agent : state.agents) {
+        int& hp = team_hp[agent.team];
+        if (agent.is_alive) hp += agent.hp;
+    }
+
+    // A destroyed base loses the game
+    for (const Base& base : state.bases) {
+        if (!base.is_destroyed) continue;
+        state.game_over = true;
+        state.winner = "";
+        for (const Base& other : state.bases) {
+            if (!other.is_destroyed) {
+                state.winner = other.team;
+                break;
+            }
+        }
+        return true;
+    }
+
+    // A team without living agents loses the game
+    std::vector<std::string_view> standing;
+    for (const auto& [team, hp] : team_hp) {
+        if (hp > 0) standing.push_back(team);
+    }
+    if (team_hp.size() >= 2 && standing.size() <= 1) {
+        state.game_over = true;
+        state.winner = standing.empty() ? "" : standing.front();
+        return true;
+    }
+
+    // Out of turns: the strongest team wins
+    if (state.current_turn >= state.config.max_turns) {
+        state.game_over = true;
+        state.winner = "";
+        int best = -1;
+        for (const auto& [team, hp] : team_hp) {
+            if (hp > best) {
+                best = hp;
+                state.winner = team;
+            } else if (hp == best) {
+                state.winner = ""; // Tie
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+} // namespace game
@@ -0,0 +1,70 @@
+// common/game_rules.h
+// Declares the turn rules shared by the coordinator and any offline tooling
+#pragma once
+#include "game_state.h"
+#include "thread_pool.h"
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace game {
+
+// Action chosen by one agent for one turn
+enum class ActionType {
+    none, // No (valid) answer: the agent only keeps its place
+    move,
+    attack,
+    defend
+};
+
+struct Action {
+    ActionType type;
+    Direction direction;
+
+    Action(ActionType t = ActionType::none, Direction d = Direction::NORTH) : type(t), direction(d) {}
+};
+
+// Rule constants
+constexpr int ATTACK_DAMAGE = 20;  // Damage dealt by one attack
+constexpr int BASE_HEAL = 5;       // HP recovered per turn next to the own base
+constexpr int SPAWN_HP = 100;      // Starting HP of every agent
+
+// "move_north", "attack_west", ... as constant strings, the inverse of
+// parseAction; "" for ActionType::none
+std::string_view actionName(ActionType type, Direction direction);
+
+// Parses "move_north", "attack_west", "defend_south" (a space is also accepted
+// as separator). Anything else, including "send_message:...", is ActionType::none.
+Action parseAction(std::string_view text);
+
+// Applies one turn. actions[i] is the action of state.agents[i]; missing
+// entries count as ActionType::none. Resolution is simultaneous:
+//   1. every acting agent turns to face its action direction;
+//   2. attacks hit the enemy agent or enemy base in the faced cell, using the
+//      positions at the start of the turn; defending halves incoming damage;
+//   3. agents and bases at 0 HP die;
+//   4. surviving movers step into their target cell if it is inside the map and
+//      free of living agents; when several movers target the same cell the one
+//      with the lowest index wins;
+//   5. living agents next to their own base recover BASE_HEAL.
+// The result depends only on the state and the actions, never on the order in
+// which they were received. The per-cell work arrays come from scratch, so a
+// caller that resolves many small turns can hand it an arena.
+void resolveTurn(GameState& state, const std::vector<Action>& actions,
+                 std::pmr::memory_resource* scratch = std::pmr::get_default_resource());
+
+// Same rules and the same result as resolveTurn, computed in parallel on pool.
+// The map is cut into tile_size x tile_size tiles and each tile resolves the
+// agents standing on it. Effects that land on another tile (an attack or a
+// move across the border) are posted to the target tile and merged there
+// after a barrier; damage is summed and move claims take the lowest index,
+// so the merge order never changes the outcome.
+void resolveTurn(GameState& state, const std::vector<Action>& actions, concurrency::ThreadPool& pool,
+                 int tile_size = 32);
+
+// Sets game_over and winner when a base is destroyed, a team is wiped out or
+// max_turns is reached (the team with more total HP wins, "" on a tie).
+bool checkGameOver(GameState& state);
+
+} // namespace game
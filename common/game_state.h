@@ -1,7 +1,9 @@
 // common/game_state.h
 // Defines the structures and enums for the game state 
 #pragma once
+#include <memory_resource>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace game {
@@ -43,7 +45,7 @@ inline Direction getOppositeDirection(Direction dir) {
     }
 }
 
-inline Direction getDirectionFromString(const std::string& dirStr) {
+inline Direction getDirectionFromString(std::string_view dirStr) {
     if (dirStr == "north") return Direction::NORTH;
     if (dirStr == "south") return Direction::SOUTH;
     if (dirStr == "east") return Direction::EAST;
@@ -51,7 +53,7 @@ inline Direction getDirectionFromString(const std::string& dirStr) {
     return Direction::NORTH; // default
 }
 
-inline std::string getStringFromDirection(Direction dir) {
+inline std::string_view directionName(Direction dir) { // Constant storage, no allocation
     switch(dir) {
         case Direction::NORTH: return "north";
         case Direction::SOUTH: return "south";
@@ -61,30 +63,64 @@ inline std::string getStringFromDirection(Direction dir) {
     }
 }
 
-// Agent state
+inline std::string getStringFromDirection(Direction dir) {
+    return std::string(directionName(dir));
+}
+
+// Agent state. Allocator-aware: inside a GameState built on a TurnArena the
+// id and team strings are carved from the same arena as the agents vector.
 struct Agent {
-    std::string id;
-    std::string team;
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    std::pmr::string id;
+    std::pmr::string team;
     Position position;
     Direction facing;
     int hp;
     int max_hp;
     bool is_alive;
     
-    Agent(const std::string& id, const std::string& team, Position pos, int hp = 100)
-        : id(id), team(team), position(pos), facing(Direction::NORTH), hp(hp), max_hp(hp), is_alive(true) {}
+    Agent(std::string_view id, std::string_view team, Position pos, int hp = 100,
+          const allocator_type& alloc = {})
+        : id(id, alloc), team(team, alloc), position(pos), facing(Direction::NORTH), hp(hp), max_hp(hp),
+          is_alive(true) {}
+    Agent(std::string_view id, std::string_view team, Position pos, const allocator_type& alloc)
+        : Agent(id, team, pos, 100, alloc) {}
+    Agent(const Agent& other, const allocator_type& alloc)
+        : id(other.id, alloc), team(other.team, alloc), position(other.position), facing(other.facing),
+          hp(other.hp), max_hp(other.max_hp), is_alive(other.is_alive) {}
+    Agent(Agent&& other, const allocator_type& alloc)
+        : id(std::move(other.id), alloc), team(std::move(other.team), alloc), position(other.position),
+          facing(other.facing), hp(other.hp), max_hp(other.max_hp), is_alive(other.is_alive) {}
+    Agent(const Agent&) = default;
+    Agent(Agent&&) = default;
+    Agent& operator=(const Agent&) = default;
+    Agent& operator=(Agent&&) = default;
 };
 
 // Base structure
 struct Base {
-    std::string team;
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    std::pmr::string team;
     Position position;
     int hp;
     int max_hp;
     bool is_destroyed;
     
-    Base(const std::string& team, Position pos, int hp = 500)
-        : team(team), position(pos), hp(hp), max_hp(hp), is_destroyed(false) {}
+    Base(std::string_view team, Position pos, int hp = 500, const allocator_type& alloc = {})
+        : team(team, alloc), position(pos), hp(hp), max_hp(hp), is_destroyed(false) {}
+    Base(std::string_view team, Position pos, const allocator_type& alloc) : Base(team, pos, 500, alloc) {}
+    Base(const Base& other, const allocator_type& alloc)
+        : team(other.team, alloc), position(other.position), hp(other.hp), max_hp(other.max_hp),
+          is_destroyed(other.is_destroyed) {}
+    Base(Base&& other, const allocator_type& alloc)
+        : team(std::move(other.team), alloc), position(other.position), hp(other.hp), max_hp(other.max_hp),
+          is_destroyed(other.is_destroyed) {}
+    Base(const Base&) = default;
+    Base(Base&&) = default;
+    Base& operator=(const Base&) = default;
+    Base& operator=(Base&&) = default;
 };
 
 // Game configuration
@@ -96,16 +132,31 @@ struct GameConfig {
     GameConfig() : map_width(20), map_height(20), max_turns(500) {}
 };
 
-// Game state
+// Game state. Everything it owns comes from one memory resource, the default
+// heap unless another is given. Copies always go back to the default heap, so
+// a copy outlives the arena of the original; moves keep the resource.
 struct GameState {
-    std::vector<Agent> agents;
-    std::vector<Base> bases;
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+
+    std::pmr::vector<Agent> agents;
+    std::pmr::vector<Base> bases;
     int current_turn;
     bool game_over;
-    std::string winner;
+    std::pmr::string winner;
     GameConfig config;
     
-    GameState() : current_turn(0), game_over(false) {}
+    GameState() : GameState(allocator_type()) {}
+    explicit GameState(const allocator_type& alloc)
+        : agents(alloc), bases(alloc), current_turn(0), game_over(false), winner(alloc) {}
+    GameState(const GameState& other, const allocator_type& alloc)
+        : agents(other.agents, alloc), bases(other.bases, alloc), current_turn(other.current_turn),
+          game_over(other.game_over), winner(other.winner, alloc), config(other.config) {}
+    GameState(const GameState&) = default;
+    GameState(GameState&&) = default;
+    GameState& operator=(const GameState&) = default;
+    GameState& operator=(GameState&&) = default;
+
+    allocator_type get_allocator() const { return agents.get_allocator(); }
 };
 
 } // namespace game
\ No newline at end of file
@@ -0,0 +1,136 @@
+// common/game_state_cache.cpp
+// Implements the turn-keyed decoded state cache
+#include "game_state_cache.h"
+#include "metrics.h"
+
+namespace game {
+
+namespace {
+
+struct CacheCounters {
+    metrics::Counter& hits;
+    metrics::Counter& misses;
+    metrics::Counter& waits;
+    metrics::Counter& failures;
+    metrics::Counter& evictions;
+    metrics::Counter& parse_ns;
+    metrics::Counter& saved_ns;
+};
+
+CacheCounters& exported() {
+    static CacheCounters counters{metrics::Registry::global().counter("game_state_cache_hits_total"),
+                                  metrics::Registry::global().counter("game_state_cache_misses_total"),
+                                  metrics::Registry::global().counter("game_state_cache_waits_total"),
+                                  metrics::Registry::global().counter("game_state_cache_failures_total"),
+                                  metrics::Registry::global().counter("game_state_cache_evictions_total"),
+                                  metrics::Registry::global().counter("game_state_cache_parse_ns_total"),
+                                  metrics::Registry::global().counter("game_state_cache_saved_ns_total")};
+    return counters;
+}
+
+uint64_t nanoseconds(double ms) {
+    return static_cast<uint64_t>(ms * 1e6);
+}
+
+} // namespace
+
+GameStateCache::StatePtr GameStateCache::get(int turn, const Loader& load) {
+    std::unique_lock<std::mutex> lock(mutex);
+    bool waited = false;
+    while (true) {
+        auto it = entries.find(turn);
+        if (it == entries.end()) break; // Ours to load
+        if (!it->second.loading) {
+            counters.hits++;
+            counters.waits += waited;
+            counters.saved_ms += it->second.parse_ms;
+            exported().hits.add();
+            if (waited) exported().waits.add();
+            exported().saved_ns.add(nanoseconds(it->second.parse_ms));
+            return it->second.state;
+        }
+        waited = true;
+        loaded.wait(lock);
+        // The loader may have failed and removed the entry: then we load
+    }
+
+    entries[turn]; // Loading placeholder
+    counters.misses++;
+    exported().misses.add();
+    const uint64_t loading_match = match;
+    lock.unlock();
+
+    StatePtr state;
+    auto start = std::chrono::steady_clock::now();
+    try {
+        state = load();
+    } catch (...) {
+        lock.lock();
+        if (match == loading_match) entries.erase(turn);
+        counters.failures++;
+        exported().failures.add();
+        loaded.notify_all();
+        throw;
+    }
+    double parse_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    lock.lock();
+    counters.parse_ms += parse_ms;
+    exported().parse_ns.add(nanoseconds(parse_ms));
+    if (match != loading_match) {
+        // reset() ran meanwhile: the turn number may already mean another match
+        if (!state) {
+            counters.failures++;
+            exported().failures.add();
+        }
+    } else if (state) {
+        Entry& entry = entries[turn];
+        entry.state = state;
+        entry.loading = false;
+        entry.parse_ms = parse_ms;
+        evict();
+    } else {
+        entries.erase(turn);
+        counters.failures++;
+        exported().failures.add();
+    }
+    loaded.notify_all();
+    return state;
+}
+
+GameStateCache::StatePtr GameStateCache::find(int turn) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        auto it = entries.find(turn);
+        if (it == entries.end()) return nullptr;
+        if (!it->second.loading) return it->second.state;
+        loaded.wait(lock);
+    }
+}
+
+void GameStateCache::reset() {
+    std::lock_guard<std::mutex> lock(mutex);
+    match++;
+    entries.clear(); // Waiters on a turn that was loading find it gone and load it themselves
+    loaded.notify_all();
+}
+
+GameStateCache::Stats GameStateCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return counters;
+}
+
+void GameStateCache::evict() {
+    // Oldest finished turns go first; a turn still loading is never dropped
+    for (auto it = entries.begin(); entries.size() > capacity && it != entries.end();) {
+        if (it->second.loading) {
+            ++it;
+            continue;
+        }
+        it = entries.erase(it);
+        counters.evictions++;
+        exported().evictions.add();
+    }
+}
+
+} // namespace game
@@ -0,0 +1,76 @@
+// common/game_state_cache.h
+// Declares a process-wide, turn-keyed cache of immutable decoded game states
+#pragma once
+#include "game_state.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace game {
+
+// Co-located agents receive byte-identical states for the same turn. The first
+// request for turn T decodes it; requests that arrive while it is being
+// decoded wait for that result, later ones reuse it. Only the newest capacity
+// turns are kept (a delta needs the previous turn as its base).
+//
+// Loaders return nullptr (or throw) on failure. Nothing is cached then, so
+// the next request for the turn tries again with its own frame.
+//
+// Turn numbers restart with every match: reset() drops what the previous
+// match left, and a decode still running across it is not cached. The
+// counters below are also exported, for every cache of the process together,
+// as game_state_cache_*_total in metrics::Registry::global().
+class GameStateCache {
+public:
+    using StatePtr = std::shared_ptr<const GameState>;
+    using Loader = std::function<StatePtr()>;
+
+    struct Stats {
+        uint64_t hits = 0;      // Served from the cache, including after a wait
+        uint64_t misses = 0;    // Decoded by the caller
+        uint64_t waits = 0;     // Hits that had to wait for a decode in progress
+        uint64_t failures = 0;  // Loader returned nullptr or threw
+        uint64_t evictions = 0;
+        double parse_ms = 0;    // Time spent in loaders
+        double saved_ms = 0;    // Decode time of the turn, summed over every hit
+
+        double hitRate() const { return hits + misses == 0 ? 0 : static_cast<double>(hits) / (hits + misses); }
+    };
+
+private:
+    struct Entry {
+        StatePtr state;
+        bool loading = true;
+        double parse_ms = 0;
+    };
+
+    size_t capacity;
+    mutable std::mutex mutex;
+    std::condition_variable loaded;
+    std::map<int, Entry> entries; // By turn, oldest first
+    uint64_t match = 0;           // Bumped by reset()
+    Stats counters;
+
+public:
+    explicit GameStateCache(size_t capacity = 4) : capacity(capacity < 1 ? 1 : capacity) {}
+
+    // State of turn, from the cache or from load
+    StatePtr get(int turn, const Loader& load);
+
+    // State of turn if cached, waiting for a decode in progress; nullptr otherwise
+    StatePtr find(int turn);
+
+    // Forgets every turn, at the end of a match
+    void reset();
+
+    Stats stats() const;
+
+private:
+    void evict(); // Called with mutex held
+};
+
+} // namespace game
@@ -0,0 +1,125 @@
+// common/game_state_soa.cpp
+// Implements the structure-of-arrays GameState and its conversions
+#include "game_state_soa.h"
+
+namespace game {
+
+uint32_t StringInterner::intern(std::string_view name) {
+    auto it = index.find(name);
+    if (it != index.end()) return it->second;
+
+    uint32_t id = static_cast<uint32_t>(names.size());
+    names.emplace_back(name);
+    index.emplace(names.back(), id);
+    return id;
+}
+
+uint32_t StringInterner::find(std::string_view name) const {
+    auto it = index.find(name);
+    return it == index.end() ? NONE : it->second;
+}
+
+void GameStateSoA::clear() {
+    x.clear();
+    y.clear();
+    hp.clear();
+    max_hp.clear();
+    facing.clear();
+    team_id.clear();
+    previous_agent_id.swap(agent_id);
+    agent_id.clear();
+    alive_bits.clear();
+    base_x.clear();
+    base_y.clear();
+    base_hp.clear();
+    base_max_hp.clear();
+    base_team_id.clear();
+    base_destroyed.clear();
+    current_turn = 0;
+    game_over = false;
+    winner.clear();
+}
+
+size_t GameStateSoA::addAgent(std::string_view id, std::string_view team) {
+    size_t i = x.size();
+    x.push_back(0);
+    y.push_back(0);
+    hp.push_back(0);
+    max_hp.push_back(0);
+    facing.push_back(static_cast<uint8_t>(Direction::NORTH));
+    team_id.push_back(static_cast<uint16_t>(teams.intern(team)));
+    if (i < previous_agent_id.size() && ids.name(previous_agent_id[i]) == id) {
+        agent_id.push_back(previous_agent_id[i]);
+    } else {
+        agent_id.push_back(ids.intern(id));
+    }
+    if ((i & 63) == 0) alive_bits.push_back(0);
+    return i;
+}
+
+size_t GameStateSoA::addBase(std::string_view team) {
+    size_t i = base_x.size();
+    base_x.push_back(0);
+    base_y.push_back(0);
+    base_hp.push_back(0);
+    base_max_hp.push_back(0);
+    base_team_id.push_back(static_cast<uint16_t>(teams.intern(team)));
+    base_destroyed.push_back(0);
+    return i;
+}
+
+void toSoA(const GameState& state, GameStateSoA& out) {
+    out.clear();
+    out.current_turn = state.current_turn;
+    out.game_over = state.game_over;
+    out.winner = state.winner;
+    out.config = state.config;
+
+    for (const Agent& agent : state.agents) {
+        size_t i = out.addAgent(agent.id, agent.team);
+        out.x[i] = agent.position.x;
+        out.y[i] = agent.position.y;
+        out.hp[i] = agent.hp;
+        out.max_hp[i] = agent.max_hp;
+        out.facing[i] = static_cast<uint8_t>(agent.facing);
+        out.setAlive(i, agent.is_alive);
+    }
+    for (const Base& base : state.bases) {
+        size_t i = out.addBase(base.team);
+        out.base_x[i] = base.position.x;
+        out.base_y[i] = base.position.y;
+        out.base_hp[i] = base.hp;
+        out.base_max_hp[i] = base.max_hp;
+        out.base_destroyed[i] = base.is_destroyed;
+    }
+}
+
+void toAoS(const GameStateSoA& soa, GameState& out) {
+    out.current_turn = soa.current_turn;
+    out.game_over = soa.game_over;
+    out.winner = soa.winner;
+    out.config = soa.config;
+
+    out.agents.clear();
+    out.agents.reserve(soa.agentCount());
+    for (size_t i = 0; i < soa.agentCount(); ++i) {
+        out.agents.emplace_back(soa.ids.name(soa.agent_id[i]), soa.teams.name(soa.team_id[i]),
+                                Position(soa.x[i], soa.y[i]), soa.hp[i]);
+        Agent& agent = out.agents.back();
+        agent.max_hp = soa.max_hp[i];
+        agent.facing = static_cast<Direction>(soa.facing[i]);
+        agent.is_alive = soa.alive(i);
+    }
+
+    out.bases.clear();
+    out.bases.reserve(soa.baseCount());
+    for (size_t i = 0; i < soa.baseCount(); ++i) {
+        out.bases.emplace_back(soa.teams.name(soa.base_team_id[i]), Position(soa.base_x[i], soa.base_y[i]),
+                               soa.base_hp[i]);
+        Base& base = out.bases.back();
+        base.max_hp = soa.base_max_hp[i];
+        base.is_destroyed = soa.base_destroyed[i] != 0;
+    }
+}
+
+} // namespace game
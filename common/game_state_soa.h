@@ -0,0 +1,94 @@
+// common/game_state_soa.h
+// Declares a structure-of-arrays layout of GameState with interned team and agent ids
+#pragma once
+#include "game_state.h"
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace game {
+
+// Maps strings to small dense ids, in order of first appearance. Ids are
+// stable for the lifetime of the interner, so they can be kept across turns.
+// Move-only: the index views point into this interner's own names.
+class StringInterner {
+private:
+    std::deque<std::string> names;                        // Deque: views in index stay valid
+    std::unordered_map<std::string_view, uint32_t> index;
+
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    StringInterner(StringInterner&&) = default;            // Moving a deque keeps its elements in place
+    StringInterner& operator=(StringInterner&&) = default;
+
+    uint32_t intern(std::string_view name);
+    uint32_t find(std::string_view name) const; // NONE if never interned
+    const std::string& name(uint32_t id) const { return names[id]; }
+    size_t size() const { return names.size(); }
+};
+
+// GameState with one contiguous array per field. Hot loops over agents touch
+// only the arrays they need (positions and teams, say) instead of striding
+// over two std::strings per agent, and team checks are integer compares.
+// Agent i of the SoA is state.agents[i] of the AoS form, likewise for bases.
+// Move-only, like its interners; toAoS gives a copyable form.
+struct GameStateSoA {
+    // Agents
+    std::vector<int32_t> x;
+    std::vector<int32_t> y;
+    std::vector<int32_t> hp;
+    std::vector<int32_t> max_hp;
+    std::vector<uint8_t> facing;      // Direction
+    std::vector<uint16_t> team_id;    // Into teams
+    std::vector<uint32_t> agent_id;   // Into ids
+    std::vector<uint64_t> alive_bits; // Bit i % 64 of word i / 64
+
+    // Bases
+    std::vector<int32_t> base_x;
+    std::vector<int32_t> base_y;
+    std::vector<int32_t> base_hp;
+    std::vector<int32_t> base_max_hp;
+    std::vector<uint16_t> base_team_id;
+    std::vector<uint8_t> base_destroyed;
+
+    int current_turn = 0;
+    bool game_over = false;
+    std::string winner;
+    GameConfig config;
+
+    // Keep their ids when the arrays are refilled for the next turn
+    StringInterner teams;
+    StringInterner ids;
+    std::vector<uint32_t> previous_agent_id; // agent_id before clear(), checked before hashing
+
+    size_t agentCount() const { return x.size(); }
+    size_t baseCount() const { return base_x.size(); }
+
+    bool alive(size_t i) const { return (alive_bits[i >> 6] >> (i & 63)) & 1; }
+    void setAlive(size_t i, bool value) {
+        uint64_t mask = uint64_t(1) << (i & 63);
+        alive_bits[i >> 6] = value ? (alive_bits[i >> 6] | mask) : (alive_bits[i >> 6] & ~mask);
+    }
+
+    // Empties the arrays, keeping their capacity and the interned names
+    void clear();
+    // Appends an agent or base; team and id are interned. Agents usually come
+    // in the same order every turn, so the id the same slot had last time is
+    // compared first and the hash lookup is only a fallback.
+    size_t addAgent(std::string_view id, std::string_view team);
+    size_t addBase(std::string_view team);
+};
+
+// Conversions between the two layouts. The target's interners are reused,
+// so converting every turn into the same GameStateSoA keeps ids stable.
+void toSoA(const GameState& state, GameStateSoA& out);
+void toAoS(const GameStateSoA& soa, GameState& out);
+
+} // namespace game
@@ -0,0 +1,170 @@
+// common/json_cursor.cpp
+// Implements the single-pass JSON tokenizer
+#include "json_cursor.h"
+#include <climits>
+
+namespace rpc {
+
+bool JsonCursor::nextKey(std::string_view& key) {
+    skipWhitespace();
+    if (cur >= end) return false;
+    if (*cur == '}') { // End of object
+        ++cur;
+        return false;
+    }
+    if (*cur == ',') ++cur; // Separator between members
+
+    if (!readString(key)) return false;
+    return consume(':');
+}
+
+bool JsonCursor::nextElement() {
+    skipWhitespace();
+    if (cur >= end) return false;
+    if (*cur == ']') { // End of array
+        ++cur;
+        return false;
+    }
+    if (*cur == ',') ++cur; // Separator between elements
+    skipWhitespace();
+    return cur < end;
+}
+
+bool JsonCursor::readString(std::string_view& raw) {
+    if (!consume('"')) return false;
+    const char* start = cur;
+    while (cur < end && *cur != '"') {
+        if (*cur == '\\') ++cur; // Skip the escaped character
+        ++cur;
+    }
+    if (cur >= end) return false; // Unterminated string
+    raw = std::string_view(start, static_cast<size_t>(cur - start));
+    ++cur; // Closing quote
+    return true;
+}
+
+namespace {
+
+// Copies a raw string body into out, resolving escapes
+template <typename String>
+void unescapeInto(std::string_view raw, String& out) {
+    // Fast path: nothing to unescape
+    if (raw.find('\\') == std::string_view::npos) {
+        out.assign(raw.data(), raw.size());
+        return;
+    }
+
+    out.clear();
+    for (size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c != '\\' || i + 1 >= raw.size()) {
+            out += c;
+            continue;
+        }
+        switch (raw[++i]) {
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            default: out += raw[i]; break; // \" \\ \/ and anything unknown
+        }
+    }
+}
+
+} // namespace
+
+bool JsonCursor::readString(std::string& out) {
+    std::string_view raw;
+    if (!readString(raw)) return false;
+    unescapeInto(raw, out);
+    return true;
+}
+
+bool JsonCursor::readString(std::pmr::string& out) {
+    std::string_view raw;
+    if (!readString(raw)) return false;
+    unescapeInto(raw, out);
+    return true;
+}
+
+bool JsonCursor::readInt(int& out) {
+    skipWhitespace();
+    bool negative = false;
+    if (cur < end && (*cur == '-' || *cur == '+')) {
+        negative = (*cur == '-');
+        ++cur;
+    }
+    if (cur >= end || *cur < '0' || *cur > '9') return false;
+
+    // Out of range fails, as std::stoi would throw
+    const long long limit = negative ? -static_cast<long long>(INT_MIN) : INT_MAX;
+    long long value = 0;
+    while (cur < end && *cur >= '0' && *cur <= '9') {
+        value = value * 10 + (*cur - '0');
+        if (value > limit) return false;
+        ++cur;
+    }
+    // Truncate fractional or exponent parts, like std::stoi would
+    while (cur < end && (*cur == '.' || *cur == 'e' || *cur == 'E' ||
+                         *cur == '-' || *cur == '+' || (*cur >= '0' && *cur <= '9'))) {
+        ++cur;
+    }
+    out = static_cast<int>(negative ? -value : value);
+    return true;
+}
+
+bool JsonCursor::readBool(bool& out) {
+    skipWhitespace();
+    std::string_view rest(cur, static_cast<size_t>(end - cur));
+    if (rest.substr(0, 4) == "true") {
+        cur += 4;
+        out = true;
+        return true;
+    }
+    if (rest.substr(0, 5) == "false") {
+        cur += 5;
+        out = false;
+        return true;
+    }
+    return false;
+}
+
+bool JsonCursor::skipValue() {
+    skipWhitespace();
+    if (cur >= end) return false;
+    switch (*cur) {
+        case '"': return skipString();
+        case '{': return skipContainer('{', '}');
+        case '[': return skipContainer('[', ']');
+        default:
+            // Numbers, true, false, null: run until the next delimiter
+            while (cur < end && *cur != ',' && *cur != '}' && *cur != ']' &&
+                   *cur != ' ' && *cur != '\n' && *cur != '\r' && *cur != '\t') {
+                ++cur;
+            }
+            return true;
+    }
+}
+
+bool JsonCursor::skipString() {
+    std::string_view ignored;
+    return readString(ignored);
+}
+
+bool JsonCursor::skipContainer(char open, char close) {
+    int depth = 0;
+    while (cur < end) {
+        char c = *cur;
+        if (c == '"') {
+            if (!skipString()) return false;
+            continue;
+        }
+        ++cur;
+        if (c == open) depth++;
+        else if (c == close && --depth == 0) return true;
+    }
+    return false; // Unbalanced container
+}
+
+} // namespace rpc
@@ -0,0 +1,68 @@
+// common/json_cursor.h
+// Declares a single-pass, allocation-free JSON tokenizer used to read RPC payloads in place
+#pragma once
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <cstddef>
+
+namespace rpc {
+
+// Forward-only cursor over a JSON buffer. It never copies the input: strings
+// are handed back as views into the original buffer and numbers are parsed
+// in place. The buffer must outlive the cursor.
+class JsonCursor {
+private:
+    const char* begin;
+    const char* cur;
+    const char* end;
+
+public:
+    explicit JsonCursor(std::string_view input)
+        : begin(input.data()), cur(input.data()), end(input.data() + input.size()) {}
+
+    // Structure
+    bool beginObject() { return consume('{'); }
+    bool beginArray() { return consume('['); }
+
+    // Advances to the next key of the current object. Returns false (and
+    // consumes the closing brace) once the object is exhausted.
+    bool nextKey(std::string_view& key);
+
+    // Advances to the next element of the current array. Returns false (and
+    // consumes the closing bracket) once the array is exhausted.
+    bool nextElement();
+
+    // Scalars
+    bool readString(std::string_view& raw);   // Raw contents, escapes untouched
+    bool readString(std::string& out);        // Unescaped copy into out
+    bool readString(std::pmr::string& out);   // Same, in out's memory resource
+    bool readInt(int& out);                   // false past the int range
+    bool readBool(bool& out);
+    bool skipValue();
+
+    // Status
+    bool atEnd() { skipWhitespace(); return cur >= end; }
+    size_t offset() const { return static_cast<size_t>(cur - begin); }
+
+private:
+    void skipWhitespace() {
+        while (cur < end && (*cur == ' ' || *cur == '\n' || *cur == '\r' || *cur == '\t')) {
+            ++cur;
+        }
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (cur < end && *cur == c) {
+            ++cur;
+            return true;
+        }
+        return false;
+    }
+
+    bool skipString();
+    bool skipContainer(char open, char close);
+};
+
+} // namespace rpc
@@ -0,0 +1,179 @@
+// common/metrics.cpp
+// Implements the metrics registry and its Prometheus text export
+#include "metrics.h"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace metrics {
+
+uint64_t Counter::value() const {
+    uint64_t total = 0;
+    for (const Shard& shard : shards) total += shard.value.load(std::memory_order_relaxed);
+    return total;
+}
+
+// Bucket g * SUB_BUCKETS + s holds [low, low + width): group 0 is exact
+// (0..15), group g >= 1 covers [16 << (g - 1), 32 << (g - 1)) in 16 steps
+size_t Histogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+    int shift = std::bit_width(value) - 1 - SUB_BITS;
+    size_t sub = static_cast<size_t>(value >> shift) & (SUB_BUCKETS - 1);
+    return (static_cast<size_t>(shift) + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t Histogram::bucketLow(size_t index) {
+    size_t group = index / SUB_BUCKETS;
+    uint64_t sub = index % SUB_BUCKETS;
+    if (group == 0) return sub;
+    return (SUB_BUCKETS + sub) << (group - 1);
+}
+
+uint64_t Histogram::bucketWidth(size_t index) {
+    size_t group = index / SUB_BUCKETS;
+    return group == 0 ? 1 : uint64_t{1} << (group - 1);
+}
+
+void Histogram::record(uint64_t value) {
+    buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(value, std::memory_order_relaxed);
+    uint64_t seen = max.load(std::memory_order_relaxed);
+    while (value > seen && !max.compare_exchange_weak(seen, value, std::memory_order_relaxed)) {}
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    // Not one atomic cut: a record racing the copy may show in the buckets and
+    // not yet in the sum, which only blurs the mean by one sample
+    Snapshot snapshot;
+    snapshot.buckets.resize(BUCKETS);
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        snapshot.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sum = sum.load(std::memory_order_relaxed);
+    snapshot.max = max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+double Histogram::Snapshot::percentile(double p) const {
+    if (count == 0) return 0;
+    uint64_t rank = static_cast<uint64_t>(std::ceil(p * static_cast<double>(count)));
+    if (rank == 0) rank = 1;
+    if (rank >= count) return static_cast<double>(max); // Known exactly
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            double middle = static_cast<double>(bucketLow(i)) + (static_cast<double>(bucketWidth(i)) - 1) / 2;
+            return std::min(middle, static_cast<double>(max));
+        }
+    }
+    return static_cast<double>(max);
+}
+
+Registry& Registry::global() {
+    static Registry registry;
+    return registry;
+}
+
+Counter& Registry::counter(std::string_view name, std::string_view labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Counter>& slot = counters[Key(name, labels)];
+    if (!slot) slot = std::make_unique<Counter>();
+    return *slot;
+}
+
+Histogram& Registry::histogram(std::string_view name, std::string_view labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unique_ptr<Histogram>& slot = histograms[Key(name, labels)];
+    if (!slot) slot = std::make_unique<Histogram>();
+    return *slot;
+}
+
+namespace {
+
+// name{labels,extra} value
+void appendSample(std::string& out, std::string_view name, std::string_view labels, std::string_view extra,
+                  double value) {
+    out += name;
+    if (!labels.empty() || !extra.empty()) {
+        out += '{';
+        out += labels;
+        if (!labels.empty() && !extra.empty()) out += ',';
+        out += extra;
+        out += '}';
+    }
+    char number[32];
+    std::snprintf(number, sizeof(number), " %.17g\n", value);
+    out += number;
+}
+
+void appendType(std::string& out, std::string_view name, std::string_view type) {
+    out += "# TYPE ";
+    out += name;
+    out += ' ';
+    out += type;
+    out += '\n';
+}
+
+} // namespace
+
+std::string Registry::prometheusText() const {
+    static constexpr std::pair<double, std::string_view> QUANTILES[] = {
+        {0.5, "quantile=\"0.5\""}, {0.9, "quantile=\"0.9\""}, {0.99, "quantile=\"0.99\""},
+        {0.999, "quantile=\"0.999\""}};
+
+    std::lock_guard<std::mutex> lock(mutex);
+    std::string out;
+    const std::string* family = nullptr;
+    for (const auto& [key, counter] : counters) {
+        if (!family || *family != key.first) appendType(out, key.first, "counter");
+        family = &key.first;
+        appendSample(out, key.first, key.second, "", static_cast<double>(counter->value()));
+    }
+
+    // Each histogram family becomes a summary and a gauge family, written one
+    // after the other so every family's samples stay together
+    for (auto begin = histograms.begin(); begin != histograms.end();) {
+        auto end = begin;
+        while (end != histograms.end() && end->first.first == begin->first.first) ++end;
+        const std::string& name = begin->first.first;
+
+        std::vector<Histogram::Snapshot> snapshots;
+        for (auto it = begin; it != end; ++it) snapshots.push_back(it->second->snapshot());
+
+        appendType(out, name, "summary");
+        size_t i = 0;
+        for (auto it = begin; it != end; ++it, ++i) {
+            const std::string& labels = it->first.second;
+            for (const auto& [p, quantile] : QUANTILES) {
+                appendSample(out, name, labels, quantile, snapshots[i].percentile(p));
+            }
+            appendSample(out, name + "_sum", labels, "", static_cast<double>(snapshots[i].sum));
+            appendSample(out, name + "_count", labels, "", static_cast<double>(snapshots[i].count));
+        }
+        appendType(out, name + "_max", "gauge");
+        i = 0;
+        for (auto it = begin; it != end; ++it, ++i) {
+            appendSample(out, name + "_max", it->first.second, "", static_cast<double>(snapshots[i].max));
+        }
+        begin = end;
+    }
+    return out;
+}
+
+bool Registry::writeFile(const std::string& path) const {
+    // Readers polling the file never see a half-written snapshot
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) return false;
+        file << prometheusText();
+        if (!file) return false;
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+} // namespace metrics
@@ -0,0 +1,128 @@
+// common/metrics.h
+// Declares the in-process metrics registry: lock-free counters and latency histograms
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace metrics {
+
+// Index of the calling thread's shard, assigned round robin on first use
+inline size_t threadShard() {
+    static std::atomic<size_t> next{0};
+    thread_local size_t shard = next.fetch_add(1, std::memory_order_relaxed);
+    return shard;
+}
+
+// Monotonic count. Every thread adds to its own cache line, so I/O threads
+// bumping the same counter never contend; reading sums the shards.
+class Counter {
+private:
+    static constexpr size_t SHARDS = 16;
+
+    struct alignas(64) Shard {
+        std::atomic<uint64_t> value{0};
+    };
+
+    std::array<Shard, SHARDS> shards;
+
+public:
+    void add(uint64_t n = 1) { shards[threadShard() % SHARDS].value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const;
+};
+
+// Log-linear histogram in the style of HdrHistogram: 16 linear buckets per
+// power of two, so any recorded value is known to within 1/16 (6.25%) over
+// the whole uint64_t range. Recording is one relaxed increment plus the sum;
+// there is no lock and no allocation.
+class Histogram {
+public:
+    static constexpr int SUB_BITS = 4;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    // Copy of the buckets at one point in time
+    struct Snapshot {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+        std::vector<uint64_t> buckets; // BUCKETS entries
+
+        double mean() const { return count == 0 ? 0 : static_cast<double>(sum) / count; }
+        double percentile(double p) const; // p in [0, 1], midpoint of the bucket holding it
+    };
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+
+public:
+    void record(uint64_t value);
+    Snapshot snapshot() const;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketLow(size_t index);   // Smallest value of the bucket
+    static uint64_t bucketWidth(size_t index);
+};
+
+// Records the time from construction to destruction, in nanoseconds
+class ScopedTimer {
+private:
+    Histogram& histogram;
+    std::chrono::steady_clock::time_point start;
+
+public:
+    explicit ScopedTimer(Histogram& histogram) : histogram(histogram), start(std::chrono::steady_clock::now()) {}
+    ~ScopedTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+};
+
+// Named counters and histograms. Lookups take a lock, so call sites fetch
+// their metric once (e.g. into a static reference) and keep it; metrics are
+// never removed, references stay valid for the life of the registry.
+//
+// A series is a family name plus optional Prometheus labels without braces,
+// e.g. histogram("rpc_round_trip_ns", "type=\"play_turn\"").
+class Registry {
+private:
+    using Key = std::pair<std::string, std::string>; // Family, labels
+
+    mutable std::mutex mutex;
+    std::map<Key, std::unique_ptr<Counter>> counters;     // Sorted: a family's series are adjacent
+    std::map<Key, std::unique_ptr<Histogram>> histograms;
+
+public:
+    static Registry& global(); // What the networking, protocol and agent code record into
+
+    Counter& counter(std::string_view name, std::string_view labels = "");
+    Histogram& histogram(std::string_view name, std::string_view labels = "");
+
+    // Prometheus text exposition format (0.0.4). Histograms are written as
+    // summaries (p50, p90, p99, p999, _sum, _count) plus a <name>_max gauge.
+    std::string prometheusText() const;
+    bool writeFile(const std::string& path) const; // Same text, replaced atomically
+};
+
+// Round-trip histogram of one request type, in nanoseconds
+inline Histogram& rpcRoundTrip(std::string_view type) {
+    std::string labels = "type=\"";
+    labels += type;
+    labels += '"';
+    return Registry::global().histogram("rpc_round_trip_ns", labels);
+}
+
+} // namespace metrics
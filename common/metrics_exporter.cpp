@@ -0,0 +1,105 @@
+// common/metrics_exporter.cpp
+// Implements the metrics file export and the Prometheus text endpoint
+#include "metrics_exporter.h"
+#include "tcp_connection.h"
+#include <poll.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstdlib>
+#include <iostream>
+
+namespace metrics {
+
+namespace {
+
+constexpr int POLL_INTERVAL_MS = 100;    // Upper bound on how long stop() waits for the thread
+constexpr int REQUEST_TIMEOUT_MS = 1000; // A scraper that sends nothing is dropped
+constexpr size_t MAX_REQUEST_BYTES = 8192;
+
+// Reads until the blank line that ends the request headers; the request
+// itself does not matter, every path gets the metrics
+bool readRequest(int fd) {
+    std::string request;
+    char chunk[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_BYTES) {
+        pollfd ready{fd, POLLIN, 0};
+        if (poll(&ready, 1, REQUEST_TIMEOUT_MS) <= 0) return false;
+        ssize_t result = recv(fd, chunk, sizeof(chunk), 0);
+        if (result < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) continue;
+        if (result <= 0) return false;
+        request.append(chunk, static_cast<size_t>(result));
+    }
+    return true;
+}
+
+bool writeAll(int fd, const std::string& data) {
+    size_t offset = 0;
+    while (offset < data.size()) {
+        ssize_t result = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) return false;
+        offset += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+} // namespace
+
+Exporter::Exporter(const Registry& registry) : registry(registry), running(false) {}
+
+Exporter::~Exporter() {
+    stop();
+    flush();
+}
+
+bool Exporter::serve(int port) {
+    if (running) return false;
+    server = std::make_unique<net::TcpServer>(port, 16);
+    server->setNonBlocking(true); // The thread polls so that stop() is noticed
+    server->setLogConnections(false);
+    if (!server->start()) {
+        server.reset();
+        return false;
+    }
+    running = true;
+    thread = std::thread(&Exporter::serveLoop, this);
+    return true;
+}
+
+bool Exporter::flush() const {
+    if (file_path.empty()) return false;
+    return registry.writeFile(file_path);
+}
+
+void Exporter::stop() {
+    running = false;
+    if (thread.joinable()) thread.join();
+    if (server) server->stop();
+}
+
+void Exporter::configureFromEnvironment() {
+    if (const char* path = std::getenv("TP4_METRICS_FILE")) writeTo(path);
+    if (const char* port = std::getenv("TP4_METRICS_PORT")) {
+        if (!serve(std::atoi(port))) std::cerr << "Could not serve metrics on port " << port << std::endl;
+    }
+}
+
+void Exporter::serveLoop() {
+    pollfd listener{server->getServerFd(), POLLIN, 0};
+    while (running) {
+        if (poll(&listener, 1, POLL_INTERVAL_MS) <= 0) continue;
+        while (std::unique_ptr<net::TcpConnection> connection = server->acceptConnection()) {
+            int fd = connection->getSocketFd();
+            if (!readRequest(fd)) continue; // Closed with the connection
+            connection->setNonBlocking(false);
+            std::string body = registry.prometheusText();
+            std::string response = "HTTP/1.0 200 OK\r\n"
+                                   "Content-Type: text/plain; version=0.0.4\r\n"
+                                   "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                                   "Connection: close\r\n\r\n";
+            if (writeAll(fd, response)) writeAll(fd, body);
+        }
+    }
+}
+
+} // namespace metrics
@@ -0,0 +1,46 @@
+// common/metrics_exporter.h
+// Declares the exporter that publishes registry snapshots to a file or a Prometheus endpoint
+#pragma once
+#include "metrics.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace net {
+class TcpServer;
+}
+
+namespace metrics {
+
+// Serves Registry::prometheusText over plain HTTP (any path, one response
+// per connection) from a TcpServer on its own thread, and/or writes it to a
+// file on flush() and when destroyed. Both are off until configured.
+class Exporter {
+private:
+    const Registry& registry;
+    std::unique_ptr<net::TcpServer> server;
+    std::thread thread;
+    std::atomic<bool> running;
+    std::string file_path;
+
+public:
+    explicit Exporter(const Registry& registry = Registry::global());
+    ~Exporter(); // Stops serving and writes the file one last time
+
+    Exporter(const Exporter&) = delete;
+    Exporter& operator=(const Exporter&) = delete;
+
+    bool serve(int port);                 // Starts the endpoint thread
+    void writeTo(const std::string& path) { file_path = path; }
+    bool flush() const;                   // Writes the file now, false if none is set or it failed
+    void stop();
+
+    // TP4_METRICS_PORT serves the endpoint, TP4_METRICS_FILE sets the file
+    void configureFromEnvironment();
+
+private:
+    void serveLoop();
+};
+
+} // namespace metrics
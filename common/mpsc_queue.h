@@ -0,0 +1,65 @@
+// common/mpsc_queue.h
+// Declares a lock-free multi-producer/single-consumer queue
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace concurrency {
+
+// Producers push onto an intrusive stack with one compare-and-swap; the
+// consumer detaches the whole stack with one exchange and walks it oldest
+// first. Nothing ever waits on another thread, and the consumer pays one
+// atomic operation per batch instead of one per element.
+//
+// Any thread may push. Only one thread at a time may consume.
+template <typename T>
+class MpscQueue {
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> head; // Newest first
+
+public:
+    MpscQueue() : head(nullptr) {}
+    ~MpscQueue() { consumeAll([](T&&) {}); }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value) {
+        Node* node = new Node{std::move(value), head.load(std::memory_order_relaxed)};
+        while (!head.compare_exchange_weak(node->next, node, std::memory_order_release,
+                                           std::memory_order_relaxed)) {}
+    }
+
+    // Calls fn on every element pushed so far, in push order (per producer;
+    // pushes racing each other are ordered by who won the CAS). Returns the count.
+    template <typename Fn>
+    size_t consumeAll(Fn&& fn) {
+        Node* newest = head.exchange(nullptr, std::memory_order_acquire);
+        Node* oldest = nullptr;
+        while (newest) { // Reverse into push order
+            Node* next = newest->next;
+            newest->next = oldest;
+            oldest = newest;
+            newest = next;
+        }
+        size_t count = 0;
+        while (oldest) {
+            Node* next = oldest->next;
+            fn(std::move(oldest->value));
+            delete oldest;
+            oldest = next;
+            ++count;
+        }
+        return count;
+    }
+
+    bool empty() const { return head.load(std::memory_order_acquire) == nullptr; }
+};
+
+} // namespace concurrency
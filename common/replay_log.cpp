@@ -0,0 +1,311 @@
+// common/replay_log.cpp
+// Implements the binary match log writer and the mmap-based reader
+#include "replay_log.h"
+#include "binary_codec.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+namespace replay {
+
+namespace {
+
+// Fixed-width fields are stored in host order, which every target of this
+// project (x86-64, AArch64) has little-endian
+void appendU32(std::string& out, uint32_t value) { out.append(reinterpret_cast<const char*>(&value), 4); }
+void appendU64(std::string& out, uint64_t value) { out.append(reinterpret_cast<const char*>(&value), 8); }
+
+uint32_t loadU32(const char* at) {
+    uint32_t value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+uint64_t loadU64(const char* at) {
+    uint64_t value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+// Writer
+
+ReplayWriter::ReplayWriter() : fd(-1), offset(0), keyframe_interval(DEFAULT_KEYFRAME_INTERVAL) {}
+
+ReplayWriter::~ReplayWriter() {
+    close();
+}
+
+bool ReplayWriter::open(const std::string& path, const game::GameConfig& config, uint32_t interval) {
+    close();
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) return false;
+
+    keyframe_interval = std::max<uint32_t>(1, interval);
+    index.clear();
+    offset = 0;
+    std::string header(MAGIC, sizeof(MAGIC));
+    appendU32(header, VERSION);
+    appendU32(header, keyframe_interval);
+    appendU32(header, static_cast<uint32_t>(config.map_width));
+    appendU32(header, static_cast<uint32_t>(config.map_height));
+    appendU32(header, static_cast<uint32_t>(config.max_turns));
+    if (!writeAll(header)) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool ReplayWriter::recordTurn(const game::GameState& state, const std::vector<game::Action>& actions) {
+    if (fd < 0) return false;
+
+    // Body first, behind a placeholder for the record header
+    record.assign(RECORD_HEADER_SIZE, '\0');
+    rpc::BinaryWriter writer(record);
+    writer.varint(static_cast<uint64_t>(state.current_turn));
+
+    uint32_t entry = static_cast<uint32_t>(index.size());
+    uint32_t keyframe = index.empty() ? entry : index.back().keyframe;
+    uint8_t kind = RECORD_DELTA;
+    encoded.clear();
+    if (index.empty() || entry - keyframe >= keyframe_interval ||
+        !rpc::encodeGameStateDelta(previous, state, encoded)) {
+        // Due, or the agents/bases changed and a delta cannot describe it
+        encoded.clear();
+        rpc::encodeGameState(state, encoded);
+        kind = RECORD_SNAPSHOT;
+        keyframe = entry;
+    }
+    writer.string(encoded);
+    writer.varint(actions.size());
+    for (const game::Action& action : actions) writer.byte(packAction(action));
+
+    uint32_t body = static_cast<uint32_t>(record.size() - RECORD_HEADER_SIZE);
+    std::memcpy(record.data(), &body, sizeof(body));
+    record[4] = static_cast<char>(kind);
+    if (!writeAll(record)) return false;
+
+    index.push_back(IndexEntry{offset - record.size(), keyframe, state.current_turn});
+    previous = state;
+    return true;
+}
+
+bool ReplayWriter::close() {
+    if (fd < 0) return true;
+
+    std::string tail;
+    uint64_t index_offset = offset;
+    appendU32(tail, static_cast<uint32_t>(index.size() * INDEX_ENTRY_SIZE));
+    tail += static_cast<char>(RECORD_INDEX);
+    for (const IndexEntry& entry : index) {
+        appendU64(tail, entry.offset);
+        appendU32(tail, entry.keyframe);
+        appendU32(tail, static_cast<uint32_t>(entry.turn));
+    }
+    appendU64(tail, index_offset);
+    appendU64(tail, index.size());
+    tail.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    bool ok = writeAll(tail);
+    ok = (::close(fd) == 0) && ok;
+    fd = -1;
+    return ok;
+}
+
+bool ReplayWriter::writeAll(std::string_view bytes) {
+    while (!bytes.empty()) {
+        ssize_t result = ::write(fd, bytes.data(), bytes.size());
+        if (result < 0 && errno == EINTR) continue;
+        if (result <= 0) return false;
+        bytes.remove_prefix(static_cast<size_t>(result));
+        offset += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// Reader
+
+ReplayReader::ReplayReader()
+    : fd(-1), data(nullptr), size(0), keyframe_interval(DEFAULT_KEYFRAME_INTERVAL), turns_end(0), indexed(false) {}
+
+ReplayReader::~ReplayReader() {
+    close();
+}
+
+bool ReplayReader::open(const std::string& path) {
+    close();
+    fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < HEADER_SIZE) {
+        close();
+        return false;
+    }
+    size = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+        data = nullptr;
+        close();
+        return false;
+    }
+    data = static_cast<const char*>(mapping);
+
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || loadU32(data + 8) != VERSION) {
+        close();
+        return false;
+    }
+    keyframe_interval = loadU32(data + 12);
+    game_config.map_width = static_cast<int32_t>(loadU32(data + 16));
+    game_config.map_height = static_cast<int32_t>(loadU32(data + 20));
+    game_config.max_turns = static_cast<int32_t>(loadU32(data + 24));
+
+    indexed = loadIndex();
+    if (!indexed) rebuildIndex();
+    return true;
+}
+
+void ReplayReader::close() {
+    if (data) munmap(const_cast<char*>(data), size);
+    if (fd >= 0) ::close(fd);
+    data = nullptr;
+    fd = -1;
+    size = 0;
+    turns_end = 0;
+    index.clear();
+    indexed = false;
+}
+
+bool ReplayReader::loadIndex() {
+    if (size < HEADER_SIZE + FOOTER_SIZE) return false;
+    const char* footer = data + size - FOOTER_SIZE;
+    if (std::memcmp(footer + 16, INDEX_MAGIC, sizeof(INDEX_MAGIC)) != 0) return false;
+
+    uint64_t index_offset = loadU64(footer);
+    uint64_t count = loadU64(footer + 8);
+    if (index_offset < HEADER_SIZE || index_offset + RECORD_HEADER_SIZE > size - FOOTER_SIZE) return false;
+    const char* record = data + index_offset;
+    if (static_cast<uint8_t>(record[4]) != RECORD_INDEX || loadU32(record) != count * INDEX_ENTRY_SIZE ||
+        index_offset + RECORD_HEADER_SIZE + count * INDEX_ENTRY_SIZE != size - FOOTER_SIZE) {
+        return false;
+    }
+
+    index.resize(count);
+    const char* entry = record + RECORD_HEADER_SIZE;
+    for (size_t i = 0; i < index.size(); ++i) {
+        IndexEntry& e = index[i];
+        e.offset = loadU64(entry);
+        e.keyframe = loadU32(entry + 8);
+        e.turn = static_cast<int32_t>(loadU32(entry + 12));
+        // The record header must lie inside the turns, and stateAt replays
+        // from the keyframe forward: it has to come first and be a snapshot
+        if (e.offset < HEADER_SIZE || e.offset + RECORD_HEADER_SIZE > index_offset || e.keyframe > i ||
+            static_cast<uint8_t>(data[index[e.keyframe].offset + 4]) != RECORD_SNAPSHOT) {
+            index.clear();
+            return false;
+        }
+        entry += INDEX_ENTRY_SIZE;
+    }
+    turns_end = index_offset;
+    return true;
+}
+
+void ReplayReader::rebuildIndex() {
+    // Walks the records up to the first one cut short by a crash
+    index.clear();
+    uint32_t keyframe = 0;
+    size_t at = HEADER_SIZE;
+    while (at + RECORD_HEADER_SIZE <= size) {
+        uint32_t body = loadU32(data + at);
+        uint8_t kind = static_cast<uint8_t>(data[at + 4]);
+        if (body > size - at - RECORD_HEADER_SIZE) break;
+        if (kind != RECORD_SNAPSHOT && kind != RECORD_DELTA) break;
+        if (kind == RECORD_DELTA && index.empty()) break; // Nothing to apply it on
+
+        rpc::BinaryReader reader(std::string_view(data + at + RECORD_HEADER_SIZE, body));
+        int turn = static_cast<int>(reader.varint());
+        if (!reader.ok()) break;
+        if (kind == RECORD_SNAPSHOT) keyframe = static_cast<uint32_t>(index.size());
+        index.push_back(IndexEntry{at, keyframe, turn});
+        at += RECORD_HEADER_SIZE + body;
+    }
+    turns_end = at;
+}
+
+size_t ReplayReader::entryOf(int turn) const {
+    if (index.empty()) return 0;
+    // Both recorders log consecutive turns, so the entry is an offset from the first
+    int64_t guess = static_cast<int64_t>(turn) - index.front().turn;
+    if (guess >= 0 && static_cast<size_t>(guess) < index.size() && index[guess].turn == turn) {
+        return static_cast<size_t>(guess);
+    }
+    auto it = std::lower_bound(index.begin(), index.end(), turn,
+                               [](const IndexEntry& entry, int t) { return entry.turn < t; });
+    return (it != index.end() && it->turn == turn) ? static_cast<size_t>(it - index.begin()) : index.size();
+}
+
+bool ReplayReader::readTurn(size_t entry, uint8_t& kind, std::string_view& state, std::string_view& actions) const {
+    if (entry >= index.size()) return false;
+    uint64_t at = index[entry].offset;
+    if (at + RECORD_HEADER_SIZE > size) return false;
+    uint32_t body = loadU32(data + at);
+    if (body > size - at - RECORD_HEADER_SIZE) return false;
+    kind = static_cast<uint8_t>(data[at + 4]);
+
+    rpc::BinaryReader reader(std::string_view(data + at + RECORD_HEADER_SIZE, body));
+    reader.varint(); // Turn, already in the index
+    state = reader.string();
+    uint64_t count = reader.varint();
+    if (!reader.ok() || count > reader.remaining()) return false;
+    actions = reader.rest().substr(0, count);
+    return true;
+}
+
+bool ReplayReader::stateAt(size_t entry, game::GameState& state) const {
+    if (entry >= index.size()) return false;
+    for (size_t e = index[entry].keyframe; e <= entry; ++e) {
+        if (!advance(e, state)) return false;
+    }
+    return true;
+}
+
+bool ReplayReader::advance(size_t entry, game::GameState& state) const {
+    uint8_t kind;
+    std::string_view encoded;
+    std::string_view actions;
+    if (!readTurn(entry, kind, encoded, actions)) return false;
+
+    rpc::BinaryReader reader(encoded);
+    if (kind == RECORD_SNAPSHOT) return rpc::decodeGameState(reader, state) && reader.ok();
+    return rpc::applyGameStateDelta(reader, state); // Checks the base turn and the checksum
+}
+
+uint64_t ReplayReader::recordBytes(size_t first, size_t end) const {
+    if (first >= end || first >= index.size()) return 0;
+    uint64_t stop = end < index.size() ? index[end].offset : turns_end;
+    return stop - index[first].offset;
+}
+
+bool ReplayReader::actionsAt(size_t entry, std::vector<game::Action>& out) const {
+    uint8_t kind;
+    std::string_view encoded;
+    std::string_view actions;
+    if (!readTurn(entry, kind, encoded, actions)) return false;
+    out.resize(actions.size());
+    for (size_t i = 0; i < actions.size(); ++i) out[i] = unpackAction(static_cast<uint8_t>(actions[i]));
+    return true;
+}
+
+void ReplayReader::adviseSequential() const {
+    if (!data) return;
+    madvise(const_cast<char*>(data), size, MADV_SEQUENTIAL);
+    madvise(const_cast<char*>(data), size, MADV_WILLNEED);
+}
+
+} // namespace replay
@@ -0,0 +1,150 @@
+// common/replay_log.h
+// Declares the append-only binary match log and its memory-mapped reader
+#pragma once
+#include "game_rules.h"
+#include "game_state.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace replay {
+
+// Layout, all fixed-width integers little-endian:
+//
+//   header  "TP4REPLY", u32 version, u32 keyframe interval,
+//           i32 map_width, i32 map_height, i32 max_turns
+//   turn    u32 body size, u8 kind (snapshot or delta), body:
+//             varint turn, varint state size, state, varint count, actions
+//   ...
+//   index   u32 body size, u8 kind, IndexEntry per turn
+//   footer  u64 index offset, u64 turn count, "TP4INDEX"
+//
+// States are the ones sent in play_turn: a snapshot (rpc::encodeGameState)
+// every keyframe interval turns, deltas against the previous turn
+// (rpc::encodeGameStateDelta, checksum included) in between. Actions are one
+// byte per agent, in state.agents order, as they were applied.
+//
+// Every turn is written whole with one write(), so a recorder that dies
+// leaves a log that is valid up to its last turn; without a footer the
+// reader rebuilds the index by walking the records.
+constexpr char MAGIC[8] = {'T', 'P', '4', 'R', 'E', 'P', 'L', 'Y'};
+constexpr char INDEX_MAGIC[8] = {'T', 'P', '4', 'I', 'N', 'D', 'E', 'X'};
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t DEFAULT_KEYFRAME_INTERVAL = 32; // Bounds a seek to 31 deltas
+
+constexpr uint8_t RECORD_SNAPSHOT = 1;
+constexpr uint8_t RECORD_DELTA = 2;
+constexpr uint8_t RECORD_INDEX = 3;
+
+constexpr size_t HEADER_SIZE = 8 + 4 + 4 + 3 * 4;
+constexpr size_t RECORD_HEADER_SIZE = 4 + 1;
+constexpr size_t FOOTER_SIZE = 8 + 8 + 8;
+
+struct IndexEntry {
+    uint64_t offset;   // Of the turn record
+    uint32_t keyframe; // Entry of the snapshot this turn's state builds on
+    int32_t turn;
+};
+constexpr size_t INDEX_ENTRY_SIZE = 8 + 4 + 4;
+
+// Action byte: type in the high bits, direction in the low two
+inline uint8_t packAction(const game::Action& action) {
+    return static_cast<uint8_t>((static_cast<int>(action.type) << 2) | static_cast<int>(action.direction));
+}
+
+inline game::Action unpackAction(uint8_t packed) {
+    return game::Action(static_cast<game::ActionType>(packed >> 2), static_cast<game::Direction>(packed & 0x03));
+}
+
+// Appends a match to a log file, one recordTurn per play_turn round
+class ReplayWriter {
+private:
+    int fd;
+    uint64_t offset; // Bytes written so far
+    uint32_t keyframe_interval;
+    std::vector<IndexEntry> index;
+    game::GameState previous; // Base of the next delta
+    std::string record;       // Reused for every turn
+    std::string encoded;
+
+public:
+    ReplayWriter();
+    ~ReplayWriter(); // Closes, writing the index
+
+    ReplayWriter(const ReplayWriter&) = delete;
+    ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+    bool open(const std::string& path, const game::GameConfig& config,
+              uint32_t keyframe_interval = DEFAULT_KEYFRAME_INTERVAL); // Truncates
+    bool isOpen() const { return fd >= 0; }
+
+    // state as sent in play_turn, actions as applied afterwards (one per agent)
+    bool recordTurn(const game::GameState& state, const std::vector<game::Action>& actions);
+
+    bool close(); // Writes the index and the footer
+
+    size_t turnCount() const { return index.size(); }
+    uint64_t bytesWritten() const { return offset; }
+
+private:
+    bool writeAll(std::string_view bytes);
+};
+
+// Read-only view of a log through mmap. Nothing is copied out of the mapping
+// except what a GameState needs; seeking goes straight to the turn through
+// the index and its keyframe.
+class ReplayReader {
+private:
+    int fd;
+    const char* data;
+    size_t size;
+    uint32_t keyframe_interval;
+    game::GameConfig game_config;
+    std::vector<IndexEntry> index; // From the footer, or rebuilt by a scan
+    uint64_t turns_end;            // Offset just past the last turn record
+    bool indexed;                  // The footer was there
+
+public:
+    ReplayReader();
+    ~ReplayReader();
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const game::GameConfig& config() const { return game_config; }
+    uint32_t keyframeInterval() const { return keyframe_interval; }
+    size_t fileSize() const { return size; }
+    bool hasIndex() const { return indexed; } // False for a log whose recorder did not close it
+
+    // Entries are the recorded turns in order
+    size_t turnCount() const { return index.size(); }
+    int turnAt(size_t entry) const { return index[entry].turn; }
+    size_t entryOf(int turn) const; // O(1); turnCount() if the turn was not recorded
+
+    // State of entry: its keyframe, then the deltas up to it
+    bool stateAt(size_t entry, game::GameState& state) const;
+
+    // state holds entry - 1 (or anything, for a keyframe): moves it to entry.
+    // Sequential playback costs one delta per turn.
+    bool advance(size_t entry, game::GameState& state) const;
+
+    bool actionsAt(size_t entry, std::vector<game::Action>& actions) const;
+
+    // Size of the records of entries [first, end)
+    uint64_t recordBytes(size_t first, size_t end) const;
+
+    // Sequential scan hint for the kernel (read-ahead), e.g. before playback
+    void adviseSequential() const;
+
+private:
+    bool readTurn(size_t entry, uint8_t& kind, std::string_view& state, std::string_view& actions) const;
+    bool loadIndex();
+    void rebuildIndex();
+};
+
+} // namespace replay
@@ -0,0 +1,156 @@
+// common/rpc_client.cpp
+// Implements the pipelined, id-correlated RPC client
+#include "rpc_protocol.h"
+#include "binary_codec.h"
+#include "metrics.h"
+#include <poll.h>
+#include <algorithm>
+
+namespace rpc {
+
+namespace {
+constexpr int POLL_INTERVAL_MS = 50; // Upper bound on how long stop() waits for the reader
+}
+
+Client::Client(net::TcpConnection& connection, uint64_t first_id)
+    : connection(connection), next_id(first_id), running(false) {}
+
+Client::~Client() {
+    stop();
+}
+
+void Client::start() {
+    if (running) return;
+    running = true;
+    reader = std::thread(&Client::readerLoop, this);
+}
+
+void Client::stop() {
+    running = false;
+    if (reader.joinable()) {
+        reader.join();
+    }
+    failAll("Client stopped");
+}
+
+std::future<std::string> Client::call(const std::string& type, const std::string& fields,
+                                      std::chrono::milliseconds timeout) {
+    std::string id = std::to_string(next_id++);
+    std::string message = std::string("{") +
+        "\"id\":\"" + id + "\"," +
+        "\"type\":\"" + type + "\"" +
+        (fields.empty() ? "" : "," + fields) +
+    "}";
+
+    metrics::Histogram& round_trip = metrics::rpcRoundTrip(type);
+    std::future<std::string> result;
+    {
+        // Registered before sending so a fast response always finds its entry
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        PendingCall& entry = pending[id];
+        entry.sent = Clock::now();
+        entry.deadline = entry.sent + timeout;
+        entry.round_trip = &round_trip;
+        result = entry.promise.get_future();
+    }
+
+    if (!send(message)) {
+        std::lock_guard<std::mutex> lock(pending_mutex);
+        auto it = pending.find(id);
+        if (it != pending.end()) {
+            it->second.promise.set_exception(
+                std::make_exception_ptr(std::runtime_error("Send failed for call " + id)));
+            pending.erase(it);
+        }
+    }
+    return result;
+}
+
+bool Client::send(const std::string& message) {
+    std::lock_guard<std::mutex> lock(send_mutex);
+    return connection.sendMessage(message);
+}
+
+size_t Client::inFlight() {
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    return pending.size();
+}
+
+void Client::readerLoop() {
+    pollfd fd{};
+    fd.fd = connection.getSocketFd();
+    fd.events = POLLIN;
+
+    while (running && connection.isConnected()) {
+        // Frames already buffered by a previous recv
+        std::string_view frame;
+        while (connection.nextFrame(frame)) {
+            dispatch(frame);
+        }
+
+        int next_deadline = expireCalls(Clock::now());
+        int timeout = next_deadline < 0 ? POLL_INTERVAL_MS : std::min(next_deadline, POLL_INTERVAL_MS);
+        int ready = poll(&fd, 1, timeout);
+        if (ready > 0 && connection.receiveSome() == net::IoStatus::closed) {
+            break;
+        }
+    }
+    running = false;
+    if (!connection.isConnected()) {
+        // nextFrame and receiveSome only mark the connection; senders may be
+        // writing, so it is closed under their lock
+        std::lock_guard<std::mutex> lock(send_mutex);
+        connection.disconnect();
+    }
+    failAll("Connection closed");
+}
+
+void Client::dispatch(std::string_view frame) {
+    if (isBinaryFrame(frame)) { // Binary frames are always requests (play_turn)
+        if (on_request) on_request(frame);
+        return;
+    }
+
+    std::string type = extractStringValue(frame, "type");
+    if (!type.empty()) { // Incoming request
+        if (on_request) on_request(frame);
+        return;
+    }
+
+    std::string id = extractStringValue(frame, "id");
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    auto it = pending.find(id);
+    if (it == pending.end()) return; // Unknown or already expired
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - it->second.sent);
+    it->second.round_trip->record(elapsed.count());
+    it->second.promise.set_value(std::string(frame));
+    pending.erase(it);
+}
+
+int Client::expireCalls(Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    Clock::time_point next = Clock::time_point::max();
+    for (auto it = pending.begin(); it != pending.end();) {
+        if (it->second.deadline <= now) {
+            it->second.promise.set_exception(
+                std::make_exception_ptr(TimeoutError("Call " + it->first + " timed out")));
+            it = pending.erase(it);
+        } else {
+            next = std::min(next, it->second.deadline);
+            ++it;
+        }
+    }
+    if (next == Clock::time_point::max()) return -1;
+    auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+    return static_cast<int>(wait) + 1;
+}
+
+void Client::failAll(const std::string& reason) {
+    std::lock_guard<std::mutex> lock(pending_mutex);
+    for (auto& [id, call] : pending) {
+        call.promise.set_exception(std::make_exception_ptr(std::runtime_error(reason)));
+    }
+    pending.clear();
+}
+
+} // namespace rpc
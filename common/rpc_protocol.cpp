@@ -1,43 +1,126 @@
 // common/rpc_protocol.cpp
 // Implements the RPC protocol for communication between the game engine and agents
 #include "rpc_protocol.h"
+#include "json_cursor.h"
+#include "metrics.h"
 #include <sstream>
 #include <unordered_map>
 #include <iostream>
 #include <thread>
 #include <chrono>
 #include <future>
+#include <stdexcept>
 
 namespace rpc {
 
 #include <string>
 
+namespace {
+
+// True when escapeJson would rewrite a character of text. One pass with no
+// calls, unlike find_first_of, which runs a memchr per character.
+bool needsEscape(std::string_view text) {
+    for (char c : text) {
+        if (c == '"' || c == '\\' || c == '\n' || c == '\r' || c == '\t') return true;
+    }
+    return false;
+}
+
+} // namespace
+
+void appendJsonString(std::string& out, std::string_view text) {
+    out += '"';
+    if (!needsEscape(text)) {
+        out += text; // Ids, teams and action names never need escaping
+    } else {
+        out += escapeJson(text);
+    }
+    out += '"';
+}
+
+void appendVoidResponse(std::string& out, std::string_view id) {
+    out += "{\"id\":";
+    appendJsonString(out, id);
+    out += ",\"status\":\"ok\"}";
+}
+
+void appendTurnResponse(std::string& out, std::string_view id, std::string_view action, bool resync) {
+    out += "{\"id\":";
+    appendJsonString(out, id);
+    out += ",\"action\":";
+    appendJsonString(out, action);
+    if (resync) out += ",\"resync\":true";
+    out += '}';
+}
+
+void appendRegisterMessage(std::string& out, std::string_view id, std::string_view agent_id,
+                           std::string_view encoding) {
+    out += "{\"id\":";
+    appendJsonString(out, id);
+    out += ",\"type\":\"register_agent\",\"agent_id\":";
+    appendJsonString(out, agent_id);
+    if (!encoding.empty()) {
+        out += ",\"encoding\":";
+        appendJsonString(out, encoding);
+    }
+    out += '}';
+}
+
 std::string void_response(const std::string& id) {
+    std::string out;
+    appendVoidResponse(out, id);
+    return out;
+}
+
+std::string turn_response(const std::string& id, const std::string& action, bool resync) {
+    std::string out;
+    appendTurnResponse(out, id, action, resync);
+    return out;
+}
+
+std::string register_message(const std::string& id, const std::string& agent_id, const std::string& encoding) {
+    std::string out;
+    appendRegisterMessage(out, id, agent_id, encoding);
+    return out;
+}
+
+// Coordinator -> agent requests
+std::string play_turn_request(const std::string& id, const std::string& agent_id, const std::string& state_json) {
     return std::string("{") +
         "\"id\":\"" + id + "\"," +
-        "\"status\":\"ok\"" +
+        "\"type\":\"play_turn\"," +
+        "\"agent_id\":\"" + escapeJson(agent_id) + "\"," +
+        "\"state\":" + state_json +
     "}";
 }
 
-std::string turn_response(const std::string& id, const std::string& action) {
+std::string receive_intel_request(const std::string& id, const std::string& intel) {
     return std::string("{") +
         "\"id\":\"" + id + "\"," +
-        "\"action\":\"" + action + "\"" +
+        "\"type\":\"receive_intel\"," +
+        "\"intel\":\"" + escapeJson(intel) + "\"" +
     "}";
 }
 
+std::string notify_death_request(const std::string& id) {
+    return std::string("{") +
+        "\"id\":\"" + id + "\"," +
+        "\"type\":\"notify_death\"" +
+    "}";
+}
 
-std::string register_message(const std::string& id, const std::string& agent_id) {
+std::string notify_game_over_request(const std::string& id, int winning_team) {
     return std::string("{") +
         "\"id\":\"" + id + "\"," +
-        "\"type\":\"register_agent\"," +
-        "\"agent_id\":\"" + agent_id + "\"" +
+        "\"type\":\"notify_game_over\"," +
+        "\"winning_team\":" + std::to_string(winning_team) +
     "}";
 }
     
         //  Basic JSON utilities
-std::string escapeJson(const std::string& str) {
+std::string escapeJson(std::string_view str) {
     std::string result;
+    result.reserve(str.size() + 8);
     for (char c : str) {
         switch (c) {
             case '"': result += "\\\""; break;
@@ -51,298 +134,327 @@ std::string escapeJson(const std::string& str) {
     return result;
 }
 
-std::string extractStringValue(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":\"";
+namespace {
+
+// "key": followed by suffix. Appended piece by piece: a chain of operator+
+// on a temporary trips GCC's -Wrestrict false positive at -O3
+std::string keyPattern(std::string_view key, std::string_view suffix) {
+    std::string search;
+    search.reserve(key.size() + 3 + suffix.size());
+    search += '"';
+    search.append(key);
+    search += "\":";
+    search.append(suffix);
+    return search;
+}
+
+} // namespace
+
+std::string extractStringValue(std::string_view json, std::string_view key) {
+    std::string search = keyPattern(key, "\"");
     size_t start = json.find(search);
-    if (start == std::string::npos) return "";
+    if (start == std::string_view::npos) return "";
     start += search.length();
     size_t end = json.find("\"", start);
-    if (end == std::string::npos) return "";
-    return json.substr(start, end - start);
+    if (end == std::string_view::npos) return "";
+    return std::string(json.substr(start, end - start));
 }
 
-bool extractBoolValue(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":";
+bool extractBoolValue(std::string_view json, std::string_view key) {
+    std::string search = keyPattern(key, "");
     size_t start = json.find(search);
-    if (start == std::string::npos) return false;
+    if (start == std::string_view::npos) return false;
     start += search.length();
     return json.substr(start, 4) == "true";
 }
 
-int extractIntValue(const std::string& json, const std::string& key) {
-    std::string search = "\"" + key + "\":";
+int extractIntValue(std::string_view json, std::string_view key) {
+    std::string search = keyPattern(key, "");
     size_t start = json.find(search);
-    if (start == std::string::npos) return 0;
+    if (start == std::string_view::npos) return 0;
     start += search.length();
     size_t end = json.find_first_of(",}", start);
-    if (end == std::string::npos) return 0;
-    return std::stoi(json.substr(start, end - start));
+    if (end == std::string_view::npos) return 0;
+    return std::stoi(std::string(json.substr(start, end - start)));
 }
 
 // GameState deserialization implementation
-game::Position deserializePosition(const std::string& json) {
-    int x = extractIntValue(json, "x");
-    int y = extractIntValue(json, "y");
-    return game::Position(x, y);
+// The payload is walked exactly once with a JsonCursor: no substrings are cut
+// out of the buffer and every field is written straight into the GameState.
+namespace {
+
+[[noreturn]] void malformed(const JsonCursor& cursor, const char* what) {
+    throw std::runtime_error(std::string("Malformed game state JSON (") + what +
+                             ") at offset " + std::to_string(cursor.offset()));
 }
 
-game::Agent deserializeAgent(const std::string& json) {
-    std::string id = extractStringValue(json, "id");
-    std::string team = extractStringValue(json, "team");
-    
-    // Extract position object
-    std::string pos_search = "\"position\":";
-    size_t pos_start = json.find(pos_search);
-    if (pos_start != std::string::npos) {
-        pos_start += pos_search.length();
-        size_t pos_end = json.find("}", pos_start);
-        if (pos_end != std::string::npos) {
-            std::string pos_json = json.substr(pos_start, pos_end - pos_start + 1);
-            game::Position position = deserializePosition(pos_json);
-            
-            std::string facing_str = extractStringValue(json, "facing");
-            game::Direction facing = game::getDirectionFromString(facing_str);
-            int hp = extractIntValue(json, "hp");
-            int max_hp = extractIntValue(json, "max_hp");
-            bool is_alive = extractBoolValue(json, "is_alive");
-            
-            game::Agent agent(id, team, position, max_hp);
-            agent.facing = facing;
-            agent.hp = hp;
-            agent.is_alive = is_alive;
-            return agent;
+void expect(bool ok, const JsonCursor& cursor, const char* what) {
+    if (!ok) malformed(cursor, what);
+}
+
+metrics::Histogram& parseTime() { // Both layouts, malformed payloads included
+    static metrics::Histogram& histogram = metrics::Registry::global().histogram("game_state_parse_ns");
+    return histogram;
+}
+
+void parsePosition(JsonCursor& cursor, game::Position& position) {
+    expect(cursor.beginObject(), cursor, "position");
+    std::string_view key;
+    while (cursor.nextKey(key)) {
+        if (key == "x") expect(cursor.readInt(position.x), cursor, "x");
+        else if (key == "y") expect(cursor.readInt(position.y), cursor, "y");
+        else expect(cursor.skipValue(), cursor, "position field");
+    }
+}
+
+void parseAgent(JsonCursor& cursor, game::Agent& agent) {
+    expect(cursor.beginObject(), cursor, "agent");
+    std::string_view key;
+    while (cursor.nextKey(key)) {
+        if (key == "id") {
+            expect(cursor.readString(agent.id), cursor, "id");
+        } else if (key == "team") {
+            expect(cursor.readString(agent.team), cursor, "team");
+        } else if (key == "position") {
+            parsePosition(cursor, agent.position);
+        } else if (key == "facing") {
+            std::string_view facing;
+            expect(cursor.readString(facing), cursor, "facing");
+            agent.facing = game::getDirectionFromString(facing);
+        } else if (key == "hp") {
+            expect(cursor.readInt(agent.hp), cursor, "hp");
+        } else if (key == "max_hp") {
+            expect(cursor.readInt(agent.max_hp), cursor, "max_hp");
+        } else if (key == "is_alive") {
+            expect(cursor.readBool(agent.is_alive), cursor, "is_alive");
+        } else {
+            expect(cursor.skipValue(), cursor, "agent field");
         }
     }
-    
-    // Fallback - create agent with default values
-    return game::Agent(id, team, game::Position(0, 0), 100);
 }
 
-game::Base deserializeBase(const std::string& json) {
-    std::string team = extractStringValue(json, "team");
-    
-    // Extract position object
-    std::string pos_search = "\"position\":";
-    size_t pos_start = json.find(pos_search);
-    game::Position position(0, 0);
-    if (pos_start != std::string::npos) {
-        pos_start += pos_search.length();
-        size_t pos_end = json.find("}", pos_start);
-        if (pos_end != std::string::npos) {
-            std::string pos_json = json.substr(pos_start, pos_end - pos_start + 1);
-            position = deserializePosition(pos_json);
+void parseBase(JsonCursor& cursor, game::Base& base) {
+    expect(cursor.beginObject(), cursor, "base");
+    std::string_view key;
+    while (cursor.nextKey(key)) {
+        if (key == "team") {
+            expect(cursor.readString(base.team), cursor, "team");
+        } else if (key == "position") {
+            parsePosition(cursor, base.position);
+        } else if (key == "hp") {
+            expect(cursor.readInt(base.hp), cursor, "hp");
+        } else if (key == "max_hp") {
+            expect(cursor.readInt(base.max_hp), cursor, "max_hp");
+        } else if (key == "is_destroyed") {
+            expect(cursor.readBool(base.is_destroyed), cursor, "is_destroyed");
+        } else {
+            expect(cursor.skipValue(), cursor, "base field");
         }
     }
-    
-    int hp = extractIntValue(json, "hp");
-    int max_hp = extractIntValue(json, "max_hp");
-    bool is_destroyed = extractBoolValue(json, "is_destroyed");
-    
-    game::Base base(team, position, max_hp);
-    base.hp = hp;
-    base.is_destroyed = is_destroyed;
-    return base;
 }
 
-game::GameConfig deserializeGameConfig(const std::string& json) {
-    game::GameConfig config;
-    config.map_width = extractIntValue(json, "map_width");
-    config.map_height = extractIntValue(json, "map_height");
-    config.max_turns = extractIntValue(json, "max_turns");
-    return config;
+void parseConfig(JsonCursor& cursor, game::GameConfig& config) {
+    expect(cursor.beginObject(), cursor, "config");
+    std::string_view key;
+    while (cursor.nextKey(key)) {
+        if (key == "map_width") expect(cursor.readInt(config.map_width), cursor, "map_width");
+        else if (key == "map_height") expect(cursor.readInt(config.map_height), cursor, "map_height");
+        else if (key == "max_turns") expect(cursor.readInt(config.max_turns), cursor, "max_turns");
+        else expect(cursor.skipValue(), cursor, "config field");
+    }
 }
 
-game::GameState deserializeGameState(const std::string& json) {
-    game::GameState state;
-    
-    // Deserialize agents array
-    std::string agents_search = "\"agents\":[";
-    size_t agents_start = json.find(agents_search);
-    if (agents_start != std::string::npos) {
-        agents_start += agents_search.length();
-        size_t agents_end = agents_start;
-        int bracket_count = 1;
-        bool in_string = false;
-        bool escaped = false;
-        
-        for (size_t i = agents_start; i < json.length() && bracket_count > 0; ++i) {
-            char c = json[i];
-            
-            if (escaped) {
-                escaped = false;
-                continue;
-            }
-            if (c == '\\') {
-                escaped = true;
-                continue;
-            }
-            if (c == '"') {
-                in_string = !in_string;
-                continue;
+// Fills state from an object that is either the play_turn message itself or
+// its "state" member; unknown keys (id, type, agent_id, ...) are skipped.
+void parseStateObject(JsonCursor& cursor, game::GameState& state) {
+    expect(cursor.beginObject(), cursor, "state");
+    std::string_view key;
+    while (cursor.nextKey(key)) {
+        if (key == "agents") {
+            expect(cursor.beginArray(), cursor, "agents");
+            while (cursor.nextElement()) {
+                state.agents.emplace_back(std::string(), std::string(), game::Position(0, 0), 0);
+                state.agents.back().is_alive = false;
+                parseAgent(cursor, state.agents.back());
             }
-            
-            if (!in_string) {
-                if (c == '[') bracket_count++;
-                else if (c == ']') bracket_count--;
-            }
-            
-            agents_end = i;
-        }
-        
-        std::string agents_json = json.substr(agents_start, agents_end - agents_start);
-        
-        // Parse individual agent objects
-        size_t pos = 0;
-        int brace_count = 0;
-        size_t obj_start = 0;
-        in_string = false;
-        escaped = false;
-        
-        for (size_t i = 0; i <= agents_json.length(); ++i) {
-            if (i == agents_json.length() || 
-                (!in_string && brace_count == 0 && (agents_json[i] == ',' || i == agents_json.length()))) {
-                
-                if (i > obj_start) {
-                    std::string agent_json = agents_json.substr(obj_start, i - obj_start);
-                    if (!agent_json.empty() && agent_json != ",") {
-                        state.agents.push_back(deserializeAgent(agent_json));
-                    }
-                }
-                
-                // Skip comma and whitespace
-                while (i + 1 < agents_json.length() && 
-                       (agents_json[i + 1] == ',' || std::isspace(agents_json[i + 1]))) {
-                    i++;
-                }
-                obj_start = i + 1;
-                continue;
-            }
-            
-            char c = agents_json[i];
-            
-            if (escaped) {
-                escaped = false;
-                continue;
-            }
-            if (c == '\\') {
-                escaped = true;
-                continue;
-            }
-            if (c == '"') {
-                in_string = !in_string;
-                continue;
-            }
-            
-            if (!in_string) {
-                if (c == '{') brace_count++;
-                else if (c == '}') brace_count--;
+        } else if (key == "bases") {
+            expect(cursor.beginArray(), cursor, "bases");
+            while (cursor.nextElement()) {
+                state.bases.emplace_back(std::string(), game::Position(0, 0), 0);
+                parseBase(cursor, state.bases.back());
             }
+        } else if (key == "config") {
+            parseConfig(cursor, state.config);
+        } else if (key == "current_turn") {
+            expect(cursor.readInt(state.current_turn), cursor, "current_turn");
+        } else if (key == "game_over") {
+            expect(cursor.readBool(state.game_over), cursor, "game_over");
+        } else if (key == "winner") {
+            expect(cursor.readString(state.winner), cursor, "winner");
+        } else if (key == "state") {
+            parseStateObject(cursor, state);
+        } else {
+            expect(cursor.skipValue(), cursor, "field");
         }
     }
-    
-    // Similar parsing for bases array
-    std::string bases_search = "\"bases\":[";
-    size_t bases_start = json.find(bases_search);
-    if (bases_start != std::string::npos) {
-        bases_start += bases_search.length();
-        size_t bases_end = bases_start;
-        int bracket_count = 1;
-        bool in_string = false;
-        bool escaped = false;
-        
-        for (size_t i = bases_start; i < json.length() && bracket_count > 0; ++i) {
-            char c = json[i];
-            
-            if (escaped) {
-                escaped = false;
-                continue;
-            }
-            if (c == '\\') {
-                escaped = true;
-                continue;
-            }
-            if (c == '"') {
-                in_string = !in_string;
-                continue;
-            }
-            
-            if (!in_string) {
-                if (c == '[') bracket_count++;
-                else if (c == ']') bracket_count--;
-            }
-            
-            bases_end = i;
-        }
-        
-        std::string bases_json = json.substr(bases_start, bases_end - bases_start);
-        
-        // Parse individual base objects
-        size_t pos = 0;
-        int brace_count = 0;
-        size_t obj_start = 0;
-        in_string = false;
-        escaped = false;
-        
-        for (size_t i = 0; i <= bases_json.length(); ++i) {
-            if (i == bases_json.length() || 
-                (!in_string && brace_count == 0 && (bases_json[i] == ',' || i == bases_json.length()))) {
-                
-                if (i > obj_start) {
-                    std::string base_json = bases_json.substr(obj_start, i - obj_start);
-                    if (!base_json.empty() && base_json != ",") {
-                        state.bases.push_back(deserializeBase(base_json));
-                    }
-                }
-                
-                // Skip comma and whitespace
-                while (i + 1 < bases_json.length() && 
-                       (bases_json[i + 1] == ',' || std::isspace(bases_json[i + 1]))) {
-                    i++;
-                }
-                obj_start = i + 1;
-                continue;
-            }
-            
-            char c = bases_json[i];
-            
-            if (escaped) {
-                escaped = false;
-                continue;
-            }
-            if (c == '\\') {
-                escaped = true;
-                continue;
-            }
-            if (c == '"') {
-                in_string = !in_string;
-                continue;
-            }
-            
-            if (!in_string) {
-                if (c == '{') brace_count++;
-                else if (c == '}') brace_count--;
-            }
+}
+
+// Structure-of-arrays variant: every agent is read into scratch fields and
+// appended at once, with its team and id interned into the state's tables
+struct SoAScratch {
+    std::string id;
+    std::string team;
+};
+
+void parseAgentSoA(JsonCursor& cursor, game::GameStateSoA& state, SoAScratch& scratch) {
+    expect(cursor.beginObject(), cursor, "agent");
+    scratch.id.clear();
+    scratch.team.clear();
+    game::Position position;
+    game::Direction facing = game::Direction::NORTH;
+    int hp = 0;
+    int max_hp = 0;
+    bool is_alive = false;
+    std::string_view key;
+    while (cursor.nextKey(key)) {
+        if (key == "id") {
+            expect(cursor.readString(scratch.id), cursor, "id");
+        } else if (key == "team") {
+            expect(cursor.readString(scratch.team), cursor, "team");
+        } else if (key == "position") {
+            parsePosition(cursor, position);
+        } else if (key == "facing") {
+            std::string_view text;
+            expect(cursor.readString(text), cursor, "facing");
+            facing = game::getDirectionFromString(text);
+        } else if (key == "hp") {
+            expect(cursor.readInt(hp), cursor, "hp");
+        } else if (key == "max_hp") {
+            expect(cursor.readInt(max_hp), cursor, "max_hp");
+        } else if (key == "is_alive") {
+            expect(cursor.readBool(is_alive), cursor, "is_alive");
+        } else {
+            expect(cursor.skipValue(), cursor, "agent field");
         }
     }
-    
-    // Parse config object
-    std::string config_search = "\"config\":";
-    size_t config_start = json.find(config_search);
-    if (config_start != std::string::npos) {
-        config_start += config_search.length();
-        size_t config_end = json.find("}", config_start);
-        if (config_end != std::string::npos) {
-            std::string config_json = json.substr(config_start, config_end - config_start + 1);
-            state.config = deserializeGameConfig(config_json);
+    size_t i = state.addAgent(scratch.id, scratch.team);
+    state.x[i] = position.x;
+    state.y[i] = position.y;
+    state.hp[i] = hp;
+    state.max_hp[i] = max_hp;
+    state.facing[i] = static_cast<uint8_t>(facing);
+    state.setAlive(i, is_alive);
+}
+
+void parseStateObjectSoA(JsonCursor& cursor, game::GameStateSoA& state, SoAScratch& scratch) {
+    expect(cursor.beginObject(), cursor, "state");
+    std::string_view key;
+    while (cursor.nextKey(key)) {
+        if (key == "agents") {
+            expect(cursor.beginArray(), cursor, "agents");
+            while (cursor.nextElement()) parseAgentSoA(cursor, state, scratch);
+        } else if (key == "bases") {
+            expect(cursor.beginArray(), cursor, "bases");
+            while (cursor.nextElement()) {
+                game::Base base(std::string(), game::Position(0, 0), 0);
+                parseBase(cursor, base);
+                size_t i = state.addBase(base.team);
+                state.base_x[i] = base.position.x;
+                state.base_y[i] = base.position.y;
+                state.base_hp[i] = base.hp;
+                state.base_max_hp[i] = base.max_hp;
+                state.base_destroyed[i] = base.is_destroyed;
+            }
+        } else if (key == "config") {
+            parseConfig(cursor, state.config);
+        } else if (key == "current_turn") {
+            expect(cursor.readInt(state.current_turn), cursor, "current_turn");
+        } else if (key == "game_over") {
+            expect(cursor.readBool(state.game_over), cursor, "game_over");
+        } else if (key == "winner") {
+            expect(cursor.readString(state.winner), cursor, "winner");
+        } else if (key == "state") {
+            parseStateObjectSoA(cursor, state, scratch);
+        } else {
+            expect(cursor.skipValue(), cursor, "field");
         }
     }
-    
-    // Parse simple fields
-    state.current_turn = extractIntValue(json, "current_turn");
-    state.game_over = extractBoolValue(json, "game_over");
-    state.winner = extractStringValue(json, "winner");
-    
+}
+
+} // namespace
+
+void deserializeGameState(std::string_view json, game::GameStateSoA& out) {
+    metrics::ScopedTimer timer(parseTime());
+    out.clear();
+    SoAScratch scratch;
+    JsonCursor cursor(json);
+    parseStateObjectSoA(cursor, out, scratch);
+}
+
+game::GameState deserializeGameState(std::string_view json) {
+    game::GameState state;
+    deserializeGameState(json, state);
     return state;
 }
 
+void deserializeGameState(std::string_view json, game::GameState& out) {
+    metrics::ScopedTimer timer(parseTime());
+    out.agents.clear();
+    out.bases.clear();
+    out.current_turn = 0;
+    out.game_over = false;
+    out.winner.clear();
+    out.config = game::GameConfig();
+    JsonCursor cursor(json);
+    parseStateObject(cursor, out);
+}
+
+// GameState serialization, in the layout documented in RPC_PROTOCOL.md
+void serializeGameState(const game::GameState& state, std::string& out) {
+    auto appendPosition = [&out](const game::Position& position) {
+        out += "\"position\":{\"x\":";
+        out += std::to_string(position.x);
+        out += ",\"y\":";
+        out += std::to_string(position.y);
+        out += "}";
+    };
+
+    out += "{\"agents\":[";
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        const game::Agent& agent = state.agents[i];
+        if (i > 0) out += ",";
+        out += "{\"id\":\"" + escapeJson(agent.id) + "\",";
+        out += "\"team\":\"" + escapeJson(agent.team) + "\",";
+        appendPosition(agent.position);
+        out += ",\"facing\":\"";
+        out += game::directionName(agent.facing);
+        out += "\",";
+        out += "\"hp\":" + std::to_string(agent.hp) + ",";
+        out += "\"max_hp\":" + std::to_string(agent.max_hp) + ",";
+        out += std::string("\"is_alive\":") + (agent.is_alive ? "true" : "false") + "}";
+    }
+    out += "],\"bases\":[";
+    for (size_t i = 0; i < state.bases.size(); ++i) {
+        const game::Base& base = state.bases[i];
+        if (i > 0) out += ",";
+        out += "{\"team\":\"" + escapeJson(base.team) + "\",";
+        appendPosition(base.position);
+        out += ",\"hp\":" + std::to_string(base.hp) + ",";
+        out += "\"max_hp\":" + std::to_string(base.max_hp) + ",";
+        out += std::string("\"is_destroyed\":") + (base.is_destroyed ? "true" : "false") + "}";
+    }
+    out += "],\"current_turn\":" + std::to_string(state.current_turn) + ",";
+    out += std::string("\"game_over\":") + (state.game_over ? "true" : "false") + ",";
+    out += "\"winner\":\"" + escapeJson(state.winner) + "\",";
+    out += "\"config\":{\"map_width\":" + std::to_string(state.config.map_width) + ",";
+    out += "\"map_height\":" + std::to_string(state.config.map_height) + ",";
+    out += "\"max_turns\":" + std::to_string(state.config.max_turns) + "}}";
+}
+
+std::string serializeGameState(const game::GameState& state) {
+    std::string out;
+    serializeGameState(state, out);
+    return out;
+}
+
 } // namespace rpc
\ No newline at end of file
@@ -2,8 +2,10 @@
 // Declare the functions and structures for the rpc_protocol.cpp
 #pragma once
 #include <string>
+#include <string_view>
 #include <memory>
 #include "game_state.h"
+#include "game_state_soa.h"
 #include "tcp_connection.h"
 #include <thread>
 #include <unordered_map>
@@ -12,20 +14,115 @@
 #include <atomic>
 #include <chrono>
 #include <future>
+#include <functional>
+#include <stdexcept>
+
+namespace metrics {
+class Histogram;
+}
 
 namespace rpc {
 
 // Helper functions for JSON parsing
-std::string escapeJson(const std::string& str);
-std::string extractStringValue(const std::string& json, const std::string& key);
-int extractIntValue(const std::string& json, const std::string& key);
-bool extractBoolValue(const std::string& json, const std::string& key);
+std::string escapeJson(std::string_view str);
+std::string extractStringValue(std::string_view json, std::string_view key);
+int extractIntValue(std::string_view json, std::string_view key);
+bool extractBoolValue(std::string_view json, std::string_view key);
 std::string void_response(const std::string& id);
-std::string turn_response(const std::string& id, const std::string& action);
-std::string register_message(const std::string& id, const std::string& agent_id);
-game::GameState deserializeGameState(const std::string& json);
+std::string turn_response(const std::string& id, const std::string& action, bool resync = false); // resync: binary_delta only
+std::string register_message(const std::string& id, const std::string& agent_id, const std::string& encoding = "");
+
+// Same messages, appended to out (usually a connection's send buffer, see
+// TcpConnection::beginFrame) with no temporaries. Strings go through the
+// escaping path only when they hold a character that needs it.
+void appendJsonString(std::string& out, std::string_view text); // Quoted
+void appendVoidResponse(std::string& out, std::string_view id);
+void appendTurnResponse(std::string& out, std::string_view id, std::string_view action, bool resync = false);
+void appendRegisterMessage(std::string& out, std::string_view id, std::string_view agent_id,
+                           std::string_view encoding = "");
+std::string play_turn_request(const std::string& id, const std::string& agent_id, const std::string& state_json);
+std::string receive_intel_request(const std::string& id, const std::string& intel);
+std::string notify_death_request(const std::string& id);
+std::string notify_game_over_request(const std::string& id, int winning_team);
+game::GameState deserializeGameState(std::string_view json); // Single pass, accepts play_turn or its state
+void deserializeGameState(std::string_view json, game::GameState& out); // Same, allocating from out's resource
+void deserializeGameState(std::string_view json, game::GameStateSoA& out); // Same, interning into out's tables
+void serializeGameState(const game::GameState& state, std::string& out);
+std::string serializeGameState(const game::GameState& state);
 
 // Acá pueden armar todo lo relacionado con responder a las llamadas RPC
 // y hacer la request de registro del agente.
 
+// Thrown through a call's future when no response arrived before its deadline
+class TimeoutError : public std::runtime_error {
+public:
+    explicit TimeoutError(const std::string& what) : std::runtime_error(what) {}
+};
+
+// Pipelined RPC endpoint over one TcpConnection. Every call gets a fresh id and
+// any number of calls may be in flight; a reader thread matches responses to
+// their futures by id and hands incoming requests (frames with a "type") to the
+// request handler. Calls that outlive their timeout fail with TimeoutError.
+class Client {
+public:
+    using Clock = std::chrono::steady_clock;
+    using RequestHandler = std::function<void(std::string_view frame)>; // Runs on the reader thread
+
+private:
+    struct PendingCall {
+        std::promise<std::string> promise;
+        Clock::time_point sent;
+        Clock::time_point deadline;
+        metrics::Histogram* round_trip; // rpc_round_trip_ns of the call's type
+    };
+
+    net::TcpConnection& connection;
+    RequestHandler on_request;
+
+    std::mutex send_mutex;                                // Serializes writers on the socket
+    std::mutex pending_mutex;                             // Guards pending
+    std::unordered_map<std::string, PendingCall> pending;
+    std::atomic<uint64_t> next_id;
+
+    std::thread reader;
+    std::atomic<bool> running;
+
+public:
+    explicit Client(net::TcpConnection& connection, uint64_t first_id = 1);
+    ~Client();
+
+    Client(const Client&) = delete;
+    Client& operator=(const Client&) = delete;
+
+    void onRequest(RequestHandler handler) { on_request = std::move(handler); } // Before start()
+    void start();
+    void stop();
+
+    // Sends {"id":..,"type":type,fields} and returns the raw response frame.
+    // fields are extra JSON members without braces, e.g. "\"agent_id\":\"a1\"".
+    std::future<std::string> call(const std::string& type, const std::string& fields = "",
+                                  std::chrono::milliseconds timeout = std::chrono::milliseconds(5000));
+
+    bool send(const std::string& message); // Thread-safe raw send, e.g. to answer a request
+
+    // Same, but write(std::string&) appends the frame body straight into the
+    // connection's send buffer, e.g. with appendTurnResponse
+    template <typename Write>
+    bool sendFrame(Write&& write) {
+        std::lock_guard<std::mutex> lock(send_mutex);
+        if (!connection.isConnected()) return false;
+        write(connection.beginFrame());
+        connection.endFrame();
+        return connection.flushPending() == net::IoStatus::ok;
+    }
+    size_t inFlight();
+    bool isRunning() const { return running; }
+
+private:
+    void readerLoop();
+    void dispatch(std::string_view frame);
+    int expireCalls(Clock::time_point now); // Returns ms until the next deadline, -1 if none
+    void failAll(const std::string& reason);
+};
+
 } // namespace rpc
\ No newline at end of file
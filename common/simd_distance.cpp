@@ -0,0 +1,201 @@
+// common/simd_distance.cpp
+// Implements the squared-distance kernels: scalar, SSE4.1 and AVX2, chosen at runtime
+#include "simd_distance.h"
+#include <algorithm>
+#include <climits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TP4_SIMD_X86 1
+#endif
+
+namespace game {
+
+namespace {
+
+NearestPoint nearestScalar(const int32_t* xs, const int32_t* ys, size_t begin, size_t n, int32_t px, int32_t py,
+                           NearestPoint best) {
+    for (size_t i = begin; i < n; ++i) {
+        int64_t dx = static_cast<int64_t>(xs[i]) - px;
+        int64_t dy = static_cast<int64_t>(ys[i]) - py;
+        int64_t d = dx * dx + dy * dy;
+        if (best.index < 0 || d < best.distance2) best = {d, static_cast<int64_t>(i)};
+    }
+    return best;
+}
+
+size_t withinRangeScalar(const int32_t* xs, const int32_t* ys, size_t begin, size_t n, int32_t px, int32_t py,
+                         int64_t range2, uint32_t* out, size_t count) {
+    for (size_t i = begin; i < n; ++i) {
+        int64_t dx = static_cast<int64_t>(xs[i]) - px;
+        int64_t dy = static_cast<int64_t>(ys[i]) - py;
+        out[count] = static_cast<uint32_t>(i);
+        count += (dx * dx + dy * dy <= range2);
+    }
+    return count;
+}
+
+#ifdef TP4_SIMD_X86
+
+// Lane results to one answer: smallest distance, then smallest index
+template <size_t LANES>
+NearestPoint reduceLanes(const int32_t* distance, const int32_t* index) {
+    NearestPoint best{INT64_MAX, -1};
+    for (size_t lane = 0; lane < LANES; ++lane) {
+        if (distance[lane] < best.distance2 || (distance[lane] == best.distance2 && index[lane] < best.index)) {
+            best = {distance[lane], index[lane]};
+        }
+    }
+    return best;
+}
+
+__attribute__((target("sse4.1")))
+NearestPoint nearestSse41(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py) {
+    const __m128i vpx = _mm_set1_epi32(px);
+    const __m128i vpy = _mm_set1_epi32(py);
+    const __m128i step = _mm_set1_epi32(4);
+    __m128i best = _mm_set1_epi32(INT32_MAX);
+    __m128i best_index = _mm_set1_epi32(INT32_MAX);
+    __m128i index = _mm_setr_epi32(0, 1, 2, 3);
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i dx = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i)), vpx);
+        __m128i dy = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i)), vpy);
+        __m128i d = _mm_add_epi32(_mm_mullo_epi32(dx, dx), _mm_mullo_epi32(dy, dy));
+        __m128i closer = _mm_cmpgt_epi32(best, d); // Strict: an earlier index keeps its lane on ties
+        best = _mm_min_epi32(best, d);
+        best_index = _mm_blendv_epi8(best_index, index, closer);
+        index = _mm_add_epi32(index, step);
+    }
+
+    alignas(16) int32_t lane_distance[4];
+    alignas(16) int32_t lane_index[4];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lane_distance), best);
+    _mm_store_si128(reinterpret_cast<__m128i*>(lane_index), best_index);
+    NearestPoint result = i == 0 ? NearestPoint{0, -1} : reduceLanes<4>(lane_distance, lane_index);
+    return nearestScalar(xs, ys, i, n, px, py, result);
+}
+
+__attribute__((target("avx2")))
+NearestPoint nearestAvx2(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py) {
+    const __m256i vpx = _mm256_set1_epi32(px);
+    const __m256i vpy = _mm256_set1_epi32(py);
+    const __m256i step = _mm256_set1_epi32(8);
+    __m256i best = _mm256_set1_epi32(INT32_MAX);
+    __m256i best_index = _mm256_set1_epi32(INT32_MAX);
+    __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i dx = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i)), vpx);
+        __m256i dy = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i)), vpy);
+        __m256i d = _mm256_add_epi32(_mm256_mullo_epi32(dx, dx), _mm256_mullo_epi32(dy, dy));
+        __m256i closer = _mm256_cmpgt_epi32(best, d);
+        best = _mm256_min_epi32(best, d);
+        best_index = _mm256_blendv_epi8(best_index, index, closer);
+        index = _mm256_add_epi32(index, step);
+    }
+
+    alignas(32) int32_t lane_distance[8];
+    alignas(32) int32_t lane_index[8];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_distance), best);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lane_index), best_index);
+    NearestPoint result = i == 0 ? NearestPoint{0, -1} : reduceLanes<8>(lane_distance, lane_index);
+    return nearestScalar(xs, ys, i, n, px, py, result);
+}
+
+__attribute__((target("sse4.1")))
+size_t withinRangeSse41(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py, int32_t range2,
+                        uint32_t* out) {
+    const __m128i vpx = _mm_set1_epi32(px);
+    const __m128i vpy = _mm_set1_epi32(py);
+    const __m128i limit = _mm_set1_epi32(range2);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i dx = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(xs + i)), vpx);
+        __m128i dy = _mm_sub_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ys + i)), vpy);
+        __m128i d = _mm_add_epi32(_mm_mullo_epi32(dx, dx), _mm_mullo_epi32(dy, dy));
+        unsigned inside = ~_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(d, limit))) & 0xF;
+        while (inside) {
+            out[count++] = static_cast<uint32_t>(i + __builtin_ctz(inside));
+            inside &= inside - 1;
+        }
+    }
+    return withinRangeScalar(xs, ys, i, n, px, py, range2, out, count);
+}
+
+__attribute__((target("avx2")))
+size_t withinRangeAvx2(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py, int32_t range2,
+                       uint32_t* out) {
+    const __m256i vpx = _mm256_set1_epi32(px);
+    const __m256i vpy = _mm256_set1_epi32(py);
+    const __m256i limit = _mm256_set1_epi32(range2);
+    size_t count = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i dx = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(xs + i)), vpx);
+        __m256i dy = _mm256_sub_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ys + i)), vpy);
+        __m256i d = _mm256_add_epi32(_mm256_mullo_epi32(dx, dx), _mm256_mullo_epi32(dy, dy));
+        unsigned inside = ~_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(d, limit))) & 0xFF;
+        while (inside) {
+            out[count++] = static_cast<uint32_t>(i + __builtin_ctz(inside));
+            inside &= inside - 1;
+        }
+    }
+    return withinRangeScalar(xs, ys, i, n, px, py, range2, out, count);
+}
+
+#endif // TP4_SIMD_X86
+
+} // namespace
+
+SimdLevel bestSimdLevel() {
+#ifdef TP4_SIMD_X86
+    static const SimdLevel level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) return SimdLevel::avx2;
+        if (__builtin_cpu_supports("sse4.1")) return SimdLevel::sse41;
+        return SimdLevel::scalar;
+    }();
+    return level;
+#else
+    return SimdLevel::scalar;
+#endif
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::avx2: return "avx2";
+        case SimdLevel::sse41: return "sse4.1";
+        default: return "scalar";
+    }
+}
+
+NearestPoint nearestSquared(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py,
+                            SimdLevel level) {
+#ifdef TP4_SIMD_X86
+    // Levels above what the CPU has fall back to the best available one
+    level = std::min(level, bestSimdLevel());
+    if (level == SimdLevel::avx2) return nearestAvx2(xs, ys, n, px, py);
+    if (level == SimdLevel::sse41) return nearestSse41(xs, ys, n, px, py);
+#endif
+    (void)level;
+    return nearestScalar(xs, ys, 0, n, px, py, NearestPoint{0, -1});
+}
+
+size_t withinRange(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py, int64_t range2,
+                   uint32_t* out, SimdLevel level) {
+    if (range2 < 0) return 0;
+#ifdef TP4_SIMD_X86
+    level = std::min(level, bestSimdLevel());
+    int32_t limit = static_cast<int32_t>(std::min<int64_t>(range2, INT32_MAX));
+    if (level == SimdLevel::avx2) return withinRangeAvx2(xs, ys, n, px, py, limit, out);
+    if (level == SimdLevel::sse41) return withinRangeSse41(xs, ys, n, px, py, limit, out);
+#endif
+    (void)level;
+    return withinRangeScalar(xs, ys, 0, n, px, py, range2, out, 0);
+}
+
+} // namespace game
@@ -0,0 +1,42 @@
+// common/simd_distance.h
+// Declares the batch squared-distance kernels (argmin and range filter) over packed int32 coordinates
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+namespace game {
+
+// Instruction set used by the kernels. best() is picked once at startup from
+// what the CPU reports; the other levels stay callable for comparisons.
+enum class SimdLevel {
+    scalar,
+    sse41, // 4 int32 lanes
+    avx2   // 8 int32 lanes
+};
+
+SimdLevel bestSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// Closest point to (px, py) among (xs[i], ys[i]), by squared Euclidean
+// distance; ties go to the lowest i. index is -1 when n == 0.
+//
+// The vector paths compute in int32, so every |xs[i] - px| and |ys[i] - py|
+// must be below MAX_SIMD_DELTA (any map up to 32768 cells a side, with the
+// query point on the map, qualifies). Callers that cannot guarantee it pass
+// SimdLevel::scalar, which computes in 64 bits.
+constexpr int32_t MAX_SIMD_DELTA = 32767;
+
+struct NearestPoint {
+    int64_t distance2;
+    int64_t index;
+};
+
+NearestPoint nearestSquared(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py,
+                            SimdLevel level = bestSimdLevel());
+
+// Writes to out (room for n entries) the indices, ascending, of the points
+// within range2 squared distance of (px, py). Returns how many were written.
+size_t withinRange(const int32_t* xs, const int32_t* ys, size_t n, int32_t px, int32_t py, int64_t range2,
+                   uint32_t* out, SimdLevel level = bestSimdLevel());
+
+} // namespace game
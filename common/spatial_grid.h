@@ -0,0 +1,82 @@
+// common/spatial_grid.h
+// Declares a per-turn spatial index over the living agents of a GameState
+#pragma once
+#include "game_state.h"
+#include "simd_distance.h"
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace game {
+
+// Living agents bucketed by map cell, built once per turn and shared by every
+// query of that turn. Cell lookups are O(1); nearest, k-nearest and radius
+// queries walk Chebyshev rings outwards from the query cell and stop as soon
+// as no farther ring can hold a closer agent, so their cost depends on the
+// local density instead of the total agent count.
+//
+// Distances are squared Euclidean; ties are broken by the lower agent index,
+// which is the order a linear scan over state.agents would pick.
+//
+// Each team's on-map agents are also packed into contiguous coordinate
+// arrays. When the enemies are few for the map size, so that the rings would
+// cross mostly empty cells, nearestEnemy and enemiesInRadius scan those arrays
+// with the batch kernels of simd_distance.h instead.
+class SpatialGrid {
+private:
+    const GameState* state;
+    int width;
+    int height;
+    std::vector<uint32_t> cell_start; // Agents of cell c are cell_agents[cell_start[c] .. cell_start[c + 1])
+    std::vector<uint32_t> cell_agents;
+    std::vector<uint32_t> outside;    // Living agents off the map, only reachable by scanning
+
+    // Team t owns packed_*[team_start[t] .. team_start[t + 1]), agent indices ascending
+    std::vector<std::string_view> team_names;
+    std::vector<uint32_t> team_start;
+    std::vector<int32_t> packed_x;
+    std::vector<int32_t> packed_y;
+    std::vector<uint32_t> packed_agent;
+
+    // Scratch of build(), kept so that rebuilding every turn does not allocate
+    std::vector<uint32_t> fill;
+    std::vector<uint32_t> agent_team;
+    std::vector<uint32_t> team_count;
+
+public:
+    SpatialGrid() : state(nullptr), width(0), height(0) {}
+    explicit SpatialGrid(const GameState& state) : SpatialGrid() { build(state); }
+
+    // Indexes state.agents; the grid keeps a pointer to state, which must
+    // outlive it and not change until the next build
+    void build(const GameState& state);
+
+    bool inside(const Position& pos) const {
+        return pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height;
+    }
+    bool occupied(const Position& pos) const { return agentAt(pos) >= 0; }
+    int agentAt(const Position& pos) const; // Lowest index living agent in the cell, -1 if none
+    const Agent& agent(int index) const { return state->agents[index]; }
+
+    // Queries over living agents whose team differs from team. They return
+    // indices into state.agents, closest first.
+    int nearestEnemy(const Position& from, std::string_view team) const; // -1 if none
+    std::vector<int> kNearestEnemies(const Position& from, std::string_view team, size_t k) const;
+    std::vector<int> enemiesInRadius(const Position& from, std::string_view team, int radius) const;
+    int firstEnemyInRadius(const Position& from, std::string_view team, int radius) const; // Lowest index, -1 if none
+
+private:
+    size_t cellIndex(const Position& pos) const {
+        return static_cast<size_t>(pos.y) * width + pos.x;
+    }
+    int64_t distance2(const Position& from, uint32_t agent) const;
+    size_t enemyCount(std::string_view team) const;
+    bool simdSafe(const Position& from) const; // Every delta fits the int32 kernels
+
+    // Calls visit(agent) for every agent in the cells at Chebyshev distance
+    // exactly radius from center
+    template <typename Visit>
+    void visitRing(const Position& center, int radius, Visit&& visit) const;
+};
+
+} // namespace game
@@ -0,0 +1,111 @@
+// common/task.h
+// Declares Task, the lazily started, awaitable C++20 coroutine type used by the CoroutineLoop
+#pragma once
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+
+namespace net {
+
+template <typename T = void>
+class Task;
+
+namespace detail {
+
+// Hands control back to whoever awaited the finished task, without growing the stack
+struct FinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> done) const noexcept {
+        std::coroutine_handle<> next = done.promise().continuation;
+        return next ? next : std::noop_coroutine();
+    }
+    void await_resume() const noexcept {}
+};
+
+struct PromiseBase {
+    std::coroutine_handle<> continuation; // The awaiting coroutine
+    std::exception_ptr error;
+
+    std::suspend_always initial_suspend() const noexcept { return {}; } // Runs when first awaited
+    FinalAwaiter final_suspend() const noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct Promise : PromiseBase {
+    std::optional<T> value;
+
+    Task<T> get_return_object();
+    template <typename U>
+    void return_value(U&& result) { value.emplace(std::forward<U>(result)); }
+    T take() {
+        if (error) std::rethrow_exception(error);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase {
+    Task<void> get_return_object();
+    void return_void() const noexcept {}
+    void take() const {
+        if (error) std::rethrow_exception(error);
+    }
+};
+
+} // namespace detail
+
+// A coroutine that starts when awaited and resumes its awaiter when it
+// finishes, handing over its result or rethrowing its exception. The Task
+// owns the frame. Use CoroutineLoop::spawn to run one without awaiting it.
+template <typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+private:
+    Handle handle;
+
+public:
+    explicit Task(Handle handle) : handle(handle) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, {})) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    // Awaiting starts the task; the caller continues from its final suspend
+    bool await_ready() const noexcept { return !handle || handle.done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+        handle.promise().continuation = caller;
+        return handle;
+    }
+    T await_resume() { return handle.promise().take(); }
+};
+
+namespace detail {
+
+template <typename T>
+Task<T> Promise<T>::get_return_object() {
+    return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+}
+
+inline Task<void> Promise<void>::get_return_object() {
+    return Task<void>(std::coroutine_handle<Promise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+} // namespace net
@@ -1,18 +1,85 @@
 // common/tcp_connection.cpp
 // Implements the TCP connection and server classes for network communication
 #include "tcp_connection.h"
+#include "metrics.h"
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <climits>
 #include <arpa/inet.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <cerrno>
 #include <cstring>
+#include <algorithm>
 #include <iostream>
 
 namespace net {
 
-TcpConnection::TcpConnection() : socket_fd(-1), connected(false) {}
+namespace {
+
+// Process-wide traffic, every connection together. Fetched on first use, so
+// connections opened from other static initializers are counted too.
+struct Traffic {
+    metrics::Counter& bytes_sent;
+    metrics::Counter& frames_sent;
+    metrics::Counter& bytes_received;
+    metrics::Counter& frames_received;
+};
+
+Traffic& traffic() {
+    static Traffic counters{metrics::Registry::global().counter("tcp_sent_bytes_total"),
+                            metrics::Registry::global().counter("tcp_sent_frames_total"),
+                            metrics::Registry::global().counter("tcp_received_bytes_total"),
+                            metrics::Registry::global().counter("tcp_received_frames_total")};
+    return counters;
+}
+
+} // namespace
+
+OutboundQueue::OutboundQueue(size_t max_bytes)
+    : queued_bytes(0), max_bytes(max_bytes), scheduled(false), closed(false) {}
+
+PostStatus OutboundQueue::post(std::string_view message) {
+    if (closed.load(std::memory_order_acquire)) return PostStatus::closed;
+
+    // Checked before adding, so one frame larger than the limit still goes out
+    size_t frame_size = sizeof(uint32_t) + message.size();
+    if (queued_bytes.load(std::memory_order_relaxed) >= max_bytes.load(std::memory_order_relaxed)) {
+        return PostStatus::backpressure;
+    }
+
+    std::string frame(frame_size, '\0'); // Length prefix and body in one allocation
+    uint32_t length = htonl(message.size());
+    std::memcpy(frame.data(), &length, sizeof(length));
+    std::memcpy(frame.data() + sizeof(length), message.data(), message.size());
+    queued_bytes.fetch_add(frame_size, std::memory_order_relaxed);
+    frames.push(std::move(frame));
+
+    if (!scheduled.exchange(true, std::memory_order_acq_rel) && on_ready) {
+        on_ready(); // Only the first post since the last take wakes the I/O thread
+    }
+    return PostStatus::queued;
+}
+
+size_t OutboundQueue::takeAll(std::deque<std::string>& out) {
+    scheduled.store(false, std::memory_order_release); // Posts from here on notify again
+    return frames.consumeAll([&out](std::string&& frame) { out.push_back(std::move(frame)); });
+}
 
-TcpConnection::TcpConnection(int fd) : socket_fd(fd), connected(true) {}
+void OutboundQueue::close() {
+    closed.store(true, std::memory_order_release);
+    frames.consumeAll([this](std::string&& frame) { written(frame.size()); });
+}
+
+TcpConnection::TcpConnection()
+    : socket_fd(-1), connected(false), recv_begin(0), recv_end(0), send_offset(0), frame_start(0),
+      outbound(std::make_shared<OutboundQueue>()), outbound_offset(0) {}
+
+TcpConnection::TcpConnection(int fd)
+    : socket_fd(fd), connected(true), recv_begin(0), recv_end(0), send_offset(0), frame_start(0),
+      outbound(std::make_shared<OutboundQueue>()), outbound_offset(0) {}
 
 TcpConnection::~TcpConnection() {
     disconnect(); // Ensure socket is closed
@@ -43,6 +110,9 @@ bool TcpConnection::connect(const std::string& host, int port) { // Client-side
         return false;
     }
 
+    if (outbound->isClosed()) { // Reconnecting after a disconnect
+        outbound = std::make_shared<OutboundQueue>();
+    }
     connected = true;
     return true;
 }
@@ -53,85 +123,304 @@ void TcpConnection::disconnect() { // Close the connection
         socket_fd = -1; // Mark as closed
     }
     connected = false;
+    recv_begin = recv_end = 0; // Drop any partial frame
+    send_buffer.clear();
+    send_offset = 0;
+    outbound->close(); // Producers holding the queue now get PostStatus::closed
+    outbound_frames.clear();
+    outbound_offset = 0;
 }
 
 bool TcpConnection::sendMessage(const std::string& message) {
     if (!connected) return false; // Very connection status is active
 
-    // Send message length first (4 bytes)
+    // Length prefix (4 bytes) and message data go out in the same syscall
     uint32_t length = htonl(message.length());
-    if (!sendAll(reinterpret_cast<const char*>(&length), sizeof(length))) {
-        return false;
+    iovec iov[2];
+    iov[0].iov_base = &length;
+    iov[0].iov_len = sizeof(length);
+    iov[1].iov_base = const_cast<char*>(message.data());
+    iov[1].iov_len = message.length();
+    if (!sendVectored(iov, 2)) return false;
+    traffic().frames_sent.add();
+    return true;
+}
+
+bool TcpConnection::sendBatch(const std::vector<std::string>& messages) {
+    if (!connected) return false; // Very connection status is active
+    if (messages.empty()) return true;
+
+    // One header + one body entry per message, written as a single stream
+    std::vector<uint32_t> lengths(messages.size());
+    std::vector<iovec> iov(messages.size() * 2);
+    for (size_t i = 0; i < messages.size(); ++i) {
+        lengths[i] = htonl(messages[i].length());
+        iov[2 * i].iov_base = &lengths[i];
+        iov[2 * i].iov_len = sizeof(uint32_t);
+        iov[2 * i + 1].iov_base = const_cast<char*>(messages[i].data());
+        iov[2 * i + 1].iov_len = messages[i].length();
     }
+    if (!sendVectored(iov.data(), iov.size())) return false;
+    traffic().frames_sent.add(messages.size());
+    return true;
+}
+
+bool TcpConnection::setNoDelay(bool enabled) {
+    int opt = enabled ? 1 : 0;
+    return setsockopt(socket_fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) == 0;
+}
 
-    // Send message data
-    return sendAll(message.c_str(), message.length());
+bool TcpConnection::setCork(bool enabled) {
+    int opt = enabled ? 1 : 0;
+    return setsockopt(socket_fd, IPPROTO_TCP, TCP_CORK, &opt, sizeof(opt)) == 0;
 }
 
 std::string TcpConnection::receiveMessage() {
-    if (!connected) return ""; // Very connection status is active
+    return std::string(receiveFrame());
+}
 
-    // Receive message length first (4 bytes)
-    auto length_data = receiveAll(sizeof(uint32_t));
-    if (length_data.empty()) {
-        return ""; // Error or connection closed
+std::string_view TcpConnection::receiveFrame() {
+    std::string_view frame;
+    while (connected) { // Very connection status is active
+        if (nextFrame(frame)) {
+            return frame; // Points into recv_buffer until the next receive
+        }
+        if (!connected || !fillBuffer()) {
+            break; // Oversized frame, error or connection closed
+        }
     }
+    return {};
+}
+
+bool TcpConnection::sendVectored(iovec* iov, size_t count) { // Ensure every buffer is sent
+    while (count > 0) {
+        msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = std::min<size_t>(count, IOV_MAX);
+
+        ssize_t result = sendmsg(socket_fd, &msg, MSG_NOSIGNAL); // Gather write, no SIGPIPE
+        if (result <= 0) { // Error or connection closed
+            std::cerr << "Send failed" << std::endl;
+            connected = false;
+            return false;
+        }
+
+        // Skip the buffers that were fully written and trim a partial one
+        size_t sent = static_cast<size_t>(result);
+        traffic().bytes_sent.add(sent);
+        while (count > 0 && sent >= iov->iov_len) {
+            sent -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + sent;
+            iov->iov_len -= sent;
+        }
+    }
+    return true; // All data sent successfully
+}
+
+bool TcpConnection::nextFrame(std::string_view& frame) { // Splits one frame off the buffer
+    size_t available = recv_end - recv_begin;
+    if (available < sizeof(uint32_t)) return false; // Header not complete yet
+
+    uint32_t length;
+    std::memcpy(&length, recv_buffer.data() + recv_begin, sizeof(length));
+    length = ntohl(length); // Convert from network byte order to host byte order
 
-    uint32_t length = ntohl(*reinterpret_cast<uint32_t*>(length_data.data())); // Convert from network byte order to host byte order
-    
     // Sanity check on message length
-    if (length > 1024 * 1024) { // 1MB limit
+    if (length > MAX_MESSAGE_SIZE) {
         std::cerr << "Message too large: " << length << " bytes" << std::endl;
-        return "";
+        // The stream can no longer be framed. Only marked: other threads may
+        // be sending, so the thread that owns the connection closes it
+        connected = false;
+        return false;
     }
 
-    // Receive message data
-    auto message_data = receiveAll(length);
-    if (message_data.empty()) {
-        return "";
+    if (available < sizeof(uint32_t) + length) return false; // Body not complete yet
+
+    frame = std::string_view(recv_buffer.data() + recv_begin + sizeof(uint32_t), length);
+    recv_begin += sizeof(uint32_t) + length;
+    traffic().frames_received.add();
+    return true;
+}
+
+bool TcpConnection::fillBuffer() { // Read as much as the socket has, in one call
+    ssize_t result = recvIntoBuffer();
+    if (result <= 0) { // Error or connection closed
+        if (result == 0) {
+            std::cerr << "Connection closed by peer" << std::endl;
+        } else {
+            std::cerr << "Receive failed" << std::endl;
+        }
+        connected = false;
+        return false;
+    }
+    return true;
+}
+
+ssize_t TcpConnection::recvIntoBuffer() {
+    if (recv_begin == recv_end) {
+        recv_begin = recv_end = 0; // Everything consumed, start from the front
+    } else if (recv_begin > 0) {
+        // Move the partial frame to the front so it can grow contiguously
+        std::memmove(recv_buffer.data(), recv_buffer.data() + recv_begin, recv_end - recv_begin);
+        recv_end -= recv_begin;
+        recv_begin = 0;
+    }
+
+    // Make room for the pending frame (if its header is known) or one chunk
+    size_t wanted = RECV_CHUNK_SIZE;
+    if (recv_end >= sizeof(uint32_t)) {
+        uint32_t length;
+        std::memcpy(&length, recv_buffer.data(), sizeof(length));
+        wanted = std::max(wanted, sizeof(uint32_t) + ntohl(length) - recv_end);
+    }
+    if (recv_buffer.size() < recv_end + wanted) {
+        recv_buffer.resize(recv_end + wanted);
+    }
+
+    ssize_t result = recv(socket_fd, recv_buffer.data() + recv_end, recv_buffer.size() - recv_end, 0);
+    if (result > 0) {
+        recv_end += result;
+        traffic().bytes_received.add(result);
+    }
+    return result;
+}
+
+bool TcpConnection::setNonBlocking(bool enabled) {
+    int flags = fcntl(socket_fd, F_GETFL, 0);
+    if (flags < 0) return false;
+    flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return fcntl(socket_fd, F_SETFL, flags) == 0;
+}
+
+IoStatus TcpConnection::receiveSome() {
+    if (!connected) return IoStatus::closed;
+
+    ssize_t result = recvIntoBuffer();
+    if (result > 0) return IoStatus::ok;
+    if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return IoStatus::would_block;
+    if (result < 0 && errno == EINTR) return IoStatus::ok; // Retry on the next call
+    connected = false; // Closed by peer or failed
+    return IoStatus::closed;
+}
+
+void TcpConnection::queueMessage(std::string_view message) {
+    beginFrame().append(message);
+    endFrame();
+}
+
+std::string& TcpConnection::beginFrame() {
+    if (send_offset == send_buffer.size()) { // Drained: reuse the buffer from the front
+        send_buffer.clear();
+        send_offset = 0;
     }
+    frame_start = send_buffer.size();
+    send_buffer.append(sizeof(uint32_t), '\0'); // Length, known at endFrame
+    return send_buffer;
+}
 
-    return std::string(message_data.data(), length); // Construct string from received data
+void TcpConnection::endFrame() {
+    uint32_t length = htonl(send_buffer.size() - frame_start - sizeof(uint32_t));
+    std::memcpy(send_buffer.data() + frame_start, &length, sizeof(length));
+    traffic().frames_sent.add(); // Counted once framed; the bytes when they reach the socket
 }
 
-bool TcpConnection::sendAll(const char* data, size_t length) { // Ensure all data is sent
-    size_t sent = 0; // Track how many bytes have been sent
-    while (sent < length) { // While not all data is sent
-        ssize_t result = send(socket_fd, data + sent, length - sent, 0); // Send remaining data
+IoStatus TcpConnection::flushPending() {
+    if (!connected) return IoStatus::closed;
+
+    IoStatus status = finishOutboundFrame();
+    if (status != IoStatus::ok) return status;
+    while (send_offset < send_buffer.size()) {
+        ssize_t result = send(socket_fd, send_buffer.data() + send_offset,
+                              send_buffer.size() - send_offset, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) continue;
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return IoStatus::would_block;
         if (result <= 0) { // Error or connection closed
-            std::cerr << "Send failed" << std::endl;
             connected = false;
-            return false;
+            return IoStatus::closed;
         }
-        sent += result; 
+        send_offset += result;
+        traffic().bytes_sent.add(result);
     }
-    return true; // All data sent successfully
+    send_buffer.clear(); // Keeps capacity for the next frames
+    send_offset = 0;
+    return flushOutbound();
 }
 
-std::vector<char> TcpConnection::receiveAll(size_t length) { // Ensure all data is received
-    std::vector<char> buffer(length); // Buffer to hold received data
-    size_t received = 0; // Track how many bytes have been received
-    
-    while (received < length) { // While not all data is received
-        ssize_t result = recv(socket_fd, buffer.data() + received, length - received, 0); // Receive remaining data
+IoStatus TcpConnection::flushOutbound() {
+    outbound->takeAll(outbound_frames);
+
+    std::vector<iovec> iov;
+    while (!outbound_frames.empty()) {
+        // One entry per frame, the first one trimmed by what a partial write left
+        size_t count = std::min<size_t>(outbound_frames.size(), IOV_MAX);
+        iov.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            size_t skip = (i == 0) ? outbound_offset : 0;
+            iov[i].iov_base = outbound_frames[i].data() + skip;
+            iov[i].iov_len = outbound_frames[i].size() - skip;
+        }
+
+        msghdr msg{};
+        msg.msg_iov = iov.data();
+        msg.msg_iovlen = count;
+        ssize_t result = sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) continue;
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return IoStatus::would_block;
         if (result <= 0) { // Error or connection closed
-            if (result == 0) {
-                std::cerr << "Connection closed by peer" << std::endl;
-            } else {
-                std::cerr << "Receive failed" << std::endl;
+            connected = false;
+            return IoStatus::closed;
+        }
+
+        size_t sent = static_cast<size_t>(result);
+        outbound->written(sent);
+        traffic().bytes_sent.add(sent);
+        while (sent > 0) {
+            size_t left = outbound_frames.front().size() - outbound_offset;
+            if (sent < left) {
+                outbound_offset += sent;
+                break;
             }
+            sent -= left;
+            outbound_frames.pop_front();
+            outbound_offset = 0;
+            traffic().frames_sent.add();
+        }
+    }
+    return IoStatus::ok;
+}
+
+IoStatus TcpConnection::finishOutboundFrame() {
+    while (outbound_offset > 0) {
+        const std::string& frame = outbound_frames.front();
+        ssize_t result = send(socket_fd, frame.data() + outbound_offset, frame.size() - outbound_offset, MSG_NOSIGNAL);
+        if (result < 0 && errno == EINTR) continue;
+        if (result < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return IoStatus::would_block;
+        if (result <= 0) { // Error or connection closed
             connected = false;
-            return {};
+            return IoStatus::closed;
+        }
+
+        outbound->written(result);
+        traffic().bytes_sent.add(result);
+        outbound_offset += result;
+        if (outbound_offset == frame.size()) {
+            outbound_frames.pop_front();
+            outbound_offset = 0;
+            traffic().frames_sent.add();
         }
-        received += result;
     }
-    
-    return buffer; // All data received successfully
+    return IoStatus::ok;
 }
 
 // TcpServer implementation
 
-TcpServer::TcpServer(int port) : server_fd(-1), port(port), running(false) {} // Server_fd(-1) means socket not created
+TcpServer::TcpServer(int port, int backlog)
+    : server_fd(-1), port(port), backlog(backlog), running(false), no_delay(false),
+      non_blocking(false), log_connections(true) {} // Server_fd(-1) means socket not created
 
 
 TcpServer::~TcpServer() {
@@ -166,13 +455,18 @@ bool TcpServer::start() {
         return false;
     }
 
-    if (listen(server_fd, 10) < 0) { // Start listening for connections
+    if (listen(server_fd, backlog) < 0) { // Start listening for connections
         std::cerr << "Listen failed" << std::endl;
         close(server_fd);
         server_fd = -1;
         return false;
     }
 
+    if (non_blocking) { // accept() must not block the event loop
+        int flags = fcntl(server_fd, F_GETFL, 0);
+        fcntl(server_fd, F_SETFL, flags | O_NONBLOCK);
+    }
+
     running = true; // Mark server as running
     std::cout << "Server started on port " << port << std::endl;
     return true; // Server started successfully
@@ -186,25 +480,38 @@ void TcpServer::stop() {
     }
 }
 
-std::unique_ptr<TcpConnection> TcpServer::acceptConnection() { // Accept a new client connection
+std::unique_ptr<TcpConnection> TcpServer::acceptConnection(int* error) { // Accept a new client connection
+    if (error) *error = 0;
     if (!running) return nullptr; // Server must be running to accept connections
 
     sockaddr_in client_addr{};
     socklen_t addr_len = sizeof(client_addr); 
     
-    int client_fd = accept(server_fd, (sockaddr*)&client_addr, &addr_len); // Accept new connection
+    int flags = non_blocking ? SOCK_NONBLOCK : 0;
+    int client_fd = accept4(server_fd, (sockaddr*)&client_addr, &addr_len, flags); // Accept new connection
     if (client_fd < 0) { // Error accepting connection
+        int accept_errno = errno;
+        if (error) *error = accept_errno;
+        if (non_blocking && (accept_errno == EAGAIN || accept_errno == EWOULDBLOCK)) {
+            return nullptr; // No pending connection
+        }
         if (running) { // Only log error if we're still supposed to be running
-            std::cerr << "Accept failed" << std::endl;
+            std::cerr << "Accept failed: " << std::strerror(accept_errno) << std::endl;
         }
         return nullptr; // Return null on failure
     }
 
-    char client_ip[INET_ADDRSTRLEN]; // Convert client address to string
-    inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
-    std::cout << "New connection from " << client_ip << ":" << ntohs(client_addr.sin_port) << std::endl;
+    if (log_connections) {
+        char client_ip[INET_ADDRSTRLEN]; // Convert client address to string
+        inet_ntop(AF_INET, &client_addr.sin_addr, client_ip, INET_ADDRSTRLEN);
+        std::cout << "New connection from " << client_ip << ":" << ntohs(client_addr.sin_port) << std::endl;
+    }
 
-    return std::make_unique<TcpConnection>(client_fd); // Return new TcpConnection object
+    auto connection = std::make_unique<TcpConnection>(client_fd); // Wrap in a TcpConnection object
+    if (no_delay) {
+        connection->setNoDelay(true);
+    }
+    return connection;
 }
 
 } // namespace net
\ No newline at end of file
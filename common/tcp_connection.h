@@ -1,19 +1,99 @@
 // common/tcp_connection.h
 // Declare the TcpConnection/TcpServer classes for the tcp_connection.cpp
 #pragma once
+#include "mpsc_queue.h"
+#include <atomic>
+#include <deque>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
 #include <functional>
+#include <sys/types.h>
+
+struct iovec;
 
 namespace net {
 
+// Outcome of a non-blocking socket operation
+enum class IoStatus {
+    ok,          // Progress was made
+    would_block, // Nothing more can be done until the socket is ready again
+    closed       // Peer closed the connection or an error occurred
+};
+
+// Outcome of OutboundQueue::post
+enum class PostStatus {
+    queued,       // The I/O thread will write it
+    backpressure, // Too many bytes still unwritten for this peer, try later or drop
+    closed        // The connection is gone
+};
+
+// Frames that any thread wants to send on one connection. Producers post
+// without locks; the connection's I/O thread takes them all at once in
+// TcpConnection::flushPending and writes them with vectored writes.
+//
+// Bytes count as queued until they reach the socket, so a slow peer that
+// stops reading fills its queue and further posts get backpressure instead
+// of growing memory without limit.
+class OutboundQueue {
+public:
+    using ReadyHandler = std::function<void()>;
+    static constexpr size_t DEFAULT_MAX_BYTES = 8 * 1024 * 1024;
+
+private:
+    concurrency::MpscQueue<std::string> frames; // Length prefix included
+    std::atomic<size_t> queued_bytes;
+    std::atomic<size_t> max_bytes;
+    std::atomic<bool> scheduled; // A ready notification is pending since the last take
+    std::atomic<bool> closed;
+    ReadyHandler on_ready;
+
+public:
+    explicit OutboundQueue(size_t max_bytes = DEFAULT_MAX_BYTES);
+
+    // Any thread
+    PostStatus post(std::string_view message);
+    size_t queuedBytes() const { return queued_bytes.load(std::memory_order_relaxed); }
+    void setMaxBytes(size_t bytes) { max_bytes.store(bytes, std::memory_order_relaxed); }
+    bool isClosed() const { return closed.load(std::memory_order_acquire); }
+
+    // Called by the first post after each take, from the posting thread. Set
+    // before producers start; it must outlive them (the EventLoop's does).
+    void onReady(ReadyHandler handler) { on_ready = std::move(handler); }
+
+    // I/O thread only
+    size_t takeAll(std::deque<std::string>& out); // Appends in post order
+    void written(size_t bytes) { queued_bytes.fetch_sub(bytes, std::memory_order_relaxed); }
+    void close(); // Later posts fail, queued frames are dropped
+};
+
 class TcpConnection {
 private:
     int socket_fd;
-    bool connected;
+    std::atomic<bool> connected; // Read by other threads (e.g. rpc::Client senders)
+
+    // Per-connection receive buffer, reused across frames. Bytes in
+    // [recv_begin, recv_end) have been read from the socket but not consumed.
+    std::vector<char> recv_buffer;
+    size_t recv_begin;
+    size_t recv_end;
+
+    // Pending outbound bytes for non-blocking mode; [send_offset, end) not yet written
+    std::string send_buffer;
+    size_t send_offset;
+    size_t frame_start; // Length prefix of the frame open between beginFrame and endFrame
+
+    // Frames posted by other threads, and the ones taken from there that are
+    // not fully written yet; [outbound_offset, end) of the first is pending
+    std::shared_ptr<OutboundQueue> outbound;
+    std::deque<std::string> outbound_frames;
+    size_t outbound_offset;
 
 public:
+    static constexpr size_t MAX_MESSAGE_SIZE = 1024 * 1024; // 1MB limit per frame
+    static constexpr size_t RECV_CHUNK_SIZE = 64 * 1024;    // Bytes requested per recv
+
     TcpConnection();
     explicit TcpConnection(int fd);
     ~TcpConnection();
@@ -23,37 +103,80 @@ public:
     void disconnect();
 
     // Send/receive operations
-    bool sendMessage(const std::string& message);
-    std::string receiveMessage();
-    
+    bool sendMessage(const std::string& message);                // Header and body in one writev
+    bool sendBatch(const std::vector<std::string>& messages);    // Many frames, one vectored write
+    std::string receiveMessage();      // Copying wrapper around receiveFrame
+    std::string_view receiveFrame();   // View valid until the next receive call
+
+    // Non-blocking operations, used by the EventLoop
+    bool setNonBlocking(bool enabled);
+    IoStatus receiveSome();                          // One recv into the receive buffer
+    // Next buffered frame, view valid until receiveSome. An oversized length
+    // prefix marks the connection disconnected (isConnected() turns false)
+    // without closing it; the owner calls disconnect()
+    bool nextFrame(std::string_view& frame);
+    void queueMessage(std::string_view message);     // Frame into the send buffer
+    // Builds a frame in place: append the body to the returned buffer, then
+    // call endFrame to fill in its length. Nothing is copied on the way.
+    std::string& beginFrame();
+    void endFrame();
+    // Send buffer, then posted frames, until drained or blocked. A posted frame
+    // cut by a partial write is finished first, so frames never interleave.
+    IoStatus flushPending();
+    bool hasPendingWrites() const { return send_offset < send_buffer.size() || !outbound_frames.empty(); }
+    size_t pendingWriteBytes() const { return send_buffer.size() - send_offset + outbound->queuedBytes(); }
+
+    // Thread-safe send path: producers keep the queue and post to it, the
+    // thread that owns the connection writes it out in flushPending
+    std::shared_ptr<OutboundQueue> outboundQueue() const { return outbound; }
+
+    // Socket options
+    bool setNoDelay(bool enabled); // TCP_NODELAY: disable Nagle for request/response traffic
+    bool setCork(bool enabled);    // TCP_CORK: hold partial segments until uncorked
+
     // Status
     bool isConnected() const { return connected; }
     int getSocketFd() const { return socket_fd; }
 
 private:
-    bool sendAll(const char* data, size_t length);
-    std::vector<char> receiveAll(size_t length);
+    bool sendVectored(struct iovec* iov, size_t count); // Handles partial writes
+    IoStatus flushOutbound();                           // Posted frames, IOV_MAX per writev
+    IoStatus finishOutboundFrame();                     // Rest of the posted frame a partial write cut
+    bool fillBuffer();                          // One large recv into the buffer
+    ssize_t recvIntoBuffer();                   // Compacts, grows and reads once
 };
 
 class TcpServer {
 private:
     int server_fd;
     int port;
+    int backlog;
     bool running;
+    bool no_delay;         // Applied to every accepted connection
+    bool non_blocking;     // Listening socket and accepted sockets are non-blocking
+    bool log_connections;  // Print a line per accepted connection
 
 public:
-    explicit TcpServer(int port = 8080);
+    explicit TcpServer(int port = 8080, int backlog = 4096);
     ~TcpServer();
 
     bool start();
     void stop();
     
-    // Accept new connections
-    std::unique_ptr<TcpConnection> acceptConnection();
-    
+    // Accept new connections; in non-blocking mode returns nullptr when none is pending
+    // nullptr when nothing was accepted; error, if given, gets the errno
+    // (EAGAIN once a non-blocking server has nothing pending)
+    std::unique_ptr<TcpConnection> acceptConnection(int* error = nullptr);
+
+    // Options, set before start()
+    void setNoDelay(bool enabled) { no_delay = enabled; }
+    void setNonBlocking(bool enabled) { non_blocking = enabled; }
+    void setLogConnections(bool enabled) { log_connections = enabled; }
+
     // Status
     bool isRunning() const { return running; }
     int getPort() const { return port; }
+    int getServerFd() const { return server_fd; }
 };
 
 } // namespace net
\ No newline at end of file
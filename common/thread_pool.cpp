@@ -0,0 +1,125 @@
+// common/thread_pool.cpp
+// Implements the work-stealing thread pool
+#include "thread_pool.h"
+#include <algorithm>
+#include <exception>
+
+namespace concurrency {
+
+namespace {
+// Pool and worker index of the current thread; NOT_A_WORKER outside any pool
+constexpr size_t NOT_A_WORKER = static_cast<size_t>(-1);
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local size_t current_worker = NOT_A_WORKER;
+}
+
+ThreadPool::ThreadPool(size_t threads) : queued(0), next_queue(0), stopping(false) {
+    for (size_t i = 0; i < threads; ++i) queues.push_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < threads; ++i) workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) worker.join();
+}
+
+void ThreadPool::submit(Task task) {
+    if (queues.empty()) { // No workers: run inline
+        task();
+        return;
+    }
+    size_t target = current_pool == this ? current_worker : next_queue++ % queues.size();
+    {
+        // Counted before the push so queued never drops below zero when the
+        // task is stolen right away. Taken under sleep_mutex so a worker
+        // between its check and its wait cannot miss the wake up.
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        queued++;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+}
+
+bool ThreadPool::runOne(size_t self) {
+    Task task;
+    const size_t count = queues.size();
+    // self == NOT_A_WORKER (the caller of parallelFor) only steals
+    for (size_t k = 0; k < count && !task; ++k) {
+        size_t victim = self == NOT_A_WORKER ? k : (self + k) % count;
+        Queue& queue = *queues[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        if (victim == self) { // Own deque: newest first, its data is still in cache
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        } else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+    queued--;
+    task();
+    return true;
+}
+
+void ThreadPool::workerLoop(size_t self) {
+    current_pool = this;
+    current_worker = self;
+    while (true) {
+        if (runOne(self)) continue;
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        wake.wait(lock, [this] { return queued > 0 || stopping; });
+        if (stopping && queued == 0) return;
+    }
+}
+
+void ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& body, size_t grain) {
+    if (n == 0) return;
+    grain = std::max<size_t>(1, grain);
+    size_t chunks = (n + grain - 1) / grain;
+    if (queues.empty() || chunks == 1) {
+        for (size_t i = 0; i < n; ++i) body(i);
+        return;
+    }
+
+    // A few chunks per worker leaves room for stealing
+    chunks = std::min(chunks, 4 * (queues.size() + 1));
+    const size_t per_chunk = (n + chunks - 1) / chunks;
+    chunks = (n + per_chunk - 1) / per_chunk;
+
+    std::atomic<size_t> remaining(chunks);
+    std::mutex error_mutex;
+    std::exception_ptr error;
+    auto runChunk = [&](size_t chunk) {
+        size_t begin = chunk * per_chunk;
+        size_t end = std::min(n, begin + per_chunk);
+        try {
+            for (size_t i = begin; i < end; ++i) body(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(error_mutex);
+            if (!error) error = std::current_exception();
+        }
+        remaining--;
+    };
+    for (size_t chunk = 1; chunk < chunks; ++chunk) {
+        submit([&runChunk, chunk] { runChunk(chunk); });
+    }
+    runChunk(0);
+
+    // Help with whatever is queued (ours or not) until our chunks are done
+    const size_t self = current_pool == this ? current_worker : NOT_A_WORKER;
+    while (remaining > 0) {
+        if (!runOne(self)) std::this_thread::yield();
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+} // namespace concurrency
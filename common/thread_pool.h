@@ -0,0 +1,64 @@
+// common/thread_pool.h
+// Declares a work-stealing thread pool with a blocking parallelFor
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace concurrency {
+
+// Fixed set of workers, each owning a deque of tasks. A worker pops the newest
+// task of its own deque and, when it runs dry, steals the oldest one of
+// another worker, so uneven tasks (an agent next to a fight against one in an
+// empty corner) even out without a central queue every worker contends on.
+//
+// A pool of 0 threads is valid: parallelFor then runs everything on the
+// caller, which is what a single-core machine wants anyway.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues; // One per worker
+    std::vector<std::thread> workers;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    std::atomic<size_t> queued;    // Tasks in all the deques, for sleeping workers
+    std::atomic<size_t> next_queue; // Round robin for tasks submitted from outside the pool
+    std::atomic<bool> stopping;
+
+public:
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency());
+    ~ThreadPool(); // Runs what is still queued, then joins
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // Queues a task. From a worker it goes to that worker's own deque. Tasks
+    // must not throw; use parallelFor to get exceptions back.
+    void submit(Task task);
+
+    // Calls body(i) for every i in [0, n), in chunks of about grain indices,
+    // and returns when all of them finished. The caller works too instead of
+    // just waiting. The first exception thrown by body is rethrown here.
+    void parallelFor(size_t n, const std::function<void(size_t)>& body, size_t grain = 1);
+
+private:
+    void workerLoop(size_t self);
+    bool runOne(size_t self); // Own deque first, then steal; false if every deque was empty
+};
+
+} // namespace concurrency
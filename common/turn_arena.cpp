@@ -0,0 +1,39 @@
+// common/turn_arena.cpp
+// Implements the monotonic per-turn arena
+#include "turn_arena.h"
+#include <algorithm>
+
+namespace game {
+
+void* TurnArena::Overflow::do_allocate(size_t size, size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void TurnArena::Overflow::do_deallocate(void* p, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+TurnArena::TurnArena(size_t initial_size)
+    : buffer(std::make_unique_for_overwrite<std::byte[]>(std::max<size_t>(initial_size, 1))),
+      buffer_size(std::max<size_t>(initial_size, 1)), grows(0) {
+    arena.emplace(buffer.get(), buffer_size, &overflow);
+}
+
+void TurnArena::reset() {
+    if (overflow.bytes == 0) {
+        arena->release(); // Back to the start of the buffer, nothing to free
+        return;
+    }
+
+    // Room for everything the last turn used, with slack for the next one
+    size_t wanted = std::max(buffer_size * 2, buffer_size + overflow.bytes);
+    arena.reset(); // Returns the borrowed blocks
+    overflow.bytes = 0;
+    buffer = std::make_unique_for_overwrite<std::byte[]>(wanted);
+    buffer_size = wanted;
+    arena.emplace(buffer.get(), buffer_size, &overflow);
+    grows++;
+}
+
+} // namespace game
@@ -0,0 +1,60 @@
+// common/turn_arena.h
+// Declares the monotonic per-turn arena that backs short-lived GameStates
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace game {
+
+// Everything a turn decodes (the agents and bases vectors, their id and team
+// strings) is dropped together when the next turn arrives. A TurnArena hands
+// that memory out of one buffer by bumping a pointer and takes it all back
+// with reset(), without visiting the objects.
+//
+// The buffer sizes itself: a turn that did not fit borrows the rest from the
+// heap, and the following reset() grows the buffer to what that turn needed.
+// After the first turns of a match nothing reaches the heap any more.
+//
+// Whatever was allocated from resource() must be destroyed (or at least never
+// touched again) before reset(). Not thread-safe: one arena per decoding thread.
+class TurnArena {
+private:
+    // Heap fallback that remembers how much the arena had to borrow
+    class Overflow : public std::pmr::memory_resource {
+    public:
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    std::unique_ptr<std::byte[]> buffer;
+    size_t buffer_size;
+    Overflow overflow;
+    std::optional<std::pmr::monotonic_buffer_resource> arena;
+    uint64_t grows;
+
+public:
+    static constexpr size_t DEFAULT_SIZE = 256 * 1024;
+
+    explicit TurnArena(size_t initial_size = DEFAULT_SIZE);
+
+    TurnArena(const TurnArena&) = delete;
+    TurnArena& operator=(const TurnArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*arena; }
+
+    // O(1) when the turn fit in the buffer; otherwise one reallocation
+    void reset();
+
+    size_t size() const { return buffer_size; }
+    size_t overflowBytes() const { return overflow.bytes; } // Borrowed from the heap since the last reset
+    uint64_t growCount() const { return grows; }
+};
+
+} // namespace game
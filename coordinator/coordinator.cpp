@@ -0,0 +1,433 @@
+// coordinator/coordinator.cpp
+// Implements the game coordinator described in RPC_PROTOCOL.md
+#include "coordinator.h"
+#include "common/rpc_protocol.h"
+#include "common/binary_codec.h"
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+namespace coordinator {
+
+namespace {
+
+double millisecondsBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1));
+    return values[index];
+}
+
+} // namespace
+
+void MatchReport::print(std::ostream& out) const {
+    out << "Match finished after " << turns.size() << " turns, winner: "
+        << (winner.empty() ? "draw" : winner) << " (" << registered_agents << " agents registered)" << std::endl;
+    if (turns.empty()) return;
+
+    std::vector<double> wall;
+    double agents_total = 0;
+    size_t timeouts = 0;
+    for (const TurnSample& sample : turns) {
+        wall.push_back(sample.dispatch_ms + sample.resolve_ms);
+        agents_total += sample.agents;
+        timeouts += sample.timeouts;
+    }
+    double mean = std::accumulate(wall.begin(), wall.end(), 0.0) / wall.size();
+    out << "Turn wall time for " << agents_total / turns.size() << " agents/turn on average: "
+        << "mean " << mean << " ms, p50 " << percentile(wall, 0.50) << " ms, p99 "
+        << percentile(wall, 0.99) << " ms, max " << percentile(wall, 1.0) << " ms, "
+        << timeouts << " timed out requests" << std::endl;
+    out << intel_acked << " of " << intel_sent << " receive_intel requests acked" << std::endl;
+}
+
+GameCoordinator::GameCoordinator(const CoordinatorConfig& config)
+    : config(config), server(config.port), loop(&server),
+      resolve_pool(config.resolve_threads > 1 ? config.resolve_threads - 1 : 0), has_last_sent(false),
+      intel_sent(0), intel_acked(0), turn_outstanding(0), turn_timeouts(0), next_call_id(1),
+      registration_open(true) {
+    state.config = config.game;
+
+    // Two teams, bases in opposite corners
+    teams = {"red", "blue"};
+    state.bases.emplace_back("red", game::Position(2, 2));
+    state.bases.emplace_back("blue", game::Position(config.game.map_width - 3, config.game.map_height - 3));
+}
+
+bool GameCoordinator::start() {
+    server.setNonBlocking(true);
+    server.setNoDelay(true);
+    server.setLogConnections(config.verbose);
+    if (!server.start() || !loop.init()) {
+        return false;
+    }
+
+    loop.onMessage([this](ConnectionId connection, std::string_view frame) {
+        handleMessage(connection, frame);
+    });
+    loop.onClose([this](ConnectionId connection) {
+        handleClose(connection);
+    });
+    return true;
+}
+
+MatchReport GameCoordinator::run() {
+    MatchReport report;
+
+    // 1. Registration
+    auto registration_deadline = Clock::now() + config.registration_timeout;
+    while (agents.size() < config.expected_agents && Clock::now() < registration_deadline) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(registration_deadline - Clock::now());
+        loop.runOnce(static_cast<int>(std::max<long long>(1, left.count())));
+    }
+    registration_open = false;
+    report.registered_agents = agents.size();
+    if (config.verbose) {
+        std::cout << "Starting match with " << agents.size() << " agents" << std::endl;
+    }
+
+    // 2. Turns
+    if (!config.replay_path.empty() && !recorder.open(config.replay_path, state.config)) {
+        std::cerr << "Could not record the match to " << config.replay_path << std::endl;
+    }
+    while (!agents.empty() && !state.game_over) {
+        TurnSample sample = playTurn();
+        report.turns.push_back(sample);
+        if (config.verbose && (sample.turn == 1 || sample.turn % 50 == 0 || state.game_over)) {
+            std::cout << "Turn " << sample.turn << ": " << sample.agents << " agents, dispatch "
+                      << sample.dispatch_ms << " ms, resolve " << sample.resolve_ms << " ms, "
+                      << sample.timeouts << " timeouts" << std::endl;
+        }
+    }
+
+    // 3. Game over
+    recorder.close();
+    finishGame();
+    report.winner = state.winner;
+    report.intel_sent = intel_sent;
+    report.intel_acked = intel_acked;
+    return report;
+}
+
+void GameCoordinator::handleMessage(ConnectionId connection, std::string_view frame) {
+    std::string type = rpc::extractStringValue(frame, "type");
+    if (type == "register_agent") {
+        registerAgent(connection, frame);
+    } else if (type.empty()) { // Responses carry no type
+        completeCall(rpc::extractStringValue(frame, "id"), frame);
+    } else { // Invalid messages close the connection
+        loop.close(connection);
+    }
+}
+
+void GameCoordinator::handleClose(ConnectionId connection) {
+    auto it = connection_agents.find(connection);
+    if (it == connection_agents.end()) return;
+
+    for (size_t index : it->second) {
+        agents[index].connected = false;
+        state.agents[index].is_alive = false; // A disconnected agent can no longer play
+        state.agents[index].hp = 0;
+    }
+    // Answer its outstanding requests with nothing
+    for (auto call = pending.begin(); call != pending.end();) {
+        auto next = std::next(call);
+        if (!agents[call->second.agent].connected) dropCall(call);
+        call = next;
+    }
+    connection_agents.erase(it);
+}
+
+void GameCoordinator::registerAgent(ConnectionId connection, std::string_view frame) {
+    std::string call_id = rpc::extractStringValue(frame, "id");
+    std::string agent_id = rpc::extractStringValue(frame, "agent_id");
+    if (!registration_open || agent_id.empty() || agent_index.count(agent_id)) {
+        loop.close(connection); // Late, anonymous or duplicated registration
+        return;
+    }
+
+    size_t index = agents.size();
+    const std::string& team = teams[index % teams.size()];
+    game::Agent agent(agent_id, team, game::Position(0, 0), game::SPAWN_HP);
+    spawnAgent(agent, team);
+
+    state.agents.push_back(agent);
+    std::string encoding_name = rpc::extractStringValue(frame, "encoding");
+    Encoding encoding = Encoding::json;
+    if (encoding_name == rpc::ENCODING_BINARY) encoding = Encoding::binary;
+    if (encoding_name == rpc::ENCODING_BINARY_DELTA) encoding = Encoding::binary_delta;
+    agents.push_back({agent_id, connection, true, encoding, true});
+    agent_index.emplace(agent_id, index);
+    connection_agents[connection].push_back(index);
+
+    loop.sendFrame(connection, [&](std::string& out) { rpc::appendVoidResponse(out, call_id); });
+    if (config.verbose && agents.size() <= 16) {
+        std::cout << "Registered " << agent_id << " on team " << team << std::endl;
+    }
+}
+
+std::string GameCoordinator::nextCallId() {
+    return std::to_string(next_call_id++);
+}
+
+bool GameCoordinator::sendRequest(size_t agent, const std::string& call_id, const std::string& message,
+                                  metrics::Histogram& round_trip, bool is_turn, bool flush) {
+    if (!agents[agent].connected) return false;
+
+    // Tracked before sending: a failed send closes the connection and drops the call
+    Clock::time_point sent = Clock::now();
+    Clock::time_point deadline = sent + config.request_timeout;
+    pending[call_id] = PendingCall{agent, is_turn, sent, deadline, &round_trip};
+    deadlines.emplace_back(deadline, call_id);
+    if (is_turn) turn_outstanding++;
+
+    return loop.send(agents[agent].connection, message, flush);
+}
+
+void GameCoordinator::completeCall(const std::string& call_id, std::string_view frame) {
+    auto call = pending.find(call_id);
+    if (call == pending.end()) {
+        lateAnswer(call_id, frame);
+        return;
+    }
+
+    if (intel_calls.count(call_id)) intel_acked++;
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - call->second.sent);
+    call->second.round_trip->record(elapsed.count());
+    if (call->second.is_turn) {
+        turn_actions[call->second.agent] = game::parseAction(rpc::extractStringValue(frame, "action"));
+        if (rpc::extractBoolValue(frame, "resync")) {
+            agents[call->second.agent].needs_snapshot = true; // Its cached state diverged
+        }
+    }
+    dropCall(call);
+}
+
+void GameCoordinator::lateAnswer(const std::string& call_id, std::string_view frame) {
+    // The action of an expired play_turn is ignored, but a resync still
+    // counts: without a snapshot the agent stays out of sync
+    auto expired = expired_turns.find(call_id);
+    if (expired == expired_turns.end()) {
+        expired = expired_turns_previous.find(call_id);
+        if (expired == expired_turns_previous.end()) return;
+    }
+    if (rpc::extractBoolValue(frame, "resync")) agents[expired->second].needs_snapshot = true;
+}
+
+void GameCoordinator::dropCall(std::unordered_map<std::string, PendingCall>::iterator call) {
+    if (call->second.is_turn) turn_outstanding--;
+    intel_calls.erase(call->first);
+    pending.erase(call);
+}
+
+void GameCoordinator::expireCalls(Clock::time_point now) {
+    while (!deadlines.empty()) {
+        auto call = pending.find(deadlines.front().second);
+        if (call == pending.end()) { // Already answered
+            deadlines.pop_front();
+            continue;
+        }
+        if (deadlines.front().first > now) break;
+
+        if (call->second.is_turn) {
+            turn_timeouts++;
+            if (agents[call->second.agent].encoding == Encoding::binary_delta) {
+                expired_turns.emplace(call->first, call->second.agent);
+            }
+        }
+        dropCall(call);
+        deadlines.pop_front();
+    }
+}
+
+void GameCoordinator::waitForCalls(bool turn_only) {
+    // Each request has its own deadline; the loop only sleeps until the
+    // earliest one, so a slow agent never delays reading the others
+    while (turn_only ? turn_outstanding > 0 : !pending.empty()) {
+        Clock::time_point now = Clock::now();
+        expireCalls(now);
+        if (turn_only ? turn_outstanding == 0 : pending.empty()) break;
+
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(deadlines.front().first - now);
+        loop.runOnce(static_cast<int>(std::max<long long>(1, wait.count() + 1)));
+    }
+}
+
+void GameCoordinator::spawnAgent(game::Agent& agent, std::string_view team) {
+    game::Position base(0, 0);
+    for (const game::Base& candidate : state.bases) {
+        if (candidate.team == team) base = candidate.position;
+    }
+
+    auto isFree = [this](const game::Position& pos) {
+        if (pos.x < 0 || pos.y < 0 || pos.x >= state.config.map_width || pos.y >= state.config.map_height) {
+            return false;
+        }
+        for (const game::Base& b : state.bases) {
+            if (b.position == pos) return false;
+        }
+        for (const game::Agent& other : state.agents) {
+            if (other.position == pos) return false;
+        }
+        return true;
+    };
+
+    // Closest free cell around the own base, ring by ring
+    int max_radius = std::max(state.config.map_width, state.config.map_height);
+    for (int radius = 1; radius <= max_radius; ++radius) {
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                if (std::max(std::abs(dx), std::abs(dy)) != radius) continue;
+                game::Position pos(base.x + dx, base.y + dy);
+                if (isFree(pos)) {
+                    agent.position = pos;
+                    return;
+                }
+            }
+        }
+    }
+}
+
+std::unordered_map<std::string_view, std::string> GameCoordinator::teamIntel() const {
+    // For each team, the living enemy closest to its base ("ENEMY:x,y")
+    std::unordered_map<std::string_view, std::string> intel;
+    for (const game::Base& base : state.bases) {
+        int best_distance = -1;
+        for (const game::Agent& enemy : state.agents) {
+            if (!enemy.is_alive || enemy.team == base.team) continue;
+            int distance = std::abs(enemy.position.x - base.position.x) + std::abs(enemy.position.y - base.position.y);
+            if (best_distance < 0 || distance < best_distance) {
+                best_distance = distance;
+                intel[base.team] = "ENEMY:" + std::to_string(enemy.position.x) + "," + std::to_string(enemy.position.y);
+            }
+        }
+    }
+    return intel;
+}
+
+TurnSample GameCoordinator::playTurn() {
+    TurnSample sample{};
+    state.current_turn++;
+    sample.turn = state.current_turn;
+
+    // The state is serialized once per encoding and shared by every request of
+    // the turn. binary_delta agents get the changes since the previous turn, or
+    // a snapshot right after registration, after a resync or when no delta can
+    // be built.
+    std::string state_delta;
+    bool delta_ready = has_last_sent && rpc::encodeGameStateDelta(last_sent, state, state_delta);
+    bool need_json = false;
+    bool need_binary = false;
+    for (AgentSlot& slot : agents) {
+        if (slot.encoding == Encoding::binary_delta && !delta_ready) slot.needs_snapshot = true;
+        if (slot.encoding == Encoding::json) need_json = true;
+        if (slot.encoding == Encoding::binary) need_binary = true;
+        if (slot.encoding == Encoding::binary_delta && slot.needs_snapshot) need_binary = true;
+    }
+    std::string state_json;
+    std::string state_binary;
+    if (need_json) rpc::serializeGameState(state, state_json);
+    if (need_binary) rpc::encodeGameState(state, state_binary);
+    turn_actions.assign(state.agents.size(), game::Action());
+    turn_timeouts = 0;
+    expired_turns_previous.swap(expired_turns); // Late answers are matched for two turns
+    expired_turns.clear();
+
+    // Fan-out: every live agent gets its request before any answer is read.
+    // Intel is pipelined in the same write, without waiting for its ack.
+    static metrics::Histogram& intel_round_trip = metrics::rpcRoundTrip("receive_intel");
+    static metrics::Histogram& turn_round_trip = metrics::rpcRoundTrip("play_turn");
+    Clock::time_point start = Clock::now();
+    std::unordered_map<std::string_view, std::string> intel;
+    if (config.send_intel) intel = teamIntel();
+    for (size_t i = 0; i < agents.size(); ++i) {
+        if (!state.agents[i].is_alive || !agents[i].connected) continue;
+        auto team_intel = intel.find(state.agents[i].team);
+        if (team_intel != intel.end()) {
+            std::string intel_id = nextCallId();
+            intel_calls.insert(intel_id);
+            intel_sent++;
+            sendRequest(i, intel_id, rpc::receive_intel_request(intel_id, team_intel->second), intel_round_trip, false,
+                        false);
+        }
+        std::string call_id = nextCallId();
+        std::string request;
+        if (agents[i].encoding == Encoding::json) {
+            request = rpc::play_turn_request(call_id, agents[i].agent_id, state_json);
+        } else if (agents[i].encoding == Encoding::binary || agents[i].needs_snapshot) {
+            request = rpc::binary_play_turn_request(call_id, agents[i].agent_id, state_binary);
+            agents[i].needs_snapshot = false;
+        } else {
+            request = rpc::binary_play_turn_delta_request(call_id, agents[i].agent_id, state_delta);
+        }
+        sendRequest(i, call_id, request, turn_round_trip, true);
+        sample.agents++;
+    }
+    last_sent = state;
+    has_last_sent = true;
+    waitForCalls(true);
+    Clock::time_point answered = Clock::now();
+    if (recorder.isOpen()) recorder.recordTurn(state, turn_actions); // Before the actions change it
+    sample.dispatch_ms = millisecondsBetween(start, answered);
+    sample.timeouts = turn_timeouts;
+
+    std::vector<bool> alive_before(state.agents.size());
+    for (size_t i = 0; i < state.agents.size(); ++i) alive_before[i] = state.agents[i].is_alive;
+
+    if (resolve_pool.size() > 0) {
+        game::resolveTurn(state, turn_actions, resolve_pool);
+    } else {
+        game::resolveTurn(state, turn_actions);
+    }
+    game::checkGameOver(state);
+    sample.resolve_ms = millisecondsBetween(answered, Clock::now());
+
+    notifyDeaths(alive_before);
+    return sample;
+}
+
+void GameCoordinator::notifyDeaths(const std::vector<bool>& alive_before) {
+    static metrics::Histogram& round_trip = metrics::rpcRoundTrip("notify_death");
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        if (alive_before[i] && !state.agents[i].is_alive) {
+            std::string call_id = nextCallId();
+            sendRequest(i, call_id, rpc::notify_death_request(call_id), round_trip, false);
+        }
+    }
+}
+
+void GameCoordinator::finishGame() {
+    if (!game::checkGameOver(state)) { // Everybody left before the end
+        state.game_over = true;
+    }
+    if (config.verbose) {
+        std::cout << "Game over, winner: " << (state.winner.empty() ? "draw" : state.winner) << std::endl;
+    }
+
+    // Unanswered notifications from earlier turns no longer matter
+    pending.clear();
+    deadlines.clear();
+    intel_calls.clear();
+    turn_outstanding = 0;
+
+    int winning_team = winningTeamIndex();
+    metrics::Histogram& round_trip = metrics::rpcRoundTrip("notify_game_over");
+    for (size_t i = 0; i < agents.size(); ++i) {
+        std::string call_id = nextCallId();
+        sendRequest(i, call_id, rpc::notify_game_over_request(call_id, winning_team), round_trip, false);
+    }
+    waitForCalls(false); // Acks, disconnections or deadlines
+}
+
+int GameCoordinator::winningTeamIndex() const {
+    for (size_t i = 0; i < teams.size(); ++i) {
+        if (std::string_view(teams[i]) == state.winner) return static_cast<int>(i);
+    }
+    return -1; // Draw
+}
+
+} // namespace coordinator
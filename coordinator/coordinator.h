@@ -0,0 +1,133 @@
+// coordinator/coordinator.h
+// Declares the game coordinator: registration, turn loop and game over over one EventLoop
+#pragma once
+#include "common/event_loop.h"
+#include "common/game_rules.h"
+#include "common/game_state.h"
+#include "common/metrics.h"
+#include "common/replay_log.h"
+#include "common/thread_pool.h"
+#include <chrono>
+#include <deque>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace coordinator {
+
+struct CoordinatorConfig {
+    int port = 8080;
+    size_t expected_agents = 2;                                 // Registrations needed to start
+    std::chrono::milliseconds registration_timeout{30000};      // Start with whoever registered
+    std::chrono::milliseconds request_timeout{5000};            // Per request, see RPC_PROTOCOL.md
+    game::GameConfig game;
+    bool send_intel = true;                                     // receive_intel pipelined ahead of play_turn
+    size_t resolve_threads = 1;                                 // >1: tiled parallel resolveTurn
+    std::string replay_path;                                    // Non-empty: record the match there
+    bool verbose = true;
+};
+
+// Timing of one turn, from the first play_turn sent to the actions applied
+struct TurnSample {
+    int turn;
+    size_t agents;      // play_turn requests sent
+    size_t timeouts;    // Requests that missed their deadline
+    double dispatch_ms; // Fan-out until every answer arrived or expired
+    double resolve_ms;  // Action application
+};
+
+struct MatchReport {
+    std::vector<TurnSample> turns;
+    size_t registered_agents = 0;
+    std::string winner;
+    size_t intel_sent = 0;
+    size_t intel_acked = 0; // receive_intel answered before its deadline
+
+    void print(std::ostream& out) const; // Summary of turn wall time against agent count
+};
+
+class GameCoordinator {
+private:
+    using ConnectionId = net::EventLoop::ConnectionId;
+    using Clock = std::chrono::steady_clock;
+
+    // play_turn encoding, negotiated at register_agent
+    enum class Encoding { json, binary, binary_delta };
+
+    struct AgentSlot {
+        std::string agent_id;
+        ConnectionId connection;
+        bool connected;
+        Encoding encoding;
+        bool needs_snapshot; // binary_delta: next play_turn carries the full state
+    };
+
+    // An outstanding request, matched to its answer by call id
+    struct PendingCall {
+        size_t agent;       // Index into agents / state.agents
+        bool is_turn;       // play_turn (expects an action) or a notification
+        Clock::time_point sent;
+        Clock::time_point deadline;
+        metrics::Histogram* round_trip; // rpc_round_trip_ns of the request's type
+    };
+
+    CoordinatorConfig config;
+    net::TcpServer server;
+    net::EventLoop loop;
+    concurrency::ThreadPool resolve_pool; // The loop thread works too: resolve_threads - 1 workers
+    replay::ReplayWriter recorder;        // Open while a match with replay_path plays
+
+    game::GameState state;
+    std::vector<AgentSlot> agents;                      // Parallel to state.agents
+    std::unordered_map<std::string, size_t> agent_index;
+    std::unordered_map<ConnectionId, std::vector<size_t>> connection_agents; // Several agents may share one
+    std::vector<std::string> teams;                     // winning_team is the index in here
+    game::GameState last_sent;                          // State of the previous play_turn, base of the deltas
+    bool has_last_sent;
+
+    std::unordered_map<std::string, PendingCall> pending;
+    std::deque<std::pair<Clock::time_point, std::string>> deadlines; // Send order == deadline order
+    std::unordered_set<std::string> intel_calls;        // Outstanding receive_intel ids
+    std::unordered_map<std::string, size_t> expired_turns;          // Expired play_turn id -> agent, this turn
+    std::unordered_map<std::string, size_t> expired_turns_previous; // and the previous one, for late resyncs
+    size_t intel_sent;
+    size_t intel_acked;
+    std::vector<game::Action> turn_actions;
+    size_t turn_outstanding;
+    size_t turn_timeouts;
+    uint64_t next_call_id;
+    bool registration_open;
+
+public:
+    explicit GameCoordinator(const CoordinatorConfig& config);
+
+    bool start();      // Listen for agents
+    MatchReport run(); // Registration, turns until game over, notifications
+
+    const game::GameState& getState() const { return state; }
+
+private:
+    void handleMessage(ConnectionId connection, std::string_view frame);
+    void handleClose(ConnectionId connection);
+    void registerAgent(ConnectionId connection, std::string_view frame);
+
+    std::string nextCallId();
+    bool sendRequest(size_t agent, const std::string& call_id, const std::string& message,
+                     metrics::Histogram& round_trip, bool is_turn, bool flush = true);
+    void completeCall(const std::string& call_id, std::string_view frame);
+    void lateAnswer(const std::string& call_id, std::string_view frame);
+    void dropCall(std::unordered_map<std::string, PendingCall>::iterator call);
+    void expireCalls(Clock::time_point now);
+    void waitForCalls(bool turn_only);
+
+    void spawnAgent(game::Agent& agent, std::string_view team);
+    std::unordered_map<std::string_view, std::string> teamIntel() const; // Keys view the bases' teams
+    TurnSample playTurn();
+    void notifyDeaths(const std::vector<bool>& alive_before);
+    void finishGame();
+    int winningTeamIndex() const;
+};
+
+} // namespace coordinator
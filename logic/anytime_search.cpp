@@ -0,0 +1,382 @@
+#include "anytime_search.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace agent {
+
+namespace {
+
+constexpr game::Direction DIRECTIONS[] = {
+    game::Direction::NORTH, game::Direction::SOUTH,
+    game::Direction::EAST, game::Direction::WEST
+};
+
+constexpr int WINDOW = 2 * AnytimeSearch::RADIUS + 1;
+
+// Pesos de la evaluación
+constexpr double HP_WEIGHT = 2.0;        // Vida propia y enemiga valen lo mismo: un intercambio parejo es neutro
+constexpr double ALLY_HP_WEIGHT = 2.0;   // Los aliados de la ventana pelean junto al propio
+constexpr double ENEMY_ALIVE = 40.0;     // Un enemigo menos es un atacante menos
+constexpr double SELF_DEAD = 100.0;      // Más y se retira de peleas que gana
+constexpr double BASE_HP_WEIGHT = 1.0;
+constexpr double BASE_DESTROYED = 100000.0; // Termina la partida
+constexpr double STEP_WEIGHT = 1.0;      // Por paso hacia el objetivo; más pesado, avanza sin mirar la vida
+
+bool sameAction(const game::Action& a, const game::Action& b) {
+    if (a.type != b.type) return false;
+    return a.type == game::ActionType::defend || a.type == game::ActionType::none || a.direction == b.direction;
+}
+
+game::Direction directionTowards(int dx, int dy) { // Mismo criterio que SimpleAgent::createAttackAction
+    if (std::abs(dx) > std::abs(dy)) return dx > 0 ? game::Direction::EAST : game::Direction::WEST;
+    return dy > 0 ? game::Direction::SOUTH : game::Direction::NORTH;
+}
+
+} // namespace
+
+SearchResult AnytimeSearch::search(const game::GameState& state, const game::SpatialGrid& turn_grid, size_t self_index,
+                                   const game::Action& heuristic, const DistanceField* goal_field,
+                                   SearchClock::time_point search_deadline, int max_depth) {
+    SearchResult result;
+    result.action = heuristic;
+    grid = &turn_grid;
+    goal = goal_field;
+    width = state.config.map_width;
+    height = state.config.map_height;
+    deadline = search_deadline;
+    nodes = 0;
+    aborted = SearchClock::now() >= deadline;
+    if (aborted || self_index >= state.agents.size() || !state.agents[self_index].is_alive) {
+        result.timed_out = aborted;
+        return result;
+    }
+
+    Local root;
+    buildLocal(state, self_index, root);
+
+    // La heurística va primera: las demás tienen que superarla
+    std::array<game::Action, 9> moves;
+    size_t count = candidates(root, moves);
+    auto it = std::find_if(moves.begin(), moves.begin() + count,
+                           [&](const game::Action& a) { return sameAction(a, heuristic); });
+    if (it == moves.begin() + count) {
+        if (count == moves.size()) --count;
+        it = moves.begin() + count++;
+        *it = heuristic;
+    }
+    std::rotate(moves.begin(), it, it + 1);
+
+    for (int depth = 1; depth <= std::min(max_depth, MAX_DEPTH); ++depth) {
+        size_t best = 0;
+        double best_value = -std::numeric_limits<double>::infinity();
+        for (size_t i = 0; i < count && !aborted; ++i) {
+            Local next = root;
+            step(next, moves[i]);
+            ++nodes;
+            double v = value(next, depth - 1);
+            if (!aborted && v > best_value) {
+                best_value = v;
+                best = i;
+            }
+        }
+        if (aborted) break; // Profundidad incompleta: vale la anterior
+
+        result.action = moves[best];
+        result.depth = depth;
+        result.score = best_value;
+        std::rotate(moves.begin(), moves.begin() + best, moves.begin() + best + 1); // Primero en la siguiente
+    }
+    result.nodes = nodes;
+    result.timed_out = aborted;
+    grid = nullptr;
+    goal = nullptr;
+    return result;
+}
+
+void AnytimeSearch::buildLocal(const game::GameState& state, size_t self_index, Local& local) {
+    origin = state.agents[self_index].position;
+    std::string_view team = state.agents[self_index].team;
+    static_blocked.fill(false);
+
+    // Agentes de la ventana, del más cercano al más lejano; el propio primero
+    std::vector<std::pair<int, int>> found; // (distancia, índice)
+    found.reserve(WINDOW * WINDOW);
+    for (int dy = -RADIUS; dy <= RADIUS; ++dy) {
+        for (int dx = -RADIUS; dx <= RADIUS; ++dx) {
+            game::Position pos(origin.x + dx, origin.y + dy);
+            if (!inside(pos.x, pos.y)) continue;
+            int index = grid->agentAt(pos);
+            if (index < 0) continue;
+            int distance = index == static_cast<int>(self_index) ? -1 : std::abs(dx) + std::abs(dy);
+            found.emplace_back(distance, index);
+        }
+    }
+    if (found.size() > MAX_UNITS) {
+        std::nth_element(found.begin(), found.begin() + MAX_UNITS, found.end());
+        for (auto f = found.begin() + MAX_UNITS; f != found.end(); ++f) {
+            const game::Position& pos = state.agents[f->second].position;
+            static_blocked[(pos.y - origin.y + RADIUS) * WINDOW + (pos.x - origin.x + RADIUS)] = true;
+        }
+        found.resize(MAX_UNITS);
+    }
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a.second < b.second; });
+
+    local.unit_count = 0;
+    for (const auto& [distance, index] : found) {
+        const game::Agent& agent = state.agents[index];
+        if (index == static_cast<int>(self_index)) local.self = local.unit_count;
+        local.units[local.unit_count++] = Unit{static_cast<int16_t>(agent.position.x),
+                                               static_cast<int16_t>(agent.position.y),
+                                               static_cast<int16_t>(agent.hp), static_cast<int16_t>(agent.max_hp),
+                                               agent.team == team, true};
+    }
+    local.base_count = 0;
+    for (const game::Base& base : state.bases) {
+        if (local.base_count == MAX_BASES) break;
+        local.bases[local.base_count++] = BaseUnit{static_cast<int16_t>(base.position.x),
+                                                   static_cast<int16_t>(base.position.y),
+                                                   static_cast<int16_t>(base.hp), base.team == team,
+                                                   base.is_destroyed};
+    }
+}
+
+double AnytimeSearch::value(const Local& local, int depth) {
+    if (expired()) return 0;
+    const Unit& me = local.units[local.self];
+    if (depth == 0 || !me.alive) return evaluate(local);
+    for (size_t b = 0; b < local.base_count; ++b) {
+        if (local.bases[b].destroyed) return evaluate(local); // Fin de la partida
+    }
+
+    std::array<game::Action, 9> moves;
+    size_t count = candidates(local, moves);
+    double best = -std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        Local next = local;
+        step(next, moves[i]);
+        ++nodes;
+        double v = value(next, depth - 1);
+        if (aborted) return 0;
+        best = std::max(best, v);
+    }
+    return best;
+}
+
+size_t AnytimeSearch::candidates(const Local& local, std::array<game::Action, 9>& out) const {
+    const Unit& me = local.units[local.self];
+    size_t count = 0;
+    for (game::Direction dir : DIRECTIONS) {
+        game::Position offset = game::getDirectionOffset(dir);
+        int x = me.x + offset.x;
+        int y = me.y + offset.y;
+        if (!inside(x, y)) continue;
+        out[count++] = game::Action(game::ActionType::move, dir);
+        // Atacar una celda vacía es defender sin la defensa: solo si hay blanco
+        int unit = unitAt(local, x, y);
+        int base = baseAt(local, x, y);
+        if ((unit >= 0 && local.units[unit].own != me.own) || (base >= 0 && local.bases[base].own != me.own)) {
+            out[count++] = game::Action(game::ActionType::attack, dir);
+        }
+    }
+    out[count++] = game::Action(game::ActionType::defend);
+    return count;
+}
+
+game::Action AnytimeSearch::policy(const Local& local, size_t unit) const {
+    const Unit& me = local.units[unit];
+    if (!me.alive) return game::Action();
+
+    // Enemigo al lado (el de menor índice): atacarlo
+    int nearest = -1;
+    int64_t nearest_distance = std::numeric_limits<int64_t>::max();
+    for (size_t v = 0; v < local.unit_count; ++v) {
+        const Unit& other = local.units[v];
+        if (!other.alive || other.own == me.own) continue;
+        int dx = other.x - me.x;
+        int dy = other.y - me.y;
+        if (std::abs(dx) + std::abs(dy) == 1) return game::Action(game::ActionType::attack, directionTowards(dx, dy));
+        int64_t distance = static_cast<int64_t>(dx) * dx + static_cast<int64_t>(dy) * dy;
+        if (distance < nearest_distance) {
+            nearest_distance = distance;
+            nearest = static_cast<int>(v);
+        }
+    }
+    if (me.hp < LOW_HEALTH) return game::Action(game::ActionType::defend);
+    if (nearest < 0) return game::Action(); // Nada que perseguir dentro de la ventana
+
+    // Acercarse por el eje más largo; si está ocupado, por el otro
+    int dx = local.units[nearest].x - me.x;
+    int dy = local.units[nearest].y - me.y;
+    game::Direction first = directionTowards(dx, dy);
+    game::Direction second = std::abs(dx) > std::abs(dy) ? (dy > 0 ? game::Direction::SOUTH : game::Direction::NORTH)
+                                                         : (dx > 0 ? game::Direction::EAST : game::Direction::WEST);
+    bool has_second = std::abs(dx) > std::abs(dy) ? dy != 0 : dx != 0;
+    for (int option = 0; option < (has_second ? 2 : 1); ++option) {
+        game::Direction dir = option == 0 ? first : second;
+        game::Position offset = game::getDirectionOffset(dir);
+        int x = me.x + offset.x;
+        int y = me.y + offset.y;
+        if (inside(x, y) && unitAt(local, x, y) < 0 && !blockedOutside(x, y)) {
+            return game::Action(game::ActionType::move, dir);
+        }
+    }
+    return game::Action(game::ActionType::defend);
+}
+
+void AnytimeSearch::step(Local& local, const game::Action& own) const {
+    std::array<game::Action, MAX_UNITS> actions;
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        actions[u] = u == local.self ? own : policy(local, u);
+    }
+
+    // Ataques, todos con el tablero del comienzo del turno
+    std::array<int16_t, MAX_UNITS> damage{};
+    std::array<int16_t, MAX_BASES> base_damage{};
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        const Unit& attacker = local.units[u];
+        if (!attacker.alive || actions[u].type != game::ActionType::attack) continue;
+        game::Position offset = game::getDirectionOffset(actions[u].direction);
+        int x = attacker.x + offset.x;
+        int y = attacker.y + offset.y;
+        if (!inside(x, y)) continue;
+        int victim = unitAt(local, x, y);
+        if (victim >= 0 && local.units[victim].own != attacker.own) {
+            bool defending = actions[victim].type == game::ActionType::defend;
+            damage[victim] += defending ? game::ATTACK_DAMAGE / 2 : game::ATTACK_DAMAGE;
+            continue;
+        }
+        int base = baseAt(local, x, y);
+        if (base >= 0 && local.bases[base].own != attacker.own) base_damage[base] += game::ATTACK_DAMAGE;
+    }
+
+    // Muertes
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        Unit& unit = local.units[u];
+        if (!unit.alive || damage[u] == 0) continue;
+        unit.hp = static_cast<int16_t>(std::max(0, unit.hp - damage[u]));
+        unit.alive = unit.hp > 0;
+    }
+    for (size_t b = 0; b < local.base_count; ++b) {
+        BaseUnit& base = local.bases[b];
+        if (base.destroyed || base_damage[b] == 0) continue;
+        base.hp = static_cast<int16_t>(std::max(0, base.hp - base_damage[b]));
+        base.destroyed = base.hp == 0;
+    }
+
+    // Movimientos: una celda libre es del menor índice que la pide
+    std::array<int16_t, MAX_UNITS> target_x;
+    std::array<int16_t, MAX_UNITS> target_y;
+    std::array<bool, MAX_UNITS> moves{};
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        const Unit& unit = local.units[u];
+        if (!unit.alive || actions[u].type != game::ActionType::move) continue;
+        game::Position offset = game::getDirectionOffset(actions[u].direction);
+        int x = unit.x + offset.x;
+        int y = unit.y + offset.y;
+        if (!inside(x, y) || unitAt(local, x, y) >= 0 || blockedOutside(x, y)) continue;
+        bool claimed = false;
+        for (size_t v = 0; v < u && !claimed; ++v) {
+            claimed = moves[v] && target_x[v] == x && target_y[v] == y;
+        }
+        if (claimed) continue;
+        moves[u] = true;
+        target_x[u] = static_cast<int16_t>(x);
+        target_y[u] = static_cast<int16_t>(y);
+    }
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        if (!moves[u]) continue;
+        local.units[u].x = target_x[u];
+        local.units[u].y = target_y[u];
+    }
+
+    // Curación junto a la base propia
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        Unit& unit = local.units[u];
+        if (!unit.alive) continue;
+        for (size_t b = 0; b < local.base_count; ++b) {
+            const BaseUnit& base = local.bases[b];
+            if (base.destroyed || base.own != unit.own) continue;
+            if (std::abs(base.x - unit.x) <= 1 && std::abs(base.y - unit.y) <= 1) {
+                unit.hp = static_cast<int16_t>(std::min<int>(unit.max_hp, unit.hp + game::BASE_HEAL));
+            }
+        }
+    }
+}
+
+double AnytimeSearch::evaluate(const Local& local) const {
+    const Unit& me = local.units[local.self];
+    double score = 0;
+    int nearest_enemy = std::numeric_limits<int>::max();
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        const Unit& unit = local.units[u];
+        if (unit.own) {
+            score += unit.hp * (u == local.self ? HP_WEIGHT : ALLY_HP_WEIGHT);
+            continue;
+        }
+        score -= unit.hp * HP_WEIGHT + (unit.alive ? ENEMY_ALIVE : 0);
+        if (unit.alive) nearest_enemy = std::min(nearest_enemy, std::abs(unit.x - me.x) + std::abs(unit.y - me.y));
+    }
+    if (!me.alive) return score - SELF_DEAD;
+
+    int nearest_own_base = std::numeric_limits<int>::max();
+    int nearest_enemy_base = std::numeric_limits<int>::max();
+    for (size_t b = 0; b < local.base_count; ++b) {
+        const BaseUnit& base = local.bases[b];
+        int distance = std::abs(base.x - me.x) + std::abs(base.y - me.y);
+        if (base.own) {
+            score += base.hp * BASE_HP_WEIGHT;
+            if (!base.destroyed) nearest_own_base = std::min(nearest_own_base, distance);
+        } else {
+            score -= base.hp * BASE_HP_WEIGHT;
+            if (base.destroyed) score += BASE_DESTROYED;
+            else nearest_enemy_base = std::min(nearest_enemy_base, distance);
+        }
+    }
+
+    // Posición: con poca vida, hacia la base propia; si no, hacia el enemigo más
+    // cercano o, sin enemigos en la ventana, hacia la base enemiga
+    int steps = 0;
+    if (me.hp < LOW_HEALTH && nearest_own_base != std::numeric_limits<int>::max()) {
+        steps = nearest_own_base;
+    } else if (nearest_enemy != std::numeric_limits<int>::max()) {
+        steps = nearest_enemy;
+    } else if (goal != nullptr && goal->distanceFrom(game::Position(me.x, me.y)) != DistanceField::UNREACHABLE) {
+        steps = goal->distanceFrom(game::Position(me.x, me.y));
+    } else if (nearest_enemy_base != std::numeric_limits<int>::max()) {
+        steps = nearest_enemy_base;
+    }
+    return score - steps * STEP_WEIGHT;
+}
+
+bool AnytimeSearch::blockedOutside(int x, int y) const {
+    int wx = x - origin.x + RADIUS;
+    int wy = y - origin.y + RADIUS;
+    if (wx >= 0 && wy >= 0 && wx < WINDOW && wy < WINDOW) return static_blocked[wy * WINDOW + wx];
+    return grid->occupied(game::Position(x, y));
+}
+
+int AnytimeSearch::unitAt(const Local& local, int x, int y) const {
+    for (size_t u = 0; u < local.unit_count; ++u) {
+        const Unit& unit = local.units[u];
+        if (unit.alive && unit.x == x && unit.y == y) return static_cast<int>(u);
+    }
+    return -1;
+}
+
+int AnytimeSearch::baseAt(const Local& local, int x, int y) const {
+    for (size_t b = 0; b < local.base_count; ++b) {
+        const BaseUnit& base = local.bases[b];
+        if (!base.destroyed && base.x == x && base.y == y) return static_cast<int>(b);
+    }
+    return -1;
+}
+
+bool AnytimeSearch::expired() {
+    if (!aborted && nodes % CLOCK_STRIDE == 0 && SearchClock::now() >= deadline) aborted = true;
+    return aborted;
+}
+
+} // namespace agent
@@ -0,0 +1,101 @@
+#pragma once
+#include "common/game_rules.h"
+#include "common/game_state.h"
+#include "common/spatial_grid.h"
+#include "pathfinding.h"
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+
+namespace agent {
+
+using SearchClock = std::chrono::steady_clock;
+
+// Resultado de una búsqueda
+struct SearchResult {
+    game::Action action;     // Mejor primera acción de la última profundidad completa
+    int depth = 0;           // Profundidad completa alcanzada; 0 = quedó la acción heurística
+    uint64_t nodes = 0;      // Turnos simulados
+    double score = 0;        // Evaluación de action a esa profundidad
+    bool timed_out = false;  // La última iteración se cortó por el deadline
+};
+
+// Búsqueda "anytime" de la propia acción. Profundiza de a un turno
+// (iterative deepening) sobre move/attack/defend y, al terminar cada
+// profundidad, se queda con la mejor primera acción. Se corta en cuanto pasa
+// el deadline y devuelve lo de la última profundidad completa, así que la
+// respuesta siempre llega a tiempo: como mínimo es la acción heurística,
+// que se evalúa primero y solo se reemplaza por otra estrictamente mejor.
+//
+// El modelo es local: los agentes vivos en una ventana de RADIUS celdas
+// alrededor del propio, con las mismas reglas que game::resolveTurn (ataques
+// simultáneos con las posiciones del comienzo del turno, defensa a mitad de
+// daño, movimientos al menor índice, curación junto a la base). Los demás
+// agentes juegan una política codiciosa fija (atacar si hay un enemigo al
+// lado, defender con poca vida, acercarse al enemigo más cercano); solo la
+// acción propia se ramifica. Lo que está fuera de la ventana queda quieto.
+class AnytimeSearch {
+public:
+    static constexpr int RADIUS = 5;          // Ventana de (2 * RADIUS + 1)^2 celdas
+    static constexpr size_t MAX_UNITS = 24;   // Agentes simulados, los más cercanos; el resto son obstáculos
+    static constexpr size_t MAX_BASES = 4;
+    static constexpr int MAX_DEPTH = 32;
+    static constexpr uint64_t CLOCK_STRIDE = 64; // Nodos entre consultas al reloj
+    static constexpr int LOW_HEALTH = 30;
+
+private:
+    struct Unit {
+        int16_t x, y;
+        int16_t hp, max_hp;
+        bool own;   // Del equipo propio
+        bool alive;
+    };
+    struct BaseUnit {
+        int16_t x, y;
+        int16_t hp;
+        bool own;
+        bool destroyed;
+    };
+    struct Local {
+        std::array<Unit, MAX_UNITS> units; // En el orden de state.agents, que decide los empates al moverse
+        std::array<BaseUnit, MAX_BASES> bases;
+        uint8_t unit_count = 0;
+        uint8_t base_count = 0;
+        uint8_t self = 0;
+    };
+
+    // Contexto de la búsqueda en curso
+    const game::SpatialGrid* grid = nullptr;
+    const DistanceField* goal = nullptr; // Hacia la base enemiga, para cuando no hay enemigos cerca
+    int width = 0;
+    int height = 0;
+    game::Position origin;               // Centro de la ventana
+    std::array<bool, (2 * RADIUS + 1) * (2 * RADIUS + 1)> static_blocked{}; // Agentes de la ventana no simulados
+    SearchClock::time_point deadline;
+    uint64_t nodes = 0;
+    bool aborted = false;
+
+public:
+    // self_index es el propio en state.agents (vivo). heuristic es la acción
+    // que ya eligió la lógica simple: se devuelve si no aparece nada mejor.
+    SearchResult search(const game::GameState& state, const game::SpatialGrid& grid, size_t self_index,
+                        const game::Action& heuristic, const DistanceField* goal,
+                        SearchClock::time_point deadline, int max_depth = MAX_DEPTH);
+
+private:
+    void buildLocal(const game::GameState& state, size_t self_index, Local& local);
+    double value(const Local& local, int depth);           // Mejor evaluación alcanzable en depth turnos
+    void step(Local& local, const game::Action& own) const; // Un turno: own para el propio, política para el resto
+    game::Action policy(const Local& local, size_t unit) const;
+    double evaluate(const Local& local) const;
+    size_t candidates(const Local& local, std::array<game::Action, 9>& out) const;
+
+    bool inside(int x, int y) const { return x >= 0 && y >= 0 && x < width && y < height; }
+    bool blockedOutside(int x, int y) const; // Ocupación que no simula el modelo
+    int unitAt(const Local& local, int x, int y) const;
+    int baseAt(const Local& local, int x, int y) const;
+    bool expired();
+};
+
+} // namespace agent
@@ -0,0 +1,147 @@
+#include "influence_map.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace agent {
+
+namespace {
+
+// Restar y sumar el núcleo de una fuente escribe 2 * (2R+1)^2 celdas en la
+// capa y en el total; filtrar de nuevo cuesta unas 2 * (2R+1) + 2 por celda y
+// capa. Con más cambios que cells * capas / SPLAT_COST conviene filtrar.
+constexpr size_t SPLAT_COST = 12;
+
+} // namespace
+
+void InfluenceMap::reset(int new_width, int new_height) {
+    width = std::max(0, new_width);
+    height = std::max(0, new_height);
+    turn = -1;
+    teams.clear();
+    layers.clear();
+    total.assign(static_cast<size_t>(width) * height, 0);
+    sources.clear();
+}
+
+void InfluenceMap::update(const game::GameState& state) {
+    if (state.config.map_width != width || state.config.map_height != height) {
+        reset(state.config.map_width, state.config.map_height);
+    } else if (state.current_turn == turn) {
+        return; // Ya aplicado por otro agente de este proceso
+    }
+    turn = state.current_turn;
+
+    next_sources.resize(state.agents.size());
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        const game::Agent& agent = state.agents[i];
+        if (!agent.is_alive || !inside(agent.position)) {
+            next_sources[i] = DEAD;
+            continue;
+        }
+        const Source& previous = i < sources.size() ? sources[i] : DEAD;
+        next_sources[i] = Source{agent.position.y * width + agent.position.x, teamOf(agent, previous)};
+    }
+
+    // Los agentes no cambian de orden entre turnos: el diff es por índice
+    const bool same_agents = next_sources.size() == sources.size() && !sources.empty();
+    size_t changed_now = next_sources.size();
+    if (same_agents) {
+        changed_now = 0;
+        for (size_t i = 0; i < sources.size(); ++i) changed_now += !(next_sources[i] == sources[i]);
+        if (changed_now == 0) return;
+    }
+    changed = changed_now;
+    rebuilt = !same_agents || changed * SPLAT_COST >= total.size() * layers.size();
+    if (!rebuilt) {
+        for (size_t i = 0; i < sources.size(); ++i) {
+            if (next_sources[i] == sources[i]) continue;
+            splat(sources[i], -1);
+            splat(next_sources[i], 1);
+        }
+    }
+    sources.swap(next_sources);
+    if (rebuilt) rebuild();
+}
+
+uint16_t InfluenceMap::teamOf(const game::Agent& agent, const Source& previous) {
+    const std::string_view name = agent.team;
+    // Casi siempre el mismo equipo que en el update anterior
+    if (previous.team < teams.size() && teams[previous.team] == name) return previous.team;
+    for (size_t t = 0; t < teams.size(); ++t) {
+        if (teams[t] == name) return static_cast<uint16_t>(t);
+    }
+    teams.emplace_back(name);
+    layers.emplace_back(total.size(), 0); // Todavía sin fuentes: en cero es correcta
+    return static_cast<uint16_t>(teams.size() - 1);
+}
+
+void InfluenceMap::rebuild() {
+    const size_t cells = total.size();
+    std::fill(total.begin(), total.end(), 0);
+    for (size_t t = 0; t < layers.size(); ++t) {
+        counts.assign(cells, 0);
+        for (const Source& source : sources) {
+            if (source.cell >= 0 && source.team == t) counts[source.cell]++;
+        }
+
+        // Filas, después columnas
+        rows.assign(cells, 0);
+        for (int y = 0; y < height; ++y) {
+            const int32_t* in = counts.data() + static_cast<size_t>(y) * width;
+            int32_t* out = rows.data() + static_cast<size_t>(y) * width;
+            for (int x = 0; x < width; ++x) {
+                if (in[x] == 0) continue;
+                for (int dx = std::max(-RADIUS, -x); dx <= std::min(RADIUS, width - 1 - x); ++dx) {
+                    out[x + dx] += in[x] * WEIGHTS[std::abs(dx)];
+                }
+            }
+        }
+        std::vector<int32_t>& layer = layers[t];
+        std::fill(layer.begin(), layer.end(), 0);
+        for (int y = 0; y < height; ++y) {
+            const int32_t* in = rows.data() + static_cast<size_t>(y) * width;
+            for (int dy = std::max(-RADIUS, -y); dy <= std::min(RADIUS, height - 1 - y); ++dy) {
+                const int32_t weight = WEIGHTS[std::abs(dy)];
+                int32_t* out = layer.data() + static_cast<size_t>(y + dy) * width;
+                for (int x = 0; x < width; ++x) out[x] += in[x] * weight;
+            }
+        }
+        for (size_t c = 0; c < cells; ++c) total[c] += layer[c];
+    }
+}
+
+void InfluenceMap::splat(const Source& source, int32_t sign) {
+    if (source.cell < 0) return;
+    const int x = source.cell % width;
+    const int y = source.cell / width;
+    std::vector<int32_t>& layer = layers[source.team];
+    for (int dy = std::max(-RADIUS, -y); dy <= std::min(RADIUS, height - 1 - y); ++dy) {
+        const int32_t row_weight = sign * WEIGHTS[std::abs(dy)];
+        const size_t row = static_cast<size_t>(y + dy) * width;
+        for (int dx = std::max(-RADIUS, -x); dx <= std::min(RADIUS, width - 1 - x); ++dx) {
+            const int32_t value = row_weight * WEIGHTS[std::abs(dx)];
+            layer[row + x + dx] += value;
+            total[row + x + dx] += value;
+        }
+    }
+}
+
+int InfluenceMap::team(std::string_view name) const {
+    for (size_t t = 0; t < teams.size(); ++t) {
+        if (teams[t] == name) return static_cast<int>(t);
+    }
+    return -1;
+}
+
+int32_t InfluenceMap::support(int team, const game::Position& pos) const {
+    if (team < 0 || static_cast<size_t>(team) >= layers.size() || !inside(pos)) return 0;
+    return layers[team][static_cast<size_t>(pos.y) * width + pos.x];
+}
+
+int32_t InfluenceMap::threat(int team, const game::Position& pos) const {
+    if (!inside(pos)) return 0;
+    const size_t cell = static_cast<size_t>(pos.y) * width + pos.x;
+    return total[cell] - support(team, pos);
+}
+
+} // namespace agent
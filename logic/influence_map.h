@@ -0,0 +1,71 @@
+#pragma once
+#include "common/game_state.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace agent {
+
+// Influencia de cada equipo sobre el mapa, compartida por todos los agentes
+// de un proceso como la PathCache. Cada agente vivo suma a las celdas a menos
+// de RADIUS en cada eje WEIGHTS[|dx|] * WEIGHTS[|dy|]: el núcleo es separable,
+// así que una capa se calcula con una pasada por filas y otra por columnas.
+// La amenaza para un equipo es la influencia de los demás; el apoyo, la propia.
+//
+// update() compara las fuentes (celda y equipo de cada agente) con las del
+// update anterior. Si cambiaron pocas resta y suma sus núcleos; si no, vuelve
+// a filtrar. Los pesos son enteros, así que los dos caminos dan lo mismo.
+class InfluenceMap {
+public:
+    static constexpr int RADIUS = 3;
+    static constexpr int32_t WEIGHTS[RADIUS + 1] = {8, 4, 2, 1}; // Por distancia en cada eje
+    static constexpr int32_t UNIT = WEIGHTS[0] * WEIGHTS[0];     // Un agente en su propia celda
+
+private:
+    struct Source {
+        int32_t cell;  // -1: muerto o fuera del mapa
+        uint16_t team;
+        bool operator==(const Source& other) const { return cell == other.cell && team == other.team; }
+    };
+    static constexpr Source DEAD{-1, 0};
+
+    int width = 0;
+    int height = 0;
+    int turn = -1;
+    std::vector<std::string> teams;           // Capa de cada equipo, en orden de aparición
+    std::vector<std::vector<int32_t>> layers; // Influencia por celda, una capa por equipo
+    std::vector<int32_t> total;               // Suma de las capas: amenaza = total - propia
+    std::vector<Source> sources;              // Por agente, del último update
+    std::vector<Source> next_sources;
+    std::vector<int32_t> counts;              // Auxiliares del filtro, conservan su capacidad
+    std::vector<int32_t> rows;
+    size_t changed = 0;
+    bool rebuilt = false;
+
+public:
+    // Aplica el estado (una sola vez por turno). No es concurrente: con el
+    // mapa compartido lo llama solo el dueño (el host o el simulador), antes
+    // de repartir las decisiones; los agentes solo leen.
+    void update(const game::GameState& state);
+    int appliedTurn() const { return turn; } // current_turn del último update, -1 si no hubo
+
+    // Capa del equipo, -1 si no tiene agentes desde que se creó el mapa
+    int team(std::string_view name) const;
+
+    int32_t support(int team, const game::Position& pos) const;
+    int32_t threat(int team, const game::Position& pos) const;
+
+    // Del último update que cambió algo
+    size_t changedSources() const { return changed; }
+    bool wasRebuilt() const { return rebuilt; }
+
+private:
+    void reset(int new_width, int new_height);
+    uint16_t teamOf(const game::Agent& agent, const Source& previous);
+    void rebuild();
+    void splat(const Source& source, int32_t sign);
+    bool inside(const game::Position& pos) const { return pos.x >= 0 && pos.y >= 0 && pos.x < width && pos.y < height; }
+};
+
+} // namespace agent
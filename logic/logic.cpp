@@ -1,19 +1,116 @@
 #include "logic.h"
+#include "common/game_rules.h"
 #include "common/game_state.h"
+#include "common/metrics.h"
+#include "rollout_planner.h"
+#include <cassert>
+#include <cstdlib>
 
 
 namespace agent {
-    SimpleAgent::SimpleAgent() : health(100) {}
 
-void SimpleAgent::initialize(const std::string& id, const std::string& team_name) {
+namespace {
+
+SimpleAction fromGameAction(const game::Action& action) {
+    switch (action.type) {
+        case game::ActionType::move: return SimpleAction(SimpleActionType::move, action.direction);
+        case game::ActionType::attack: return SimpleAction(SimpleActionType::attack, action.direction);
+        case game::ActionType::defend:
+        case game::ActionType::none: break;
+    }
+    return SimpleAction(SimpleActionType::defend, action.direction);
+}
+
+} // namespace
+    SimpleAgent::SimpleAgent()
+    : health(100), path_cache(std::make_shared<PathCache>()), influence(std::make_shared<InfluenceMap>()) {}
+
+void SimpleAgent::setSearchBudget(std::chrono::microseconds budget, int max_depth) {
+    search_budget = std::clamp<std::chrono::microseconds>(budget, std::chrono::microseconds(0), MAX_SEARCH_BUDGET);
+    search_depth = std::clamp(max_depth, 1, AnytimeSearch::MAX_DEPTH);
+}
+
+void SimpleAgent::setRolloutBudget(int rollouts_per_action, concurrency::ThreadPool& pool, int horizon) {
+    if (rollouts_per_action <= 0) {
+        planner.reset();
+        return;
+    }
+    RolloutConfig config;
+    config.rollouts_per_action = rollouts_per_action;
+    config.horizon = horizon;
+    planner = std::make_shared<const RolloutPlanner>(pool, config);
+}
+
+void SimpleAgent::initialize(std::string_view id, std::string_view team_name) {
     agent_id = id;
     team = team_name;
 }
 
+std::string_view actionName(const SimpleAction& action) {
+    switch (action.type) {
+        case SimpleActionType::move: return game::actionName(game::ActionType::move, action.direction);
+        case SimpleActionType::attack: return game::actionName(game::ActionType::attack, action.direction);
+        case SimpleActionType::defend: return game::actionName(game::ActionType::defend, action.direction);
+        case SimpleActionType::send_message: break;
+    }
+    return {};
+}
+
+game::Action toGameAction(const SimpleAction& action) {
+    switch (action.type) {
+        case SimpleActionType::move: return game::Action(game::ActionType::move, action.direction);
+        case SimpleActionType::attack: return game::Action(game::ActionType::attack, action.direction);
+        case SimpleActionType::defend: return game::Action(game::ActionType::defend, action.direction);
+        case SimpleActionType::send_message: break;
+    }
+    return game::Action();
+}
+
+std::string actionToString(const SimpleAction& action) {
+    if (action.type == SimpleActionType::send_message) return "send_message:" + action.message;
+    return std::string(actionName(action));
+}
+
 SimpleAction SimpleAgent::processTurn(const game::GameState& game_state) {
+    game::SpatialGrid grid(game_state);
+    return processTurn(game_state, grid);
+}
+
+SimpleAction SimpleAgent::processTurn(const game::GameState& game_state, const game::SpatialGrid& grid) {
+    static metrics::Histogram& decision_time = metrics::Registry::global().histogram("agent_decision_ns");
+    metrics::ScopedTimer timer(decision_time);
+    SearchClock::time_point deadline = SearchClock::now() + search_budget; // El presupuesto incluye todo el turno
+    turn_grid = &grid;
+    path_cache->update(game_state);
     updateSelfState(game_state);
-    updateMemory(game_state);
-    return decideSimpleAction(game_state);
+    // El mapa de influencia solo hace falta para escapar con salud baja; el
+    // resto de las consultas usan la grilla. Compartido, ya llega actualizado.
+    if (shared_influence) {
+        assert(influence->appliedTurn() == game_state.current_turn && "update() del mapa compartido antes de decidir");
+    } else if (health < LOW_HEALTH) {
+        influence->update(game_state);
+    }
+    SimpleAction action = decideSimpleAction(game_state);
+    if (planner && action.type != SimpleActionType::send_message && self_index < game_state.agents.size() &&
+        game_state.agents[self_index].is_alive && game_state.agents[self_index].id == std::string_view(agent_id)) {
+        int enemy = grid.nearestEnemy(current_position, team);
+        if (enemy >= 0) {
+            const game::Position& pos = game_state.agents[enemy].position;
+            if (std::abs(pos.x - current_position.x) + std::abs(pos.y - current_position.y) <= ROLLOUT_RANGE) {
+                action = planner->plan(game_state, self_index);
+            }
+        }
+    }
+    if (search_budget.count() > 0 && action.type != SimpleActionType::send_message &&
+        self_index < game_state.agents.size() && game_state.agents[self_index].is_alive &&
+        game_state.agents[self_index].id == std::string_view(agent_id)) {
+        game::Position enemy_base = findEnemyBasePosition(game_state);
+        last_search = search.search(game_state, grid, self_index, toGameAction(action),
+                                    &path_cache->field(enemy_base), deadline, search_depth);
+        action = fromGameAction(last_search.action);
+    }
+    turn_grid = nullptr;
+    return action;
 }
 
 void SimpleAgent::receiveMessage(const std::string& message) {
@@ -30,26 +127,24 @@ void SimpleAgent::receiveMessage(const std::string& message) {
 // Implementación de métodos privados
 
 void SimpleAgent::updateSelfState(const game::GameState& game_state) {
-    for (const auto& agent : game_state.agents) {
-        if (agent.id == agent_id && agent.is_alive) {
+    // El orden de los agentes no cambia entre turnos: primero probar el índice anterior
+    if (self_index < game_state.agents.size() && game_state.agents[self_index].id == std::string_view(agent_id)) {
+        const auto& agent = game_state.agents[self_index];
+        if (agent.is_alive) {
             current_position = agent.position;
             health = agent.hp;
-            break;
         }
+        return;
     }
-}
-
-void SimpleAgent::updateMemory(const game::GameState& game_state) {
-    known_enemy_positions.clear();
-    known_ally_positions.clear();
-    
-    for (const auto& agent : game_state.agents) {
-        if (agent.is_alive) {
-            if (agent.team != team) {
-                known_enemy_positions.push_back(agent.position);
-            } else if (agent.id != agent_id) {
-                known_ally_positions.push_back(agent.position);
+    for (size_t i = 0; i < game_state.agents.size(); ++i) {
+        const auto& agent = game_state.agents[i];
+        if (agent.id == std::string_view(agent_id)) {
+            self_index = i;
+            if (agent.is_alive) {
+                current_position = agent.position;
+                health = agent.hp;
             }
+            break;
         }
     }
 }
@@ -67,46 +162,55 @@ SimpleAction SimpleAgent::decideSimpleAction(const game::GameState& game_state)
     }
     
     // 3. Si sabemos donde hay enemigos, MOVERSE hacia ellos
-    if (!known_enemy_positions.empty()) {
-        game::Position nearest_enemy = findNearestEnemy();
-        return moveTowards(nearest_enemy, game_state);
+    int nearest_enemy = turn_grid->nearestEnemy(current_position, team);
+    if (nearest_enemy >= 0) {
+        return moveTowards(turn_grid->agent(nearest_enemy).position, game_state);
     }
     
     // 4. Si no hay enemigos visibles, MOVERSE hacia base enemiga
     game::Position enemy_base = findEnemyBasePosition(game_state);
-    return moveTowards(enemy_base, game_state);
+    return moveTowards(enemy_base, game_state, &path_cache->field(enemy_base));
 }
 
 std::pair<bool, game::Position> SimpleAgent::findAdjacentEnemy() {
-    for (const auto& enemy_pos : known_enemy_positions) {
-        if (getDistance(current_position, enemy_pos) <= ATTACK_RANGE) {
-            return {true, enemy_pos};
-        }
+    // Solo las celdas a distancia ATTACK_RANGE; gana el de menor índice, como en el recorrido lineal
+    int first = turn_grid->firstEnemyInRadius(current_position, team, ATTACK_RANGE);
+    if (first < 0) {
+        return {false, game::Position()};
     }
-    return {false, game::Position()};
+    return {true, turn_grid->agent(first).position};
 }
 
 SimpleAction SimpleAgent::handleLowHealth(const game::GameState& game_state) {
     // Si hay enemigos cerca, defender
-    if (!known_enemy_positions.empty()) {
-        game::Position nearest_enemy = findNearestEnemy();
-        if (getDistance(current_position, nearest_enemy) <= 2) {
-            return SimpleAction(SimpleActionType::defend);
-        }
+    int nearest_enemy = turn_grid->nearestEnemy(current_position, team);
+    if (nearest_enemy >= 0 && getDistance2(current_position, turn_grid->agent(nearest_enemy).position) <= 4) {
+        return SimpleAction(SimpleActionType::defend);
     }
     
     // Si no, moverse hacia base propia para curarse
     game::Position own_base = findOwnBasePosition(game_state);
-    return moveTowards(own_base, game_state);
+    return moveTowards(own_base, game_state, &path_cache->field(own_base));
 }
-SimpleAction SimpleAgent::moveTowards(const game::Position& target, const game::GameState& game_state) {
-    int dx = target.x - current_position.x;
-    int dy = target.y - current_position.y;
+SimpleAction SimpleAgent::moveTowards(const game::Position& target, const game::GameState& game_state,
+                                      const DistanceField* field) {
+    // Objetivo móvil (enemigo) y sin apuro por escapar: primer paso de A*
+    if (field == nullptr && health >= LOW_HEALTH) {
+        game::Direction step;
+        if (path_cache->firstStepTowards(current_position, target, PATH_SEARCH_LIMIT, step)) {
+            return SimpleAction(SimpleActionType::move, step);
+        }
+    }
+
+    // Si no, el vecino que más acerca. Con campo de distancias se mide en pasos
+    // reales (rodeando agentes); las celdas sin camino quedan detrás de todas las demás.
+    const double unreachable_penalty = static_cast<double>(game_state.config.map_width) * game_state.config.map_height;
     
     game::Direction best_dir = game::Direction::NORTH;
     double best_score = -1000000; // Valor inicial muy bajo
+    const int own_layer = health < LOW_HEALTH ? influence->team(team) : -1;
     
-    std::vector<game::Direction> directions = {
+    static constexpr game::Direction directions[] = {
         game::Direction::NORTH, game::Direction::SOUTH,
         game::Direction::EAST, game::Direction::WEST
     };
@@ -132,14 +236,16 @@ SimpleAction SimpleAgent::moveTowards(const game::Position& target, const game::
         
         if (isValidPosition(new_pos, game_state)) {
             double new_dist = getDistance(new_pos, target);
+            if (field != nullptr) {
+                int32_t steps = field->distanceFrom(new_pos);
+                new_dist = steps != DistanceField::UNREACHABLE ? steps : new_dist + unreachable_penalty;
+            }
             double score = -new_dist; // Más negativo = mejor (más cerca)
             
-            // Evitar enemigos si la salud es baja
+            // Evitar enemigos si la salud es baja: una consulta por celda en vez
+            // de recorrer todos los enemigos
             if (health < LOW_HEALTH) {
-                for (const auto& enemy_pos : known_enemy_positions) {
-                    double enemy_dist = getDistance(new_pos, enemy_pos);
-                    score += enemy_dist * 2; // Premiar distancia de enemigos
-                }
+                score -= influence->threat(own_layer, new_pos) * THREAT_WEIGHT;
             }
             
             if (score > best_score) {
@@ -174,29 +280,19 @@ SimpleAction SimpleAgent::createAttackAction(const game::Position& enemy_pos) {
     return SimpleAction(SimpleActionType::attack, attack_dir);
 }
 
-game::Position SimpleAgent::findNearestEnemy() {
-    if (known_enemy_positions.empty()) {
-        return current_position; // Fallback
-    }
-    
-    game::Position nearest = known_enemy_positions[0];
-    double min_dist = getDistance(current_position, nearest);
-    
-    for (const auto& enemy_pos : known_enemy_positions) {
-        double dist = getDistance(current_position, enemy_pos);
-        if (dist < min_dist) {
-            min_dist = dist;
-            nearest = enemy_pos;
-        }
-    }
-    
-    return nearest;
-}
-
 // Métodos de utilidad
 
 double SimpleAgent::getDistance(const game::Position& a, const game::Position& b) {
-    return std::sqrt(std::pow(a.x - b.x, 2) + std::pow(a.y - b.y, 2));
+    double dx = a.x - b.x;
+    double dy = a.y - b.y;
+    return std::sqrt(dx * dx + dy * dy);
+}
+
+int64_t SimpleAgent::getDistance2(const game::Position& a, const game::Position& b) {
+    // Para comparar distancias no hace falta la raíz
+    int64_t dx = a.x - b.x;
+    int64_t dy = a.y - b.y;
+    return dx * dx + dy * dy;
 }
 
 bool SimpleAgent::isValidPosition(const game::Position& pos, const game::GameState& game_state) {
@@ -206,18 +302,13 @@ bool SimpleAgent::isValidPosition(const game::Position& pos, const game::GameSta
         return false;
     }
     
-    for (const auto& agent : game_state.agents) {
-        if (agent.is_alive && agent.position == pos) {
-            return false;
-        }
-    }
-    
-    return true;
+    // Ocupación en O(1) con la grilla del turno
+    return !turn_grid->occupied(pos);
 }
 
 game::Position SimpleAgent::findOwnBasePosition(const game::GameState& game_state) {
     for (const auto& base : game_state.bases) {
-        if (base.team == team) {
+        if (base.team == std::string_view(team)) {
             return base.position;
         }
     }
@@ -226,7 +317,7 @@ game::Position SimpleAgent::findOwnBasePosition(const game::GameState& game_stat
 
 game::Position SimpleAgent::findEnemyBasePosition(const game::GameState& game_state) {
     for (const auto& base : game_state.bases) {
-        if (base.team != team) {
+        if (base.team != std::string_view(team)) {
             return base.position;
         }
     }
@@ -1,12 +1,22 @@
 #pragma once
 #include "common/game_state.h"
+#include "common/spatial_grid.h"
+#include "common/thread_pool.h"
+#include "pathfinding.h"
+#include "anytime_search.h"
+#include "influence_map.h"
+#include <chrono>
+#include <memory>
 #include <vector>
 #include <string>
 #include <cmath>
+#include <cstdint>
 #include <algorithm>
 
 namespace agent {
 
+class RolloutPlanner;
+
 enum class SimpleActionType {
     move,
     attack, 
@@ -25,6 +35,13 @@ struct SimpleAction {
         : type(t), direction(d), message(msg) {}
 };
 
+// Acción en el formato de turn_response: "move_north", "attack_east", "send_message:..."
+std::string actionToString(const SimpleAction& action);
+// Igual para move/attack/defend, pero sin copiar: apunta a una constante. Vacío para send_message
+std::string_view actionName(const SimpleAction& action);
+// La misma acción para game::resolveTurn; send_message es ActionType::none
+game::Action toGameAction(const SimpleAction& action);
+
 class SimpleAgent {
 private:
      
@@ -45,29 +62,49 @@ private:
     std::string team;
     game::Position current_position;
     int health;
+    size_t self_index = 0; // Posición propia en game_state.agents del último turno
     
     // Memoria simple
-    std::vector<game::Position> known_enemy_positions;
-    std::vector<game::Position> known_ally_positions;
     game::Position last_known_enemy;
+
+    // Índice espacial del turno en curso (válido solo dentro de processTurn)
+    const game::SpatialGrid* turn_grid = nullptr;
+
+    // Caminos hacia las bases y A* hacia enemigos; se puede compartir entre agentes del equipo
+    std::shared_ptr<PathCache> path_cache;
+    // Amenaza y apoyo por celda para escapar con salud baja; también se comparte
+    std::shared_ptr<InfluenceMap> influence;
+    bool shared_influence = false; // Dado con setInfluenceMap: lo actualiza quien lo comparte
+
+    // Búsqueda anytime sobre la acción heurística; con presupuesto 0 no se usa
+    std::chrono::microseconds search_budget{0};
+    int search_depth = AnytimeSearch::MAX_DEPTH;
+    AnytimeSearch search;
+    SearchResult last_search;
+
+    // Simulaciones por acción cuando hay un enemigo cerca; sin planner no se usan
+    std::shared_ptr<const RolloutPlanner> planner;
     
     // Constantes
     const int ATTACK_RANGE = 1;
     const int LOW_HEALTH = 30;
+    const int PATH_SEARCH_LIMIT = 2048; // Nodos que puede expandir A* por turno
+    const double THREAT_WEIGHT = 1.0 / 8; // Un enemigo al lado pesa como 4 pasos de más
+    const int ROLLOUT_RANGE = 3; // Distancia Manhattan de un enemigo para simular
 
     // Métodos privados
     void updateSelfState(const game::GameState& game_state);
-    void updateMemory(const game::GameState& game_state);
     SimpleAction decideSimpleAction(const game::GameState& game_state);
     
     std::pair<bool, game::Position> findAdjacentEnemy();
     SimpleAction handleLowHealth(const game::GameState& game_state);
-    SimpleAction moveTowards(const game::Position& target, const game::GameState& game_state);
+    SimpleAction moveTowards(const game::Position& target, const game::GameState& game_state,
+                             const DistanceField* field = nullptr);
     SimpleAction createAttackAction(const game::Position& enemy_pos);
-    game::Position findNearestEnemy();
     
     // Métodos de utilidad
     double getDistance(const game::Position& a, const game::Position& b);
+    int64_t getDistance2(const game::Position& a, const game::Position& b);
     bool isValidPosition(const game::Position& pos, const game::GameState& game_state);
     game::Position findOwnBasePosition(const game::GameState& game_state);
     game::Position findEnemyBasePosition(const game::GameState& game_state);
@@ -75,9 +112,31 @@ private:
 public:
     SimpleAgent();
     
-    void initialize(const std::string& id, const std::string& team_name);
+    void initialize(std::string_view id, std::string_view team_name);
     SimpleAction processTurn(const game::GameState& game_state);
+    // Igual, pero con una grilla ya construida para este estado (compartida entre agentes)
+    SimpleAction processTurn(const game::GameState& game_state, const game::SpatialGrid& grid);
     void receiveMessage(const std::string& message);
+    void setPathCache(std::shared_ptr<PathCache> cache) { path_cache = std::move(cache); }
+    // El mapa compartido tiene que llegar a processTurn ya actualizado con el
+    // mismo estado: el agente no llama a update() sobre él, porque update()
+    // no es concurrente y los agentes de un host deciden en paralelo
+    void setInfluenceMap(std::shared_ptr<InfluenceMap> map) {
+        influence = std::move(map);
+        shared_influence = true;
+    }
+
+    // Tiempo de processTurn, contado desde que empieza, que puede usar la
+    // búsqueda para mejorar la acción. Se recorta a MAX_SEARCH_BUDGET.
+    static constexpr std::chrono::milliseconds MAX_SEARCH_BUDGET{4000}; // Deja 1 s de los 5 s del pedido
+    void setSearchBudget(std::chrono::microseconds budget, int max_depth = AnytimeSearch::MAX_DEPTH);
+    const SearchResult& lastSearch() const { return last_search; } // De la última decisión con búsqueda
+
+    // Con el enemigo más cercano a ROLLOUT_RANGE pasos o menos, elige con
+    // RolloutPlanner: rollouts_per_action partidas al azar por acción,
+    // repartidas en pool. Con 0 (por defecto) decide solo la heurística. La
+    // búsqueda, si tiene presupuesto, parte de la acción elegida.
+    void setRolloutBudget(int rollouts_per_action, concurrency::ThreadPool& pool, int horizon = 10);
     
     // Getters para testing
     std::string getAgentId() const { return agent_id; }
@@ -0,0 +1,307 @@
+#include "pathfinding.h"
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+namespace agent {
+
+namespace {
+
+// Vecinos en el mismo orden que usa moveTowards: norte, sur, este, oeste
+const int STEP_X[4] = {0, 0, 1, -1};
+const int STEP_Y[4] = {-1, 1, 0, 0};
+const game::Direction STEP_DIR[4] = {
+    game::Direction::NORTH, game::Direction::SOUTH, game::Direction::EAST, game::Direction::WEST
+};
+
+// Auxiliares de A*, marcadas por generación para no limpiarlas en cada
+// búsqueda. Son por hilo para que los agentes de un host busquen en paralelo.
+struct SearchScratch {
+    // (f, h, celda): a igual f se prefiere la celda más cerca del objetivo
+    using Entry = std::tuple<int32_t, int32_t, int32_t>;
+
+    std::vector<Entry> open; // Heap de mínimos de A*, conserva su capacidad entre búsquedas
+    std::vector<uint32_t> visited_generation;
+    std::vector<int32_t> g_score;
+    std::vector<int32_t> came_from;
+    uint32_t generation = 0;
+
+    void fit(size_t cells) {
+        if (visited_generation.size() == cells) return;
+        visited_generation.assign(cells, 0);
+        g_score.assign(cells, 0);
+        came_from.assign(cells, -1);
+        generation = 0;
+    }
+};
+
+thread_local SearchScratch scratch;
+
+} // namespace
+
+// DistanceField
+
+void DistanceField::build(const std::vector<uint16_t>& blocked) {
+    const size_t cells = static_cast<size_t>(std::max(0, width)) * std::max(0, height);
+    dist.assign(cells, UNREACHABLE);
+    parent.assign(cells, -1);
+    if (target.x < 0 || target.y < 0 || target.x >= width || target.y >= height) return;
+
+    dist[targetCell()] = 0;
+    push(targetCell(), 0);
+    propagate(blocked, 0);
+}
+
+void DistanceField::repair(const std::vector<uint16_t>& blocked, const std::vector<int32_t>& newly_blocked,
+                           const std::vector<int32_t>& freed) {
+    if (dist.empty()) return;
+    const int32_t target_cell = targetCell();
+
+    // 1. Lo que colgaba de una celda recién ocupada pierde su distancia, salvo
+    // que tenga otro vecino a la misma distancia del objetivo: en ese caso solo
+    // cambia de padre y su subárbol queda intacto
+    invalid.clear();
+    auto adoptiveParent = [&](int32_t n, int32_t old_parent) {
+        int nx = n % width, ny = n / width;
+        for (int k = 0; k < 4; ++k) {
+            int mx = nx + STEP_X[k], my = ny + STEP_Y[k];
+            if (mx < 0 || my < 0 || mx >= width || my >= height) continue;
+            int32_t m = my * width + mx;
+            if (m == old_parent || (blocked[m] && m != target_cell)) continue;
+            if (dist[m] != UNREACHABLE && dist[m] == dist[n] - 1) return m;
+        }
+        return int32_t(-1);
+    };
+    for (int32_t cell : newly_blocked) {
+        if (cell == target_cell || dist[cell] == UNREACHABLE) continue;
+        size_t first = invalid.size();
+        invalid.push_back(cell);
+        dist[cell] = UNREACHABLE;
+        parent[cell] = -1;
+        for (size_t i = first; i < invalid.size(); ++i) {
+            int32_t u = invalid[i];
+            int ux = u % width, uy = u / width;
+            for (int k = 0; k < 4; ++k) {
+                int nx = ux + STEP_X[k], ny = uy + STEP_Y[k];
+                if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                int32_t n = ny * width + nx;
+                if (parent[n] != u) continue;
+                int32_t adopted = adoptiveParent(n, u);
+                if (adopted >= 0) {
+                    parent[n] = adopted;
+                } else {
+                    dist[n] = UNREACHABLE;
+                    parent[n] = -1;
+                    invalid.push_back(n);
+                }
+            }
+        }
+    }
+
+    // 2. Las celdas invalidadas y las liberadas arrancan desde su mejor vecino válido
+    int32_t first_bucket = UNREACHABLE;
+    auto seed = [&](int32_t cell) {
+        if (blocked[cell] && cell != target_cell) return;
+        int cx = cell % width, cy = cell / width;
+        for (int k = 0; k < 4; ++k) {
+            int nx = cx + STEP_X[k], ny = cy + STEP_Y[k];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            int32_t n = ny * width + nx;
+            if (dist[n] != UNREACHABLE && dist[n] + 1 < dist[cell]) {
+                dist[cell] = dist[n] + 1;
+                parent[cell] = n;
+            }
+        }
+        if (dist[cell] != UNREACHABLE) {
+            push(cell, dist[cell]);
+            first_bucket = std::min(first_bucket, dist[cell]);
+        }
+    };
+    for (int32_t cell : invalid) seed(cell);
+    for (int32_t cell : freed) seed(cell);
+
+    // 3. Propagación con relajación: también baja distancias fuera de la zona
+    // invalidada cuando una celda liberada abre un atajo
+    if (first_bucket != UNREACHABLE) propagate(blocked, first_bucket);
+}
+
+void DistanceField::push(int32_t cell, int32_t distance) {
+    if (static_cast<size_t>(distance) >= buckets.size()) buckets.resize(distance + 1);
+    buckets[distance].push_back(cell);
+}
+
+void DistanceField::propagate(const std::vector<uint16_t>& blocked, int32_t first_bucket) {
+    const int32_t target_cell = targetCell();
+    for (size_t d = first_bucket; d < buckets.size(); ++d) {
+        // push() solo agrega en d + 1, así que buckets[d] no crece mientras se recorre
+        for (size_t i = 0; i < buckets[d].size(); ++i) {
+            int32_t u = buckets[d][i];
+            if (dist[u] != static_cast<int32_t>(d)) continue; // Entrada vieja
+            int ux = u % width, uy = u / width;
+            for (int k = 0; k < 4; ++k) {
+                int nx = ux + STEP_X[k], ny = uy + STEP_Y[k];
+                if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                int32_t n = ny * width + nx;
+                if ((blocked[n] && n != target_cell) || dist[n] <= static_cast<int32_t>(d) + 1) continue;
+                dist[n] = static_cast<int32_t>(d) + 1;
+                parent[n] = u;
+                push(n, dist[n]);
+            }
+        }
+        buckets[d].clear();
+    }
+}
+
+// PathCache
+
+void PathCache::reset(int new_width, int new_height) {
+    width = std::max(0, new_width);
+    height = std::max(0, new_height);
+    const size_t cells = static_cast<size_t>(width) * height;
+    blocked.assign(cells, 0);
+    occupied_cells.clear();
+    fields.clear();
+    turn = -1;
+}
+
+void PathCache::update(const game::GameState& state) {
+    if (state.config.map_width != width || state.config.map_height != height) {
+        reset(state.config.map_width, state.config.map_height);
+    } else if (state.current_turn == turn) {
+        return; // Ya aplicado por otro agente de este proceso
+    }
+    turn = state.current_turn;
+
+    // Diff de ocupación en O(agentes): el bit alto marca "ocupada el turno anterior"
+    constexpr uint16_t WAS_OCCUPIED = 0x8000;
+    constexpr uint16_t COUNT = 0x7FFF;
+    for (int32_t cell : occupied_cells) blocked[cell] = WAS_OCCUPIED;
+
+    std::vector<int32_t>& now_occupied = next_occupied;
+    now_occupied.clear();
+    for (const auto& agent : state.agents) {
+        const game::Position& pos = agent.position;
+        if (!agent.is_alive || pos.x < 0 || pos.y < 0 || pos.x >= width || pos.y >= height) continue;
+        int32_t cell = pos.y * width + pos.x;
+        if ((blocked[cell] & COUNT) == 0) now_occupied.push_back(cell);
+        if ((blocked[cell] & COUNT) < COUNT) blocked[cell]++;
+    }
+
+    newly_blocked.clear();
+    freed.clear();
+    for (int32_t cell : now_occupied) {
+        if (!(blocked[cell] & WAS_OCCUPIED)) newly_blocked.push_back(cell);
+    }
+    for (int32_t cell : occupied_cells) {
+        if ((blocked[cell] & COUNT) == 0) freed.push_back(cell);
+    }
+    for (int32_t cell : occupied_cells) blocked[cell] &= COUNT;
+    occupied_cells.swap(now_occupied);
+
+    if (newly_blocked.empty() && freed.empty()) return;
+    // Si cambió más de 1/16 del mapa, reconstruir sale más barato que reparar
+    bool rebuild = (newly_blocked.size() + freed.size()) * 16 > blocked.size();
+    for (auto& field : fields) {
+        if (rebuild) {
+            field->build(blocked);
+        } else {
+            field->repair(blocked, newly_blocked, freed);
+        }
+    }
+}
+
+const DistanceField& PathCache::field(const game::Position& target) {
+    // Los campos viven en unique_ptr: las referencias devueltas siguen
+    // valiendo aunque otro hilo agregue uno
+    std::lock_guard<std::mutex> lock(fields_mutex);
+    for (const auto& field : fields) {
+        if (field->getTarget() == target) return *field;
+    }
+    fields.push_back(std::make_unique<DistanceField>(target, width, height));
+    fields.back()->build(blocked);
+    return *fields.back();
+}
+
+void PathCache::prepareTurn(const game::GameState& state) {
+    update(state);
+    for (const game::Base& base : state.bases) field(base.position);
+}
+
+bool PathCache::isBlocked(const game::Position& pos) const {
+    if (pos.x < 0 || pos.y < 0 || pos.x >= width || pos.y >= height) return false;
+    return blocked[static_cast<size_t>(pos.y) * width + pos.x] != 0;
+}
+
+bool PathCache::firstStepTowards(const game::Position& from, const game::Position& goal, int max_expansions,
+                                 game::Direction& step) {
+    if (from.x < 0 || from.y < 0 || from.x >= width || from.y >= height) return false;
+    // Heurística consistente: Manhattan hasta una celda vecina del objetivo
+    auto heuristic = [&goal](int x, int y) {
+        return std::max(0, std::abs(goal.x - x) + std::abs(goal.y - y) - 1);
+    };
+    if (heuristic(from.x, from.y) == 0) return false; // Ya está al lado
+
+    scratch.fit(blocked.size());
+    std::vector<uint32_t>& visited_generation = scratch.visited_generation;
+    std::vector<int32_t>& g_score = scratch.g_score;
+    std::vector<int32_t>& came_from = scratch.came_from;
+    if (++scratch.generation == 0) { // Desborde: limpiar las marcas una vez
+        std::fill(visited_generation.begin(), visited_generation.end(), 0);
+        scratch.generation = 1;
+    }
+    const uint32_t generation = scratch.generation;
+
+    // Mismas operaciones que std::priority_queue, sobre un vector reutilizado
+    using Entry = SearchScratch::Entry;
+    std::vector<Entry>& open = scratch.open;
+    const std::greater<Entry> later;
+    auto push = [&open, &later](int32_t f, int32_t h, int32_t cell) {
+        open.emplace_back(f, h, cell);
+        std::push_heap(open.begin(), open.end(), later);
+    };
+    open.clear();
+    const int32_t start = from.y * width + from.x;
+    visited_generation[start] = generation;
+    g_score[start] = 0;
+    came_from[start] = -1;
+    push(heuristic(from.x, from.y), heuristic(from.x, from.y), start);
+
+    int expansions = 0;
+    while (!open.empty() && expansions < max_expansions) {
+        std::pop_heap(open.begin(), open.end(), later);
+        auto [f, h, u] = open.back();
+        open.pop_back();
+        int ux = u % width, uy = u / width;
+        if (f - h > g_score[u]) continue; // Entrada vieja
+        expansions++;
+
+        if (h == 0 && u != start) {
+            // Volver hasta el primer paso desde from
+            while (came_from[u] != start) u = came_from[u];
+            int dx = u % width - from.x, dy = u / width - from.y;
+            for (int k = 0; k < 4; ++k) {
+                if (STEP_X[k] == dx && STEP_Y[k] == dy) step = STEP_DIR[k];
+            }
+            return true;
+        }
+
+        for (int k = 0; k < 4; ++k) {
+            int nx = ux + STEP_X[k], ny = uy + STEP_Y[k];
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            int32_t n = ny * width + nx;
+            if (blocked[n]) continue;
+            int32_t g = g_score[u] + 1;
+            if (visited_generation[n] == generation && g >= g_score[n]) continue;
+            visited_generation[n] = generation;
+            g_score[n] = g;
+            came_from[n] = u;
+            int32_t nh = heuristic(nx, ny);
+            push(g + nh, nh, n);
+        }
+    }
+    return false;
+}
+
+} // namespace agent
@@ -0,0 +1,98 @@
+#pragma once
+#include "common/game_state.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace agent {
+
+// Campo de distancias BFS hacia un objetivo fijo (una base). Las celdas con
+// agentes vivos son obstáculos; la celda objetivo nunca lo es. Se guarda el
+// árbol de caminos (parent) para poder repararlo cuando cambia la ocupación
+// sin recorrer de nuevo todo el mapa.
+class DistanceField {
+public:
+    static constexpr int32_t UNREACHABLE = INT32_MAX;
+
+private:
+    game::Position target;
+    int width = 0;
+    int height = 0;
+    std::vector<int32_t> dist;
+    std::vector<int32_t> parent;              // Celda previa en el camino al objetivo, -1 en el objetivo
+    std::vector<std::vector<int32_t>> buckets; // Cola de Dial indexada por distancia (pesos unitarios)
+    std::vector<int32_t> invalid;             // Auxiliar de repair()
+
+public:
+    DistanceField(const game::Position& target, int width, int height) : target(target), width(width), height(height) {}
+
+    const game::Position& getTarget() const { return target; }
+
+    // Distancia en pasos desde pos hasta el objetivo, UNREACHABLE si no hay camino
+    int32_t distanceFrom(const game::Position& pos) const {
+        if (pos.x < 0 || pos.y < 0 || pos.x >= width || pos.y >= height) return UNREACHABLE;
+        return dist[static_cast<size_t>(pos.y) * width + pos.x];
+    }
+
+    // BFS completo sobre blocked (una entrada por celda, distinto de 0 = ocupada)
+    void build(const std::vector<uint16_t>& blocked);
+
+    // Repara el campo tras un cambio de ocupación: los descendientes de las
+    // celdas que se bloquearon (que no puedan colgarse de otro vecino a la
+    // misma distancia) se invalidan y, junto con las liberadas, se recalculan
+    // desde sus vecinos válidos. El costo es proporcional a la zona afectada y
+    // no al tamaño del mapa.
+    void repair(const std::vector<uint16_t>& blocked, const std::vector<int32_t>& newly_blocked,
+                const std::vector<int32_t>& freed);
+
+private:
+    int32_t targetCell() const { return target.y * width + target.x; }
+    void push(int32_t cell, int32_t distance);
+    void propagate(const std::vector<uint16_t>& blocked, int32_t first_bucket);
+};
+
+// Caché de caminos compartida por todos los agentes de un proceso (en la
+// práctica, de un equipo): un DistanceField por base pedida, actualizado una
+// vez por turno con la ocupación nueva, y A* acotado para objetivos móviles.
+class PathCache {
+private:
+    int width = 0;
+    int height = 0;
+    int turn = -1;
+    std::vector<uint16_t> blocked;        // Agentes vivos por celda
+    std::vector<int32_t> occupied_cells;  // Celdas con blocked > 0, para calcular el diff del turno siguiente
+    std::vector<int32_t> next_occupied;   // Auxiliares de update(), conservan su capacidad entre turnos
+    std::vector<int32_t> newly_blocked;
+    std::vector<int32_t> freed;
+    std::vector<std::unique_ptr<DistanceField>> fields;
+    std::mutex fields_mutex; // field() puede llamarse desde varios hilos
+
+public:
+    // Aplica la ocupación del estado (una sola vez por turno) y repara los campos
+    void update(const game::GameState& state);
+
+    // Campo hacia target, calculado en el primer pedido y reparado en cada update
+    const DistanceField& field(const game::Position& target);
+
+    // update() más los campos de todas las bases del estado. update() no es
+    // concurrente; después de esto varios hilos pueden decidir a la vez con la
+    // misma caché, y field() casi nunca tiene que calcular un campo nuevo.
+    void prepareTurn(const game::GameState& state);
+
+    bool isBlocked(const game::Position& pos) const;
+
+    // Primer paso del camino más corto desde from hasta una celda adyacente a
+    // goal (goal suele estar ocupada por el enemigo). Expande como máximo
+    // max_expansions nodos; devuelve false si no encontró camino. Las
+    // auxiliares de la búsqueda son de cada hilo.
+    bool firstStepTowards(const game::Position& from, const game::Position& goal, int max_expansions,
+                          game::Direction& step);
+
+    size_t fieldCount() const { return fields.size(); }
+
+private:
+    void reset(int new_width, int new_height);
+};
+
+} // namespace agent
@@ -0,0 +1,258 @@
+#include "rollout_planner.h"
+#include "common/game_rules.h"
+#include "common/turn_arena.h"
+#include <algorithm>
+#include <random>
+
+namespace agent {
+
+namespace {
+
+constexpr game::Direction DIRECTIONS[] = {
+    game::Direction::NORTH, game::Direction::SOUTH,
+    game::Direction::EAST, game::Direction::WEST
+};
+
+// Ocupación de una celda vista por la política
+enum Side : uint8_t { EMPTY, OWN, ENEMY };
+
+enum class End { none, win, loss, draw };
+
+// Lo que leen todas las tareas de un evaluate(); nadie lo modifica
+struct Window {
+    game::GameState state;          // Copia compacta, en coordenadas de la ventana
+    size_t self = 0;
+    std::vector<uint8_t> own_agent; // Por agente de state: del equipo propio
+    std::vector<uint8_t> own_base;
+    bool contested = false;         // Empieza con agentes de los dos lados
+    int64_t balance = 0;            // Vida propia menos enemiga al empezar
+};
+
+// Resultado de una tarea. Alineado: dos tareas nunca escriben la misma línea de caché
+struct alignas(64) Partial {
+    uint32_t wins = 0;
+    uint32_t losses = 0;
+    int64_t hp_delta = 0;
+};
+
+// Auxiliares de cada hilo, conservan su capacidad entre simulaciones
+struct Scratch {
+    game::TurnArena arena{16 * 1024}; // La copia de cada simulación, sin pasar por el heap
+    game::TurnArena rules{4 * 1024};  // Auxiliares de resolveTurn, se vacía en cada turno simulado
+    std::vector<game::Action> actions;
+    std::vector<uint8_t> cells;       // Side por celda, agentes y bases en pie
+};
+
+thread_local Scratch scratch;
+
+void buildWindow(const game::GameState& state, size_t self_index, int radius, int horizon, Window& window) {
+    const game::Agent& me = state.agents[self_index];
+    const int x0 = std::max(0, me.position.x - radius);
+    const int y0 = std::max(0, me.position.y - radius);
+    const int x1 = std::min(state.config.map_width - 1, me.position.x + radius);
+    const int y1 = std::min(state.config.map_height - 1, me.position.y + radius);
+    auto inside = [&](const game::Position& pos) { return pos.x >= x0 && pos.y >= y0 && pos.x <= x1 && pos.y <= y1; };
+
+    window.state.config.map_width = x1 - x0 + 1;
+    window.state.config.map_height = y1 - y0 + 1;
+    window.state.config.max_turns = horizon;
+    window.state.current_turn = 0;
+
+    bool own_present = false;
+    bool enemy_present = false;
+    for (size_t i = 0; i < state.agents.size(); ++i) {
+        const game::Agent& agent = state.agents[i];
+        if (!agent.is_alive || !inside(agent.position)) continue;
+        if (i == self_index) window.self = window.state.agents.size();
+        game::Agent& copy = window.state.agents.emplace_back(agent); // En el orden original: decide los empates
+        copy.position = game::Position(agent.position.x - x0, agent.position.y - y0);
+        bool own = agent.team == me.team;
+        window.own_agent.push_back(own);
+        (own ? own_present : enemy_present) = true;
+        window.balance += own ? agent.hp : -agent.hp;
+    }
+    for (const game::Base& base : state.bases) {
+        if (base.is_destroyed || !inside(base.position)) continue;
+        game::Base& copy = window.state.bases.emplace_back(base);
+        copy.position = game::Position(base.position.x - x0, base.position.y - y0);
+        bool own = base.team == me.team;
+        window.own_base.push_back(own);
+        window.balance += own ? base.hp : -base.hp;
+    }
+    window.contested = own_present && enemy_present;
+}
+
+int64_t balance(const Window& window, const game::GameState& sim) {
+    int64_t total = 0;
+    for (size_t i = 0; i < sim.agents.size(); ++i) {
+        if (sim.agents[i].is_alive) total += window.own_agent[i] ? sim.agents[i].hp : -sim.agents[i].hp;
+    }
+    for (size_t b = 0; b < sim.bases.size(); ++b) {
+        if (!sim.bases[b].is_destroyed) total += window.own_base[b] ? sim.bases[b].hp : -sim.bases[b].hp;
+    }
+    return total;
+}
+
+// Las reglas de game::checkGameOver dentro de la ventana
+End outcome(const Window& window, const game::GameState& sim) {
+    bool own_base_lost = false;
+    bool enemy_base_lost = false;
+    for (size_t b = 0; b < sim.bases.size(); ++b) {
+        if (sim.bases[b].is_destroyed) (window.own_base[b] ? own_base_lost : enemy_base_lost) = true;
+    }
+    if (own_base_lost || enemy_base_lost) {
+        if (own_base_lost == enemy_base_lost) return End::draw;
+        return own_base_lost ? End::loss : End::win;
+    }
+
+    int own_hp = 0;
+    int enemy_hp = 0;
+    for (size_t i = 0; i < sim.agents.size(); ++i) {
+        if (sim.agents[i].is_alive) (window.own_agent[i] ? own_hp : enemy_hp) += sim.agents[i].hp;
+    }
+    bool wiped_out = window.contested && (own_hp == 0 || enemy_hp == 0);
+    if (!wiped_out && sim.current_turn < sim.config.max_turns) return End::none;
+    if (own_hp == enemy_hp) return End::draw;
+    return own_hp > enemy_hp ? End::win : End::loss;
+}
+
+game::Action playout(const game::GameState& sim, const Window& window, size_t i,
+                     const std::vector<uint8_t>& cells, std::mt19937& rng) {
+    const game::Position& pos = sim.agents[i].position;
+    const uint8_t enemy = window.own_agent[i] ? ENEMY : OWN;
+    game::Direction targets[4];
+    int target_count = 0;
+    for (game::Direction dir : DIRECTIONS) {
+        game::Position offset = game::getDirectionOffset(dir);
+        int x = pos.x + offset.x;
+        int y = pos.y + offset.y;
+        if (x < 0 || y < 0 || x >= sim.config.map_width || y >= sim.config.map_height) continue;
+        if (cells[static_cast<size_t>(y) * sim.config.map_width + x] == enemy) targets[target_count++] = dir;
+    }
+
+    uint32_t r = rng();
+    if (target_count > 0 && (r & 3) != 0) {
+        return game::Action(game::ActionType::attack, targets[(r >> 2) % target_count]);
+    }
+    uint32_t pick = (r >> 8) % 5;
+    if (pick < 4) return game::Action(game::ActionType::move, DIRECTIONS[pick]);
+    return game::Action(game::ActionType::defend, DIRECTIONS[(r >> 12) & 3]);
+}
+
+// count simulaciones con first como primera acción propia
+void simulate(const Window& window, const game::Action& first, std::seed_seq& seed, int count, Partial& out) {
+    std::mt19937 rng(seed);
+    Scratch& s = scratch;
+    const game::GameState& start = window.state;
+    const size_t cell_count = static_cast<size_t>(start.config.map_width) * start.config.map_height;
+
+    for (int r = 0; r < count; ++r) {
+        s.arena.reset();
+        game::GameState sim(start, s.arena.resource());
+        End end = End::none;
+        while (end == End::none) {
+            s.cells.assign(cell_count, EMPTY);
+            for (size_t i = 0; i < sim.agents.size(); ++i) {
+                const game::Agent& agent = sim.agents[i];
+                if (!agent.is_alive) continue;
+                s.cells[static_cast<size_t>(agent.position.y) * start.config.map_width + agent.position.x] =
+                    window.own_agent[i] ? OWN : ENEMY;
+            }
+            for (size_t b = 0; b < sim.bases.size(); ++b) {
+                const game::Base& base = sim.bases[b];
+                if (base.is_destroyed) continue;
+                s.cells[static_cast<size_t>(base.position.y) * start.config.map_width + base.position.x] =
+                    window.own_base[b] ? OWN : ENEMY;
+            }
+
+            s.actions.assign(sim.agents.size(), game::Action());
+            for (size_t i = 0; i < sim.agents.size(); ++i) {
+                if (!sim.agents[i].is_alive) continue;
+                bool own_first = sim.current_turn == 0 && i == window.self;
+                s.actions[i] = own_first ? first : playout(sim, window, i, s.cells, rng);
+            }
+            s.rules.reset();
+            game::resolveTurn(sim, s.actions, s.rules.resource());
+            sim.current_turn++;
+            end = outcome(window, sim);
+        }
+
+        out.wins += end == End::win;
+        out.losses += end == End::loss;
+        out.hp_delta += balance(window, sim) - window.balance;
+    } // sim se destruye antes del próximo reset()
+}
+
+} // namespace
+
+double RolloutStats::value() const {
+    if (rollouts == 0) return 0;
+    return (static_cast<double>(wins) - losses) / rollouts * RolloutPlanner::WIN_VALUE + meanHpDelta();
+}
+
+RolloutPlanner::RolloutPlanner(concurrency::ThreadPool& pool, const RolloutConfig& config)
+    : pool(pool), config(config) {
+    this->config.rollouts_per_action = std::max(0, config.rollouts_per_action);
+    this->config.horizon = std::max(1, config.horizon);
+    this->config.radius = std::max(1, config.radius);
+}
+
+std::vector<RolloutStats> RolloutPlanner::evaluate(const game::GameState& state, size_t self_index,
+                                                   const std::vector<SimpleAction>& candidates) const {
+    std::vector<RolloutStats> stats(candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) stats[c].action = candidates[c];
+    if (self_index >= state.agents.size() || !state.agents[self_index].is_alive || candidates.empty() ||
+        config.rollouts_per_action == 0) {
+        return stats;
+    }
+
+    Window window;
+    buildWindow(state, self_index, config.radius, config.horizon, window);
+    std::vector<game::Action> first(candidates.size());
+    for (size_t c = 0; c < candidates.size(); ++c) first[c] = toGameAction(candidates[c]);
+
+    const size_t tasks_per_action = (config.rollouts_per_action + CHUNK - 1) / CHUNK;
+    std::vector<Partial> partial(candidates.size() * tasks_per_action);
+    pool.parallelFor(partial.size(), [&](size_t t) {
+        uint32_t candidate = static_cast<uint32_t>(t / tasks_per_action);
+        uint32_t task = static_cast<uint32_t>(t % tasks_per_action);
+        int count = std::min<int>(CHUNK, config.rollouts_per_action - static_cast<int>(task) * CHUNK);
+        std::seed_seq seed{static_cast<uint32_t>(config.seed), static_cast<uint32_t>(config.seed >> 32),
+                           static_cast<uint32_t>(state.current_turn), static_cast<uint32_t>(self_index),
+                           candidate, task};
+        simulate(window, first[candidate], seed, count, partial[t]);
+    });
+
+    for (size_t t = 0; t < partial.size(); ++t) {
+        RolloutStats& into = stats[t / tasks_per_action];
+        into.wins += partial[t].wins;
+        into.losses += partial[t].losses;
+        into.hp_delta += partial[t].hp_delta;
+    }
+    for (RolloutStats& s : stats) s.rollouts = config.rollouts_per_action;
+    return stats;
+}
+
+SimpleAction RolloutPlanner::plan(const game::GameState& state, size_t self_index) const {
+    std::vector<RolloutStats> stats = evaluate(state, self_index, actions());
+    return stats[best(stats)].action;
+}
+
+std::vector<SimpleAction> RolloutPlanner::actions() {
+    std::vector<SimpleAction> all;
+    all.reserve(9);
+    for (game::Direction dir : DIRECTIONS) all.emplace_back(SimpleActionType::move, dir);
+    for (game::Direction dir : DIRECTIONS) all.emplace_back(SimpleActionType::attack, dir);
+    all.emplace_back(SimpleActionType::defend, game::Direction::NORTH);
+    return all;
+}
+
+size_t RolloutPlanner::best(const std::vector<RolloutStats>& stats) {
+    size_t best = 0;
+    for (size_t c = 1; c < stats.size(); ++c) {
+        if (stats[c].value() > stats[best].value()) best = c;
+    }
+    return best;
+}
+
+} // namespace agent
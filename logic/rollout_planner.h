@@ -0,0 +1,74 @@
+#pragma once
+#include "common/game_state.h"
+#include "common/thread_pool.h"
+#include "logic.h"
+#include <cstdint>
+#include <vector>
+
+namespace agent {
+
+// Resultado de las simulaciones de una acción candidata
+struct RolloutStats {
+    SimpleAction action;
+    uint32_t rollouts = 0;
+    uint32_t wins = 0;    // Simulaciones que terminan ganando el equipo propio
+    uint32_t losses = 0;
+    int64_t hp_delta = 0; // Suma de (vida propia ganada - vida enemiga ganada), agentes y bases
+
+    double winRate() const { return rollouts ? static_cast<double>(wins) / rollouts : 0; }
+    double meanHpDelta() const { return rollouts ? static_cast<double>(hp_delta) / rollouts : 0; }
+    double value() const; // Lo que maximiza best(): victorias menos derrotas y, a igualdad, vida
+};
+
+struct RolloutConfig {
+    int rollouts_per_action = 64;
+    int horizon = 10;  // Turnos simulados por partida
+    int radius = 6;    // Ventana de (2 * radius + 1)^2 celdas alrededor del propio
+    uint64_t seed = 1;
+};
+
+// Evalúa acciones candidatas jugando partidas al azar hacia adelante con las
+// reglas de game::resolveTurn. El estado se reduce una vez por llamada a una
+// copia compacta: los agentes vivos y las bases dentro de la ventana, con las
+// coordenadas corridas para que la ventana sea todo el mapa. Cada simulación
+// juega la candidata en el primer turno y después todos (el propio incluido)
+// siguen una política al azar: atacar a un enemigo de al lado tres de cada
+// cuatro veces, si no moverse o defender.
+//
+// La partida simulada termina como en game::checkGameOver, pero mirando solo
+// la ventana: pierde el equipo que se queda sin la base o sin los agentes que
+// tenía al principio y, al agotar el horizonte, gana el que tiene más vida.
+//
+// Las simulaciones se reparten en tareas de CHUNK sobre el pool; cada tarea
+// tiene su propio generador, sembrado con (seed, candidata, tarea), y escribe
+// en su propio casillero, así que no hay estado mutable compartido y el
+// resultado es el mismo con cualquier cantidad de hilos.
+class RolloutPlanner {
+public:
+    static constexpr int CHUNK = 16;          // Simulaciones por tarea
+    static constexpr double WIN_VALUE = 100.0; // Una victoria vale lo mismo que 100 de vida
+
+private:
+    concurrency::ThreadPool& pool;
+    RolloutConfig config;
+
+public:
+    explicit RolloutPlanner(concurrency::ThreadPool& pool, const RolloutConfig& config = {});
+
+    // Simula cada candidata rollouts_per_action veces. self_index es el
+    // propio en state.agents; las estadísticas vuelven en el orden de candidates.
+    // send_message se simula como quedarse quieto.
+    std::vector<RolloutStats> evaluate(const game::GameState& state, size_t self_index,
+                                       const std::vector<SimpleAction>& candidates) const;
+
+    // evaluate() sobre actions() y la de mayor value(); la primera ante un empate
+    SimpleAction plan(const game::GameState& state, size_t self_index) const;
+
+    // Las nueve acciones de un turno: moverse y atacar hacia los cuatro lados, defender
+    static std::vector<SimpleAction> actions();
+    static size_t best(const std::vector<RolloutStats>& stats);
+
+    const RolloutConfig& getConfig() const { return config; }
+};
+
+} // namespace agent
@@ -0,0 +1,44 @@
+#include "common/replay_log.h"
+#include "simulator/replay_engine.h"
+#include <iostream>
+#include <string>
+using namespace std ;
+
+
+int main(int argc, char* argv[]) {
+
+    // Usage: ./replay <log> [from_turn] [to_turn] [threads] [decode_only]
+    if (argc < 2) {
+        cerr << "Usage: ./replay <log> [from_turn] [to_turn] [threads] [decode_only]" << endl;
+        return 1;
+    }
+    replay::ReplayReader log;
+    if (!log.open(argv[1])) {
+        cerr << "Could not open replay log " << argv[1] << endl;
+        return 1;
+    }
+    simulator::ReplayConfig config;
+    if (argc > 2) {
+        config.from_turn = stoi(argv[2]);
+    }
+    if (argc > 3) {
+        config.to_turn = stoi(argv[3]);
+    }
+    if (argc > 4) {
+        config.threads = stoul(argv[4]);
+    }
+    if (argc > 5) {
+        config.decide = stoi(argv[5]) == 0;
+    }
+
+    cout << argv[1] << ": " << log.turnCount() << " turns";
+    if (log.turnCount() > 0) cout << " (" << log.turnAt(0) << ".." << log.turnAt(log.turnCount() - 1) << ")";
+    cout << ", map " << log.config().map_width << "x" << log.config().map_height << ", keyframe every "
+         << log.keyframeInterval() << " turns, " << log.fileSize() << " bytes"
+         << (log.hasIndex() ? "" : ", no index (recorder did not finish), rebuilt") << endl;
+
+    simulator::ReplayEngine engine(log);
+    simulator::ReplayReport report = engine.run(config);
+    report.print(cout);
+    return report.ok ? 0 : 1;
+}
@@ -1,17 +1,47 @@
 #include "common/tcp_connection.h"
 #include "common/rpc_protocol.h"
+#include "common/metrics_exporter.h"
+#include "coordinator/coordinator.h"
 #include <iostream>
+#include <string>
 using namespace std ;
 
 
-int main() {
+int main(int argc, char* argv[]) {
     
     // GLHF
-    net::TcpServer server  ;
-        server.start();
-        std::unique_ptr<net::TcpConnection> connection = server.acceptConnection();
-        cout << connection->receiveMessage() << endl;
-        connection->sendMessage(rpc::void_response("1"));
+    // Usage: ./server [port] [expected_agents] [max_turns] [map_size] [resolve_threads] [replay_log]
+    coordinator::CoordinatorConfig config;
+    if (argc > 1) {
+        config.port = stoi(argv[1]);
+    }
+    if (argc > 2) {
+        config.expected_agents = stoul(argv[2]);
+    }
+    if (argc > 3) {
+        config.game.max_turns = stoi(argv[3]);
+    }
+    if (argc > 4) {
+        config.game.map_width = stoi(argv[4]);
+        config.game.map_height = stoi(argv[4]);
+    }
+    if (argc > 5) {
+        config.resolve_threads = stoul(argv[5]);
+    }
+    if (argc > 6) {
+        config.replay_path = argv[6];
+    }
 
+    metrics::Exporter exporter; // TP4_METRICS_PORT / TP4_METRICS_FILE
+    exporter.configureFromEnvironment();
+
+    coordinator::GameCoordinator game_coordinator(config);
+    if (!game_coordinator.start()) {
+        cerr << "Could not start the coordinator" << endl;
+        return 1;
+    }
+
+    coordinator::MatchReport report = game_coordinator.run();
+    report.print(cout);
     return 0;
-}
\ No newline at end of file
+}
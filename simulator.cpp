@@ -0,0 +1,38 @@
+#include "simulator/match_simulator.h"
+#include <iostream>
+#include <string>
+using namespace std ;
+
+
+int main(int argc, char* argv[]) {
+
+    // Usage: ./simulator [agents] [max_turns] [map_size] [seed] [threads] [drop_rate] [replay_log]
+    simulator::SimulatorConfig config;
+    if (argc > 1) {
+        config.agents = stoul(argv[1]);
+    }
+    if (argc > 2) {
+        config.game.max_turns = stoi(argv[2]);
+    }
+    if (argc > 3) {
+        config.game.map_width = stoi(argv[3]);
+        config.game.map_height = stoi(argv[3]);
+    }
+    if (argc > 4) {
+        config.seed = static_cast<uint32_t>(stoul(argv[4]));
+    }
+    if (argc > 5) {
+        config.threads = stoul(argv[5]);
+    }
+    if (argc > 6) {
+        config.drop_rate = stod(argv[6]);
+    }
+    if (argc > 7) {
+        config.replay_path = argv[7];
+    }
+
+    simulator::MatchSimulator match(config);
+    simulator::SimulationReport report = match.run();
+    report.print(cout);
+    return 0;
+}
@@ -0,0 +1,152 @@
+// simulator/match_simulator.cpp
+// Implements the headless match simulator
+#include "match_simulator.h"
+#include "common/binary_codec.h"
+#include "common/replay_log.h"
+#include "common/spatial_grid.h"
+#include "common/thread_pool.h"
+#include "logic/logic.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <numeric>
+#include <ostream>
+
+namespace simulator {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double percentile(std::vector<double> values, double p) {
+    if (values.empty()) return 0.0;
+    std::sort(values.begin(), values.end());
+    size_t index = static_cast<size_t>(p * (values.size() - 1));
+    return values[index];
+}
+
+} // namespace
+
+void SimulationReport::print(std::ostream& out) const {
+    out << "Simulated " << turns << " turns with " << agents << " agents, winner: "
+        << (winner.empty() ? "draw" : winner) << ", final state checksum " << std::hex << checksum << std::dec
+        << std::endl;
+    out << decisions << " decisions in " << seconds << " s: " << turnsPerSecond() << " turns/s, "
+        << decisionsPerSecond() << " decisions/s" << std::endl;
+    if (latency_us.empty()) return;
+    double mean = std::accumulate(latency_us.begin(), latency_us.end(), 0.0) / latency_us.size();
+    out << "Decision latency: mean " << mean << " us, p50 " << percentile(latency_us, 0.50) << " us, p90 "
+        << percentile(latency_us, 0.90) << " us, p99 " << percentile(latency_us, 0.99) << " us, max "
+        << percentile(latency_us, 1.0) << " us" << std::endl;
+}
+
+MatchSimulator::MatchSimulator(const SimulatorConfig& config) : config(config), rng(config.seed) {
+    state.config = config.game;
+    // Two teams, bases in opposite corners, as in the coordinator
+    state.bases.emplace_back("red", game::Position(2, 2));
+    state.bases.emplace_back("blue", game::Position(config.game.map_width - 3, config.game.map_height - 3));
+    spawnAgents();
+}
+
+void MatchSimulator::spawnAgents() {
+    const int width = state.config.map_width;
+    const int height = state.config.map_height;
+    std::vector<bool> taken(static_cast<size_t>(std::max(0, width)) * std::max(0, height), false);
+    for (const game::Base& base : state.bases) {
+        if (base.position.x >= 0 && base.position.y >= 0 && base.position.x < width && base.position.y < height) {
+            taken[static_cast<size_t>(base.position.y) * width + base.position.x] = true;
+        }
+    }
+
+    // Random free cell near the own base; the square grows with the team size
+    const int radius = 1 + static_cast<int>(std::ceil(std::sqrt(static_cast<double>(config.agents))));
+    for (size_t i = 0; i < config.agents; ++i) {
+        const game::Base& base = state.bases[i % state.bases.size()];
+        std::string id = std::string(base.team) + "_agent_" + std::to_string(i);
+        game::Agent agent(id, base.team, game::Position(0, 0), game::SPAWN_HP);
+
+        bool placed = false;
+        for (int r = radius; !placed && r <= std::max(width, height); r *= 2) {
+            std::uniform_int_distribution<int> offset(-r, r);
+            for (int attempt = 0; attempt < 64 && !placed; ++attempt) {
+                game::Position pos(base.position.x + offset(rng), base.position.y + offset(rng));
+                if (pos.x < 0 || pos.y < 0 || pos.x >= width || pos.y >= height) continue;
+                size_t cell = static_cast<size_t>(pos.y) * width + pos.x;
+                if (taken[cell]) continue;
+                taken[cell] = true;
+                agent.position = pos;
+                placed = true;
+            }
+        }
+        if (!placed) agent.is_alive = false; // The map is full
+        state.agents.push_back(agent);
+    }
+}
+
+SimulationReport MatchSimulator::run() {
+    SimulationReport report;
+    report.agents = state.agents.size();
+
+    auto path_cache = std::make_shared<agent::PathCache>();
+    auto influence = std::make_shared<agent::InfluenceMap>();
+    std::vector<agent::SimpleAgent> brains(state.agents.size());
+    for (size_t i = 0; i < brains.size(); ++i) {
+        brains[i].initialize(state.agents[i].id, state.agents[i].team);
+        brains[i].setPathCache(path_cache);
+        brains[i].setInfluenceMap(influence);
+    }
+
+    concurrency::ThreadPool pool(config.threads > 1 ? config.threads - 1 : 0);
+    game::SpatialGrid grid;
+    std::vector<game::Action> actions;
+    std::vector<size_t> deciding;
+    std::vector<double> turn_latency;
+    std::bernoulli_distribution dropped(std::clamp(config.drop_rate, 0.0, 1.0));
+    replay::ReplayWriter recorder;
+    if (!config.replay_path.empty()) recorder.open(config.replay_path, state.config);
+
+    Clock::time_point start = Clock::now();
+    while (!state.game_over && state.current_turn < state.config.max_turns) {
+        state.current_turn++;
+        report.turns++;
+
+        // Drops are drawn before deciding so the RNG sequence does not depend on threads
+        deciding.clear();
+        for (size_t i = 0; i < state.agents.size(); ++i) {
+            if (state.agents[i].is_alive && !dropped(rng)) deciding.push_back(i);
+        }
+
+        grid.build(state);
+        path_cache->prepareTurn(state);
+        influence->update(state);
+        actions.assign(state.agents.size(), game::Action());
+        turn_latency.assign(deciding.size(), 0.0);
+        pool.parallelFor(deciding.size(), [&](size_t k) {
+            size_t i = deciding[k];
+            Clock::time_point begin = Clock::now();
+            agent::SimpleAction action = brains[i].processTurn(state, grid);
+            // Same text round trip as over the wire
+            actions[i] = game::parseAction(agent::actionToString(action));
+            turn_latency[k] = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+        });
+        report.decisions += deciding.size();
+        report.latency_us.insert(report.latency_us.end(), turn_latency.begin(), turn_latency.end());
+        if (recorder.isOpen()) recorder.recordTurn(state, actions);
+
+        if (pool.size() > 0) {
+            game::resolveTurn(state, actions, pool);
+        } else {
+            game::resolveTurn(state, actions);
+        }
+        game::checkGameOver(state);
+    }
+    report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    game::checkGameOver(state);
+    report.winner = state.winner;
+    report.checksum = rpc::checksumGameState(state);
+    return report;
+}
+
+} // namespace simulator
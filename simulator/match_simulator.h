@@ -0,0 +1,60 @@
+// simulator/match_simulator.h
+// Declares the headless match simulator: SimpleAgents against the game rules, no sockets
+#pragma once
+#include "common/game_rules.h"
+#include "common/game_state.h"
+#include <cstdint>
+#include <iosfwd>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace simulator {
+
+struct SimulatorConfig {
+    size_t agents = 8;         // Split red/blue by index, as the coordinator does
+    game::GameConfig game;
+    uint32_t seed = 1;         // Spawn positions and dropped answers
+    double drop_rate = 0.0;    // Share of decisions replaced by no answer, like a timed out agent
+    size_t threads = 1;        // Threads deciding and resolving each turn; the result does not depend on it
+    std::string replay_path;   // Non-empty: record the match there, see common/replay_log.h
+};
+
+struct SimulationReport {
+    int turns = 0;
+    size_t agents = 0;
+    size_t decisions = 0;
+    std::string winner;
+    double seconds = 0;              // Wall time of the turn loop
+    std::vector<double> latency_us;  // One entry per decision
+    uint64_t checksum = 0;           // Of the final state: equal runs give equal checksums
+
+    double turnsPerSecond() const { return seconds > 0 ? turns / seconds : 0; }
+    double decisionsPerSecond() const { return seconds > 0 ? decisions / seconds : 0; }
+    void print(std::ostream& out) const;
+};
+
+// Owns a GameState and drives one agent::SimpleAgent per agent through
+// processTurn until the game ends or max_turns. Every turn the agents share
+// one SpatialGrid and one PathCache, as in agent_host, and their actions go
+// through game::resolveTurn exactly as the coordinator applies them (the
+// tiled version when there are several threads). With the
+// same config the match is the same, turn by turn.
+class MatchSimulator {
+private:
+    SimulatorConfig config;
+    game::GameState state;
+    std::mt19937 rng;
+
+public:
+    explicit MatchSimulator(const SimulatorConfig& config);
+
+    const game::GameState& getState() const { return state; }
+
+    SimulationReport run();
+
+private:
+    void spawnAgents();
+};
+
+} // namespace simulator
@@ -0,0 +1,107 @@
+// simulator/replay_engine.cpp
+// Implements the offline replay of a recorded match
+#include "replay_engine.h"
+#include "common/binary_codec.h"
+#include "common/spatial_grid.h"
+#include "common/thread_pool.h"
+#include "logic/logic.h"
+#include <chrono>
+#include <memory>
+#include <ostream>
+
+namespace simulator {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+} // namespace
+
+void ReplayReport::print(std::ostream& out) const {
+    out << "Replayed " << turns << " turns, " << bytes << " bytes of log" << (ok ? "" : " (log corrupt, stopped)")
+        << ", final state checksum " << std::hex << checksum << std::dec << std::endl;
+    out << "Seek " << seek_us << " us, decode " << decode_seconds << " s ("
+        << (decode_seconds > 0 ? bytes / decode_seconds / 1e6 : 0) << " MB/s, "
+        << (decode_seconds > 0 ? turns / decode_seconds : 0) << " turns/s)" << std::endl;
+    if (decisions == 0) return;
+    out << decisions << " decisions in " << decide_seconds << " s: " << decisions / decide_seconds
+        << " decisions/s, " << mismatches << " of " << compared << " differ from the recorded actions" << std::endl;
+}
+
+ReplayReport ReplayEngine::run(const ReplayConfig& config) {
+    ReplayReport report;
+    if (log.turnCount() == 0) return report;
+
+    size_t first = config.from_turn > 0 ? log.entryOf(config.from_turn) : 0;
+    size_t last = config.to_turn > 0 ? log.entryOf(config.to_turn) : log.turnCount() - 1;
+    if (first >= log.turnCount() || last >= log.turnCount() || first > last) {
+        report.ok = false;
+        return report;
+    }
+    log.adviseSequential();
+
+    game::GameState state;
+    Clock::time_point start = Clock::now();
+    report.ok = log.stateAt(first, state);
+    report.seek_us = std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    if (!report.ok) return report;
+
+    auto path_cache = std::make_shared<agent::PathCache>();
+    auto influence = std::make_shared<agent::InfluenceMap>();
+    std::vector<agent::SimpleAgent> brains(config.decide ? state.agents.size() : 0);
+    for (size_t i = 0; i < brains.size(); ++i) {
+        brains[i].initialize(state.agents[i].id, state.agents[i].team);
+        brains[i].setPathCache(path_cache);
+        brains[i].setInfluenceMap(influence);
+    }
+
+    concurrency::ThreadPool pool(config.threads > 1 ? config.threads - 1 : 0);
+    game::SpatialGrid grid;
+    std::vector<game::Action> recorded;
+    std::vector<game::Action> decided;
+    std::vector<size_t> deciding;
+    for (size_t entry = first; entry <= last; ++entry) {
+        if (entry > first) {
+            Clock::time_point decode_start = Clock::now();
+            report.ok = log.advance(entry, state);
+            report.decode_seconds += secondsSince(decode_start);
+            if (!report.ok) break;
+        }
+        report.turns++;
+        if (!config.decide) continue;
+
+        Clock::time_point decide_start = Clock::now();
+        log.actionsAt(entry, recorded);
+        deciding.clear();
+        for (size_t i = 0; i < state.agents.size() && i < brains.size(); ++i) {
+            if (state.agents[i].is_alive) deciding.push_back(i);
+        }
+        grid.build(state);
+        path_cache->prepareTurn(state);
+        influence->update(state);
+        decided.assign(state.agents.size(), game::Action());
+        pool.parallelFor(deciding.size(), [&](size_t k) {
+            size_t i = deciding[k];
+            decided[i] = game::parseAction(agent::actionToString(brains[i].processTurn(state, grid)));
+        });
+        report.decide_seconds += secondsSince(decide_start);
+        report.decisions += deciding.size();
+
+        for (size_t i : deciding) {
+            if (i >= recorded.size() || recorded[i].type == game::ActionType::none) continue; // No answer was recorded
+            report.compared++;
+            if (recorded[i].type != decided[i].type || recorded[i].direction != decided[i].direction) {
+                report.mismatches++;
+            }
+        }
+    }
+    report.bytes = log.recordBytes(first + 1, first + report.turns);
+    report.checksum = rpc::checksumGameState(state);
+    return report;
+}
+
+} // namespace simulator
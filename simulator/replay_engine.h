@@ -0,0 +1,47 @@
+// simulator/replay_engine.h
+// Declares the offline replay of a recorded match through SimpleAgents
+#pragma once
+#include "common/replay_log.h"
+#include <cstdint>
+#include <iosfwd>
+
+namespace simulator {
+
+struct ReplayConfig {
+    int from_turn = 0;   // 0: the first recorded turn
+    int to_turn = 0;     // 0: the last recorded turn
+    size_t threads = 1;  // Threads deciding each turn
+    bool decide = true;  // false: only rebuild the states, to time the log itself
+};
+
+struct ReplayReport {
+    size_t turns = 0;
+    size_t decisions = 0;
+    size_t compared = 0;   // Decisions with a recorded answer to compare against
+    size_t mismatches = 0; // Of those, the ones where the agent now answers differently
+    uint64_t bytes = 0;    // Log records decoded after the seek
+    double seek_us = 0;    // Index lookup and keyframe + deltas up to from_turn
+    double decode_seconds = 0;
+    double decide_seconds = 0;
+    uint64_t checksum = 0; // Of the last replayed state
+    bool ok = true;        // Every state decoded and passed its delta checksum
+
+    void print(std::ostream& out) const;
+};
+
+// Walks a ReplayReader's turns in order, rebuilding each state from the
+// mapped log and, like MatchSimulator, having one SimpleAgent per agent
+// decide on it with a shared SpatialGrid and PathCache. The decisions are
+// compared with the recorded actions, so a log taken from the simulator
+// replays with no mismatch from its first turn.
+class ReplayEngine {
+private:
+    const replay::ReplayReader& log;
+
+public:
+    explicit ReplayEngine(const replay::ReplayReader& log) : log(log) {}
+
+    ReplayReport run(const ReplayConfig& config);
+};
+
+} // namespace simulator